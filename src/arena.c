@@ -0,0 +1,116 @@
+#include "arena.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_MIN_BLOCK_SIZE (64 * 1024)
+
+//blocks are kept in a list and reused in order after a reset
+struct ArenaBlock {
+	struct ArenaBlock* next;
+	size_t size; //usable bytes after the header
+	size_t used;
+};
+
+struct Arena {
+	struct ArenaBlock* first;
+	struct ArenaBlock* current;
+	size_t allocatedBytes;
+};
+
+static struct Arena arenas[ARENA_PHASE_COUNT];
+
+static size_t totalAllocatedBytes = 0;
+static size_t peakAllocatedBytes = 0;
+static size_t blockAllocationCount = 0;
+
+//header is padded so block data stays aligned
+#define ARENA_BLOCK_HEADER_SIZE ((sizeof(struct ArenaBlock) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+static inline char* arenaBlockData(struct ArenaBlock* block) {
+	return (char*)block + ARENA_BLOCK_HEADER_SIZE;
+}
+
+struct ArenaBlock* allocArenaBlock(size_t minSize) {
+	size_t size = minSize > ARENA_MIN_BLOCK_SIZE ? minSize : ARENA_MIN_BLOCK_SIZE;
+
+	struct ArenaBlock* block = malloc(ARENA_BLOCK_HEADER_SIZE + size);
+	if (block == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for arena!\n");
+		exit(1);
+	}
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+
+	++blockAllocationCount;
+	return block;
+}
+
+void* arenaAlloc(enum ArenaPhase phase, size_t size) {
+	struct Arena* arena = &arenas[phase];
+	size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+	//move through blocks kept from before a reset until one fits, append a new one if none do
+	if (arena->current == NULL) {
+		if (arena->first == NULL) {
+			arena->first = allocArenaBlock(size);
+		}
+		arena->current = arena->first;
+	}
+	while (arena->current->used + size > arena->current->size) {
+		if (arena->current->next == NULL) {
+			arena->current->next = allocArenaBlock(size);
+		}
+		arena->current = arena->current->next;
+	}
+
+	void* ptr = arenaBlockData(arena->current) + arena->current->used;
+	arena->current->used += size;
+
+	arena->allocatedBytes += size;
+	totalAllocatedBytes += size;
+	if (totalAllocatedBytes > peakAllocatedBytes) {
+		peakAllocatedBytes = totalAllocatedBytes;
+	}
+
+	return ptr;
+}
+
+void resetArena(enum ArenaPhase phase) {
+	struct Arena* arena = &arenas[phase];
+
+	for (struct ArenaBlock* block = arena->first; block != NULL; block = block->next) {
+		block->used = 0;
+	}
+	arena->current = arena->first;
+
+	totalAllocatedBytes -= arena->allocatedBytes;
+	arena->allocatedBytes = 0;
+}
+
+void freeArenas() {
+	for (size_t i = 0; i < ARENA_PHASE_COUNT; ++i) {
+		resetArena(i);
+
+		struct ArenaBlock* block = arenas[i].first;
+		while (block != NULL) {
+			struct ArenaBlock* next = block->next;
+			free(block);
+			block = next;
+		}
+		arenas[i].first = NULL;
+		arenas[i].current = NULL;
+	}
+}
+
+size_t arenaPeakBytes() {
+	return peakAllocatedBytes;
+}
+
+size_t arenaBlockAllocations() {
+	return blockAllocationCount;
+}
\ No newline at end of file
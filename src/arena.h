@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+
+//bump pointer arenas for data that lives until the end of a compilation phase
+//each phase has its own arena which is reset as a whole instead of freeing individual allocations
+enum ArenaPhase {
+	ARENA_PARSE, //lives until parsing is finished, e.g. literal temps
+	ARENA_BYTECODE, //lives until the bytecode is finalised, e.g. interned identifiers
+	ARENA_CODEGEN, //lives until code generation is finished
+
+	ARENA_PHASE_COUNT,
+};
+
+//memory is 16 byte aligned and not zeroed, never returns NULL
+void* arenaAlloc(enum ArenaPhase phase, size_t size);
+
+//everything allocated in the phase becomes invalid, the memory is kept for reuse
+void resetArena(enum ArenaPhase phase);
+//releases the memory of every arena
+void freeArenas();
+
+//the most bytes that have been allocated from all arenas at once
+size_t arenaPeakBytes();
+//number of blocks requested from the system allocator
+size_t arenaBlockAllocations();
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "asm_writer.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ASM_BUFFER_SIZE (64 * 1024)
+
+static FILE* asmFile = NULL;
+static char asmBuffer[ASM_BUFFER_SIZE];
+static size_t asmLength = 0;
+
+void flushAsmBuffer() {
+	if (asmLength != 0 && fwrite(asmBuffer, 1, asmLength, asmFile) != asmLength) {
+		fprintf(stderr, "ERROR: Could not write assembly output!\n");
+		exit(1);
+	}
+	asmLength = 0;
+}
+
+void beginAsmOutput(FILE* file) {
+	asmFile = file;
+	asmLength = 0;
+}
+
+void finishAsmOutput() {
+	flushAsmBuffer();
+	if (fflush(asmFile) != 0) {
+		fprintf(stderr, "ERROR: Could not write assembly output!\n");
+		exit(1);
+	}
+	asmFile = NULL;
+}
+
+void emitAsmBytes(const char* text, size_t length) {
+	if (length > ASM_BUFFER_SIZE - asmLength) {
+		flushAsmBuffer();
+		//too big to be worth buffering
+		if (length > ASM_BUFFER_SIZE) {
+			if (fwrite(text, 1, length, asmFile) != length) {
+				fprintf(stderr, "ERROR: Could not write assembly output!\n");
+				exit(1);
+			}
+			return;
+		}
+	}
+	memcpy(asmBuffer + asmLength, text, length);
+	asmLength += length;
+}
+
+void emitAsm(const char* text) {
+	emitAsmBytes(text, strlen(text));
+}
+
+void emitAsmChar(char c) {
+	if (asmLength == ASM_BUFFER_SIZE) {
+		flushAsmBuffer();
+	}
+	asmBuffer[asmLength] = c;
+	++asmLength;
+}
+
+void emitAsmUInt(uint64_t value) {
+	//digits are written backwards from the end, 20 is enough for UINT64_MAX
+	char digits[20];
+	size_t start = sizeof(digits);
+	do {
+		--start;
+		digits[start] = '0' + value % 10;
+		value /= 10;
+	} while (value != 0);
+	emitAsmBytes(digits + start, sizeof(digits) - start);
+}
+
+void emitAsmInt(int64_t value) {
+	if (value < 0) {
+		emitAsmChar('-');
+		//negated as unsigned so INT64_MIN doesnt overflow
+		emitAsmUInt(-(uint64_t)value);
+	} else {
+		emitAsmUInt(value);
+	}
+}
+
+//nasm strings have no escapes inside double quotes, so the quote itself is emitted as a number
+static inline bool isQuotable(uint8_t byte) {
+	return byte >= ' ' && byte <= '~' && byte != '"';
+}
+
+void emitAsmData(const uint8_t* data, size_t length) {
+	size_t i = 0;
+	while (i < length) {
+		if (i != 0) {
+			emitAsmChar(',');
+		}
+
+		if (!isQuotable(data[i])) {
+			emitAsmUInt(data[i]);
+			++i;
+			continue;
+		}
+
+		size_t runEnd = i + 1;
+		while (runEnd < length && isQuotable(data[runEnd])) {
+			++runEnd;
+		}
+		emitAsmChar('"');
+		emitAsmBytes((const char*)data + i, runEnd - i);
+		emitAsmChar('"');
+		i = runEnd;
+	}
+}
\ No newline at end of file
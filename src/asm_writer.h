@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//buffered assembly text output, the file is only ever written forwards so it can be a pipe
+//nothing is formatted through printf, integers and data are converted by hand
+
+void beginAsmOutput(FILE* file);
+//flushes whatever is still buffered, exits if the file could not be written to
+void finishAsmOutput();
+
+void emitAsmBytes(const char* text, size_t length);
+void emitAsm(const char* text); //null terminated
+void emitAsmChar(char c);
+void emitAsmUInt(uint64_t value);
+void emitAsmInt(int64_t value);
+
+//operands of a db directive, printable runs become quoted strings and everything else decimal bytes
+//e.g. "Hello world!",10
+void emitAsmData(const uint8_t* data, size_t length);
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 struct ByteArray allocByteArray(size_t length) {
@@ -65,4 +66,79 @@ struct ByteArray combineByteArrays(struct ByteArray first, struct ByteArray seco
 	memcpy(merged.ptr + first.length, second.ptr, second.length);
 
 	return merged;
+}
+
+struct ByteBuffer allocByteBuffer(size_t capacity) {
+	struct ByteBuffer buffer = {NULL, 0, 0};
+	reserveByteBuffer(&buffer, capacity);
+	return buffer;
+}
+
+void freeByteBuffer(struct ByteBuffer* buffer) {
+	free(buffer->ptr);
+	buffer->ptr = NULL;
+	buffer->length = 0;
+	buffer->capacity = 0;
+}
+
+void reserveByteBuffer(struct ByteBuffer* buffer, size_t minCapacity) {
+	if (minCapacity <= buffer->capacity) {
+		return;
+	}
+
+	size_t newCapacity = buffer->capacity == 0 ? 64 : buffer->capacity;
+	while (newCapacity < minCapacity) {
+		newCapacity *= 2;
+	}
+
+	char* grown = realloc(buffer->ptr, newCapacity);
+	if (grown == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for byte buffer!\n");
+		exit(1);
+	}
+	buffer->ptr = grown;
+	buffer->capacity = newCapacity;
+}
+
+void appendBytes(struct ByteBuffer* buffer, const void* data, size_t length) {
+	reserveByteBuffer(buffer, buffer->length + length);
+	memcpy(buffer->ptr + buffer->length, data, length);
+	buffer->length += length;
+}
+
+void appendZeroes(struct ByteBuffer* buffer, size_t length) {
+	reserveByteBuffer(buffer, buffer->length + length);
+	memset(buffer->ptr + buffer->length, 0, length);
+	buffer->length += length;
+}
+
+void appendUInt(struct ByteBuffer* buffer, uint64_t value, size_t byteCount) {
+	reserveByteBuffer(buffer, buffer->length + byteCount);
+	for (size_t i = 0; i < byteCount; ++i) {
+		buffer->ptr[buffer->length + i] = (char)(value >> (i * 8));
+	}
+	buffer->length += byteCount;
+}
+
+void patchUInt(struct ByteBuffer* buffer, size_t index, uint64_t value, size_t byteCount) {
+	if (index + byteCount > buffer->length || index + byteCount < index) {
+		fprintf(stderr, "ERROR: Attempted to patch outside of byte buffer!\n");
+		exit(1);
+	}
+
+	for (size_t i = 0; i < byteCount; ++i) {
+		buffer->ptr[index + i] = (char)(value >> (i * 8));
+	}
+}
+
+struct ByteArray byteBufferToArray(struct ByteBuffer* buffer) {
+	struct ByteArray byteArray;
+	byteArray.ptr = buffer->ptr;
+	byteArray.length = buffer->length;
+
+	buffer->ptr = NULL;
+	buffer->length = 0;
+	buffer->capacity = 0;
+
+	return byteArray;
 }
\ No newline at end of file
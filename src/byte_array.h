@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 //reccomend to only have one copy of a byte array at a time
 struct ByteArray {
@@ -15,4 +16,45 @@ void freeByteArray(struct ByteArray* byteArray); //nulls the pointer and zeroes
 void resizeByteArray(struct ByteArray* byteArray, size_t newLength);
 
 //does not free the original arrays
-struct ByteArray combineByteArrays(struct ByteArray first, struct ByteArray second);
\ No newline at end of file
+struct ByteArray combineByteArrays(struct ByteArray first, struct ByteArray second);
+
+//growable byte buffer, appends are amortised O(1) since the capacity doubles when full
+//values are appended and patched little endian, as the bytecode format requires
+struct ByteBuffer {
+	char* ptr;
+	size_t length;
+	size_t capacity;
+};
+
+struct ByteBuffer allocByteBuffer(size_t capacity);
+void freeByteBuffer(struct ByteBuffer* buffer); //nulls the pointer and zeroes the length and capacity
+
+//grows the capacity to at least minCapacity
+void reserveByteBuffer(struct ByteBuffer* buffer, size_t minCapacity);
+
+void appendBytes(struct ByteBuffer* buffer, const void* data, size_t length);
+void appendZeroes(struct ByteBuffer* buffer, size_t length);
+//appends the lowest byteCount bytes of value
+void appendUInt(struct ByteBuffer* buffer, uint64_t value, size_t byteCount);
+
+static inline void appendU8(struct ByteBuffer* buffer, uint8_t value) {
+	if (buffer->length == buffer->capacity) {
+		reserveByteBuffer(buffer, buffer->length + 1);
+	}
+	buffer->ptr[buffer->length] = value;
+	++buffer->length;
+}
+
+static inline void appendU32(struct ByteBuffer* buffer, uint32_t value) {
+	appendUInt(buffer, value, 4);
+}
+
+static inline void appendU64(struct ByteBuffer* buffer, uint64_t value) {
+	appendUInt(buffer, value, 8);
+}
+
+//overwrites already appended bytes, exits if out of bounds
+void patchUInt(struct ByteBuffer* buffer, size_t index, uint64_t value, size_t byteCount);
+
+//the byte array takes ownership of the data, the buffer is left empty
+struct ByteArray byteBufferToArray(struct ByteBuffer* buffer);
\ No newline at end of file
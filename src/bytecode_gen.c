@@ -7,125 +7,129 @@
 #include <string.h>
 
 #include "byte_array.h"
-#include "token.h"
-
-static FILE* srcPtr = NULL;
+#include "symbol_table.h"
 
 //bytecode sections
 //header
 static char staticHeaderData[] = {
 	0x78, 0x70, 0x62, 0xC0, //magic number
 	0x00, 0x00, 0x00, 0x00, //version major
-	0x01, 0x00, 0x00, 0x00, //version minor
+	0x02, 0x00, 0x00, 0x00, //version minor
 	0x00, 0x00, 0x00, 0x00, //version patch
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //flags, to be filled in at finalisation
 	//section table, to be filled in at finalisation
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //Function table
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //Static variables
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //Function index
 	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //Program logic
 
 };
 static struct ByteArray staticHeader = {staticHeaderData, sizeof(staticHeaderData)}; //should never be freed (its static so duh)
 
-static struct ByteArray functionTable = {NULL, 0};
 //data
-static struct ByteArray staticVariables = {NULL, 0};
-static struct ByteArray programLogic = {NULL, 0};
+static struct ByteBuffer staticVariables = {NULL, 0, 0};
+static struct ByteBuffer programLogic = {NULL, 0, 0};
 
+//function table, serialised at finalisation
+//functions in order of appending, and a symbol indexed map to their position
+static uint32_t* functionSymbols = NULL;
+static uint32_t* functionIDs = NULL;
 static uint32_t functionCount = 0;
+static uint32_t functionCapacity = 0;
 
-static uint32_t nextStaticID = (uint32_t)-1;
-
-static uint32_t currentFunctionIndex = 0;
-static uint32_t currentBlockIndex = 0;
+static uint32_t* functionBySymbol = NULL; //UINT32_MAX if the symbol isnt a function
+static uint32_t functionBySymbolLength = 0;
 
+//function index, where each definition is in the program logic, serialised at finalisation
+static uint32_t* indexedFunctionIDs = NULL;
+static uint64_t* indexedFunctionOffsets = NULL; //from the start of the program logic
+static uint64_t* indexedFunctionLengths = NULL;
+static uint32_t indexedFunctionCount = 0;
+static uint32_t indexedFunctionCapacity = 0;
 
+static uint32_t nextStaticID = (uint32_t)-1;
 
-//intended primarily for specification functions
-void appendToFunctionTableDirect(const char* identifier, size_t ID) {
-	size_t identifierLength = strlen(identifier);
+static size_t currentFunctionIndex = 0;
+static size_t currentBlockIndex = 0;
 
-	//create new function
-	size_t newFunctionLength = identifierLength + 12; //8 bytes for identifier length, 4 for ID
-	struct ByteArray newFunction = allocByteArray(newFunctionLength);
 
-	//fill data
-	//potential errors here if size_t is less than 64 bits
-	memcpy(newFunction.ptr, &ID, 4); //function id
-	memcpy(newFunction.ptr + 4, &identifierLength, 8); //length of identifier
-	memcpy(newFunction.ptr + 12, identifier, identifierLength); //identifier
 
-	//make new table
-	struct ByteArray newTable = combineByteArrays(functionTable, newFunction);
+//intended primarily for specification functions
+void appendToFunctionTableDirect(const char* identifier, uint32_t ID) {
+	appendToFunctionTable(identifier, strlen(identifier), ID);
+}
 
-	//free old data
-	freeByteArray(&functionTable);
-	freeByteArray(&newFunction);
+void appendToFunctionTable(const char* identifier, size_t identifierLength, uint32_t ID) {
+	uint32_t symbol = internSymbol(identifier, identifierLength);
+
+	//grow arrays
+	if (functionCount == functionCapacity) {
+		functionCapacity = functionCapacity == 0 ? 16 : functionCapacity * 2;
+		functionSymbols = realloc(functionSymbols, functionCapacity * sizeof(uint32_t));
+		functionIDs = realloc(functionIDs, functionCapacity * sizeof(uint32_t));
+		if (functionSymbols == NULL || functionIDs == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for function table!\n");
+			exit(1);
+		}
+	}
+	if (symbol >= functionBySymbolLength) {
+		uint32_t newLength = functionBySymbolLength == 0 ? 64 : functionBySymbolLength;
+		while (symbol >= newLength) {
+			newLength *= 2;
+		}
+		functionBySymbol = realloc(functionBySymbol, newLength * sizeof(uint32_t));
+		if (functionBySymbol == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for function table!\n");
+			exit(1);
+		}
+		memset(functionBySymbol + functionBySymbolLength, 0xFF, (newLength - functionBySymbolLength) * sizeof(uint32_t));
+		functionBySymbolLength = newLength;
+	}
 
-	functionTable = newTable;
+	functionSymbols[functionCount] = symbol;
+	functionIDs[functionCount] = ID;
+	functionBySymbol[symbol] = functionCount;
 	++functionCount;
 }
 
-void appendToFunctionTable(struct Token identifier, uint32_t ID) {
-	//create new function
-	size_t newFunctionLength = identifier.length + 12; //8 bytes for identifier length, 4 for ID
-	struct ByteArray newFunction = allocByteArray(newFunctionLength);
-
-	//fill data
-	//potential errors here if size_t is less than 64 bits
-	memcpy(newFunction.ptr, &ID, 4); //function id
-	memcpy(newFunction.ptr + 4, &identifier.length, 8); //length of identifier
-	fseek(srcPtr, identifier.fileIndex, SEEK_SET); //identifier
-	fread(newFunction.ptr + 12, sizeof(char), identifier.length, srcPtr);
-
-	//make new table
-	struct ByteArray newTable = combineByteArrays(functionTable, newFunction);
+uint32_t findInFunctionTable(const char* identifier, size_t identifierLength) {
+	uint32_t symbol = findSymbol(identifier, identifierLength);
+	if (symbol == SYMBOL_NONE || symbol >= functionBySymbolLength || functionBySymbol[symbol] == (uint32_t)-1) {
+		return -1;
+	}
+	return functionIDs[functionBySymbol[symbol]];
+}
 
-	//free old data
-	freeByteArray(&functionTable);
-	freeByteArray(&newFunction);
+//serialises the function table in order of appending
+void appendFunctionTable(struct ByteBuffer* buffer) {
+	appendU32(buffer, functionCount);
 
-	functionTable = newTable;
-	++functionCount;
+	for (uint32_t i = 0; i < functionCount; ++i) {
+		uint32_t symbol = functionSymbols[i];
+		appendU32(buffer, functionIDs[i]); //function id
+		appendU64(buffer, symbolLength(symbol)); //length of identifier
+		appendBytes(buffer, symbolText(symbol), symbolLength(symbol)); //identifier
+	}
 }
 
-//this should technically return a u32, but this is C so im just going to truncate
-//also DISGUSTING code here
-uint32_t findInFunctionTable(struct Token identifier) {
-	const size_t maxIndex = functionTable.length - identifier.length;
-	if (maxIndex > functionTable.length) {
-		return -1;
+//size of the serialised function table
+size_t functionTableLength() {
+	size_t tableLength = 4; //function count
+	for (uint32_t i = 0; i < functionCount; ++i) {
+		tableLength += 12 + symbolLength(functionSymbols[i]); //4 bytes for ID, 8 for identifier length
 	}
+	return tableLength;
+}
 
-	size_t length = 0;
-	size_t searchIndex = 8;
-
-	bool searching = true;
-	while (searching) {
-		memcpy(&length, functionTable.ptr + searchIndex, 8); //so much memory unsafety holy shit
-		searchIndex += 8;
-		if (length == identifier.length) {
-			bool match = true;
-			for (size_t i = 0; i < length; ++i) {
-				fseek(srcPtr, identifier.fileIndex + i, SEEK_SET);
-				if (fgetc(srcPtr) != *(functionTable.ptr + searchIndex + i)) {
-					match = false;
-				}			
-			}
-			if (match) {
-				uint32_t functionID;
-				memcpy(&functionID, functionTable.ptr + searchIndex - 12, 4); //memory unsafe
-				return functionID;
-			} else {
-				searchIndex += length + 4;
-			}
-		}
+//serialises the function index in order of definition
+void appendFunctionIndex(struct ByteBuffer* buffer) {
+	appendU32(buffer, indexedFunctionCount);
 
-		if (searchIndex >= maxIndex) {
-			searching = false;
-		}
+	for (uint32_t i = 0; i < indexedFunctionCount; ++i) {
+		appendU32(buffer, indexedFunctionIDs[i]);
+		appendU64(buffer, indexedFunctionOffsets[i]);
+		appendU64(buffer, indexedFunctionLengths[i]);
 	}
-	
-	return -1;
 }
 
 uint32_t createStaticData(enum IRType type, uint8_t sizeExp, uint64_t count, char* data) {
@@ -135,19 +139,12 @@ uint32_t createStaticData(enum IRType type, uint8_t sizeExp, uint64_t count, cha
 	}
 
 	size_t typeSize = 1 << (sizeExp - 3);
-	struct ByteArray staticData = allocByteArray(14 + (typeSize * count));
-	memcpy(staticData.ptr, &nextStaticID, 4);
+	appendU32(&staticVariables, nextStaticID);
 	--nextStaticID;
-	memcpy(staticData.ptr + 4, &type, 1);
-	memcpy(staticData.ptr + 5, &sizeExp, 1);
-	memcpy(staticData.ptr + 6, &count, 8);
-	memcpy(staticData.ptr + 14, data, typeSize * count);
-
-	struct ByteArray newStatic = combineByteArrays(staticVariables, staticData);
-	freeByteArray(&staticVariables);
-	freeByteArray(&staticData);
-
-	staticVariables = newStatic;
+	appendU8(&staticVariables, type);
+	appendU8(&staticVariables, sizeExp);
+	appendU64(&staticVariables, count);
+	appendBytes(&staticVariables, data, typeSize * count);
 
 	return nextStaticID + 1;
 }
@@ -158,111 +155,94 @@ void insertTypeIdentifier(enum IRType type, uint8_t sizeExp, bool isStatic) {
 		exit(1);
 	}
 
-	struct ByteArray* insertInto = &programLogic;
+	struct ByteBuffer* insertInto = &programLogic;
 	if (isStatic) {
 		insertInto = &staticVariables;
 	}
 
-	struct ByteArray identifier = allocByteArray(2);
-	memcpy(identifier.ptr, &type, 1);
-	memcpy(identifier.ptr + 1, &sizeExp, 1);
-	
-	struct ByteArray newLogic = combineByteArrays(*insertInto, identifier);
-	freeByteArray(insertInto);
-	freeByteArray(&identifier);
-
-	*insertInto = newLogic;
+	appendU8(insertInto, type);
+	appendU8(insertInto, sizeExp);
 }
 
 void insertValue(uint64_t value, size_t bytes) {
-	struct ByteArray valBytes = allocByteArray(bytes);
-	memcpy(valBytes.ptr, &value, bytes);
-
-	struct ByteArray newLogic = combineByteArrays(programLogic, valBytes);
-	freeByteArray(&programLogic);
-	freeByteArray(&valBytes);
-
-	programLogic = newLogic;
+	appendUInt(&programLogic, value, bytes);
 }
 
 void insertConstant(enum IRType type, uint8_t sizeExp, uint64_t value) {
-	size_t typeSize = 1 << (sizeExp - 3);
+	appendU32(&programLogic, 0); //%0 signifies a constant
+	appendU8(&programLogic, type);
+	appendU8(&programLogic, sizeExp);
 
-	size_t constantSize = 6 + typeSize;
 	//check if size type
-	bool isSizeType = sizeExp == (uint8_t)-1;
-	if (isSizeType) {
-		typeSize = sizeof(uint64_t);
-		constantSize = 7 + typeSize;
-	}
-
-	struct ByteArray constant = allocByteArray(constantSize);
-	memcpy(constant.ptr + 4, &type, 1);
-	memcpy(constant.ptr + 5, &sizeExp, 1);
-	if (isSizeType) {
+	if (sizeExp == (uint8_t)-1) {
 		const uint8_t dataSizePower = 6; //when size type, the data inserted will be 64 bits for now (2^6 = 64)
-		memcpy(constant.ptr + 6, &dataSizePower, 1);
-		memcpy(constant.ptr + 7, &value, typeSize);
-	} else {
-		memcpy(constant.ptr + 6, &value, typeSize);
+		appendU8(&programLogic, dataSizePower);
+		appendU64(&programLogic, value);
+		return;
 	}
 
-	struct ByteArray newLogic = combineByteArrays(programLogic, constant);
-	freeByteArray(&programLogic);
-	freeByteArray(&constant);
-
-	programLogic = newLogic;
+	size_t typeSize = 1 << (sizeExp - 3);
+	appendUInt(&programLogic, value, typeSize);
 }
 
 void initialiseFunctionDefinition(uint32_t ID) {
-	struct ByteArray functionStart = allocByteArray(16);
-	memcpy(functionStart.ptr, &ID, 4); //a bit unsafe
-
 	currentFunctionIndex = programLogic.length; //save current function index for later
 
-	struct ByteArray newLogic = combineByteArrays(programLogic, functionStart);
-	freeByteArray(&programLogic);
-	freeByteArray(&functionStart);
+	//grow arrays
+	if (indexedFunctionCount == indexedFunctionCapacity) {
+		indexedFunctionCapacity = indexedFunctionCapacity == 0 ? 16 : indexedFunctionCapacity * 2;
+		indexedFunctionIDs = realloc(indexedFunctionIDs, indexedFunctionCapacity * sizeof(uint32_t));
+		indexedFunctionOffsets = realloc(indexedFunctionOffsets, indexedFunctionCapacity * sizeof(uint64_t));
+		indexedFunctionLengths = realloc(indexedFunctionLengths, indexedFunctionCapacity * sizeof(uint64_t));
+		if (indexedFunctionIDs == NULL || indexedFunctionOffsets == NULL || indexedFunctionLengths == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for function index!\n");
+			exit(1);
+		}
+	}
+	indexedFunctionIDs[indexedFunctionCount] = ID;
+	indexedFunctionOffsets[indexedFunctionCount] = currentFunctionIndex;
+	indexedFunctionLengths[indexedFunctionCount] = 0;
+	++indexedFunctionCount;
 
-	programLogic = newLogic;
+	appendU32(&programLogic, ID);
+	appendZeroes(&programLogic, 16); //block count, output count and input count, filled in at finalisation
 }
 
-//to be used immediately after type identifiers insertion
+//to be used after the function's last block
 void finaliseFunctionDefinition(uint64_t blockCount, uint32_t inCount, uint32_t outCount) {
-	memcpy(programLogic.ptr + currentFunctionIndex + 4, &blockCount, 8); //a bit unsafe
-	memcpy(programLogic.ptr + currentFunctionIndex + 12, &outCount, 4);
-	memcpy(programLogic.ptr + currentFunctionIndex + 16, &inCount, 4);
+	patchUInt(&programLogic, currentFunctionIndex + 4, blockCount, 8);
+	patchUInt(&programLogic, currentFunctionIndex + 12, outCount, 4);
+	patchUInt(&programLogic, currentFunctionIndex + 16, inCount, 4);
+	indexedFunctionLengths[indexedFunctionCount - 1] = programLogic.length - currentFunctionIndex;
 }
 
 void initialiseBlockDefinition(uint32_t argumentCount) {
-	struct ByteArray blockStart = allocByteArray(12);
-	memcpy(blockStart.ptr + 8, &argumentCount, 4); //a bit unsafe
-
 	currentBlockIndex = programLogic.length; //save current block index for later
 
-	struct ByteArray newLogic = combineByteArrays(programLogic, blockStart);
-	freeByteArray(&programLogic);
-	freeByteArray(&blockStart);
-
-	programLogic = newLogic;
+	appendZeroes(&programLogic, 8); //instruction count, filled in at finalisation
+	appendU32(&programLogic, argumentCount);
 }
 
 void finaliseBlockDefinition(uint64_t instructionCount) {
-	memcpy(programLogic.ptr + currentBlockIndex, &instructionCount, 8); //a bit unsafe
+	patchUInt(&programLogic, currentBlockIndex, instructionCount, 8);
 }
 
-void resetBytecodeGen(FILE* filePtr) {
-	srcPtr = filePtr;
-
+void resetBytecodeGen() {
 	//dont do memory leaks
 	freeBytecodeSections();
 
 	//allocate initial
-	functionTable = allocByteArray(4); //for function count
-	staticVariables = allocByteArray(4); //for static count
+	staticVariables = allocByteBuffer(4096);
+	appendZeroes(&staticVariables, 4); //for static count
+	programLogic = allocByteBuffer(4096);
 
 	//reset variables
+	resetSymbolTable();
 	functionCount = 0;
+	indexedFunctionCount = 0;
+	if (functionBySymbol != NULL) {
+		memset(functionBySymbol, 0xFF, functionBySymbolLength * sizeof(uint32_t));
+	}
 
 	nextStaticID = (uint32_t)-1;
 
@@ -275,41 +255,36 @@ void resetBytecodeGen(FILE* filePtr) {
 }
 
 struct ByteArray finaliseBytecode() {
-	//create a temporary deep copy of staticHeader
-	struct ByteArray staticHeaderCopy = allocByteArray(staticHeader.length);
-	memcpy(staticHeaderCopy.ptr, staticHeader.ptr, staticHeaderCopy.length);
-
 	//calculate section offsets
-	size_t functionTableOffset = staticHeaderCopy.length;
-	size_t staticVariablesOffset = functionTableOffset + functionTable.length;
-	size_t programLogicOffset = staticVariablesOffset + staticVariables.length;
-
-	//insert section offsets
-	memcpy(staticHeaderCopy.ptr + 16, &functionTableOffset, 8); //a bit unsafe
-	memcpy(staticHeaderCopy.ptr + 24, &staticVariablesOffset, 8);
-	memcpy(staticHeaderCopy.ptr + 32, &programLogicOffset, 8);
+	size_t functionTableOffset = staticHeader.length;
+	size_t staticVariablesOffset = functionTableOffset + functionTableLength();
+	size_t functionIndexOffset = staticVariablesOffset + staticVariables.length;
+	size_t programLogicOffset = functionIndexOffset + 4 + indexedFunctionCount * 20; //4 bytes for the count, 20 per entry
 
 	//insert other variables
-	memcpy(functionTable.ptr, &functionCount, 4); //a bit unsafe
-	size_t staticCount = (nextStaticID * -1) - 1;
-	memcpy(staticVariables.ptr, &staticCount, 4);
+	uint32_t staticCount = (nextStaticID * -1) - 1;
+	patchUInt(&staticVariables, 0, staticCount, 4);
 
 	//combine
-	struct ByteArray temp0 = combineByteArrays(staticHeaderCopy, functionTable);
-	struct ByteArray temp1 = combineByteArrays(staticVariables, programLogic);
+	struct ByteBuffer bytecode = allocByteBuffer(programLogicOffset + programLogic.length);
 
-	struct ByteArray bytecode = combineByteArrays(temp0, temp1);
+	appendBytes(&bytecode, staticHeader.ptr, staticHeader.length);
+	patchUInt(&bytecode, 16, BYTECODE_FLAG_FUNCTION_INDEX, 8);
+	//insert section offsets
+	patchUInt(&bytecode, 24, functionTableOffset, 8);
+	patchUInt(&bytecode, 32, staticVariablesOffset, 8);
+	patchUInt(&bytecode, 40, functionIndexOffset, 8);
+	patchUInt(&bytecode, 48, programLogicOffset, 8);
 
-	//free temps
-	freeByteArray(&staticHeaderCopy);
-	freeByteArray(&temp0);
-	freeByteArray(&temp1);
+	appendFunctionTable(&bytecode);
+	appendBytes(&bytecode, staticVariables.ptr, staticVariables.length);
+	appendFunctionIndex(&bytecode);
+	appendBytes(&bytecode, programLogic.ptr, programLogic.length);
 
-	return bytecode;
+	return byteBufferToArray(&bytecode);
 }
 
 void freeBytecodeSections() {
-	freeByteArray(&functionTable);
-	freeByteArray(&staticVariables);
-	freeByteArray(&programLogic);
+	freeByteBuffer(&staticVariables);
+	freeByteBuffer(&programLogic);
 }
\ No newline at end of file
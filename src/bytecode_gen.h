@@ -3,10 +3,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
-#include <stdio.h>
 
 #include "operation.h"
-#include "token.h"
 
 enum IRType {
 	IR_INTEGER = 1,
@@ -23,9 +21,13 @@ enum IRType {
 	IR_POINTER_VOID = 0,
 };
 
-void appendToFunctionTable(struct Token identifier, uint32_t ID);
+//header flags, see IR_spec.md
+#define BYTECODE_FLAG_FUNCTION_INDEX ((uint64_t)1) //the function index section is present
+
+//identifiers are not null terminated
+void appendToFunctionTable(const char* identifier, size_t identifierLength, uint32_t ID);
 //returns -1 if not in table
-uint32_t findInFunctionTable(struct Token identifier);
+uint32_t findInFunctionTable(const char* identifier, size_t identifierLength);
 
 //type is of the pointee, returns the variable ID of the pointer to it, IT IS NOT THE ID OF THE DATA ITSELF
 uint32_t createStaticData(enum IRType type, uint8_t sizeExp, uint64_t count, char* data);
@@ -43,7 +45,7 @@ void initialiseBlockDefinition(uint32_t argumentCount);
 void finaliseBlockDefinition(uint64_t instructionCount);
 
 //MUST be called before using other functions
-void resetBytecodeGen(FILE* filePtr);
+void resetBytecodeGen();
 
 struct ByteArray finaliseBytecode();
 void freeBytecodeSections();
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include "bytecode_reader.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct BytecodeReader makeBytecodeReader(const char* ptr, size_t length) {
+	struct BytecodeReader reader = {ptr, length, 0};
+	return reader;
+}
+
+void bytecodeOutOfBounds(struct BytecodeReader* reader, size_t byteCount) {
+	fprintf(stderr, "ERROR: Unexpected end of bytecode, %zu bytes needed at index %zu of %zu!\n", byteCount, reader->index, reader->length);
+	exit(1);
+}
\ No newline at end of file
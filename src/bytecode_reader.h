@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//cursor over bytecode that is already in memory, e.g. memory mapped or just generated
+//the bytecode is never copied, every read is bounds checked and decoded little endian
+struct BytecodeReader {
+	const char* ptr;
+	size_t length;
+	size_t index;
+};
+
+struct BytecodeReader makeBytecodeReader(const char* ptr, size_t length);
+
+//reports the truncated bytecode and exits
+void bytecodeOutOfBounds(struct BytecodeReader* reader, size_t byteCount);
+
+static inline bool bytecodeHasBytes(const struct BytecodeReader* reader, size_t byteCount) {
+	return byteCount <= reader->length - reader->index;
+}
+
+//exits if the index is past the end, the end itself is allowed
+static inline void seekBytecode(struct BytecodeReader* reader, size_t index) {
+	if (index > reader->length) {
+		bytecodeOutOfBounds(reader, index - reader->index);
+	}
+	reader->index = index;
+}
+
+static inline void skipBytecode(struct BytecodeReader* reader, size_t byteCount) {
+	if (!bytecodeHasBytes(reader, byteCount)) {
+		bytecodeOutOfBounds(reader, byteCount);
+	}
+	reader->index += byteCount;
+}
+
+//pointer to the next byteCount bytes which are then skipped over, points into the bytecode itself
+static inline const char* readBytecodeBytes(struct BytecodeReader* reader, size_t byteCount) {
+	const char* bytes = reader->ptr + reader->index;
+	skipBytecode(reader, byteCount);
+	return bytes;
+}
+
+static inline uint8_t readU8(struct BytecodeReader* reader) {
+	const uint8_t* bytes = (const uint8_t*)readBytecodeBytes(reader, 1);
+	return bytes[0];
+}
+
+static inline uint32_t readU32(struct BytecodeReader* reader) {
+	const uint8_t* bytes = (const uint8_t*)readBytecodeBytes(reader, 4);
+	return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static inline uint64_t readU64(struct BytecodeReader* reader) {
+	const uint8_t* bytes = (const uint8_t*)readBytecodeBytes(reader, 8);
+	uint64_t value = 0;
+	for (size_t i = 0; i < 8; ++i) {
+		value |= (uint64_t)bytes[i] << (i * 8);
+	}
+	return value;
+}
+
+//reads a value of byteCount bytes, byteCount must be at most 8
+static inline uint64_t readUInt(struct BytecodeReader* reader, size_t byteCount) {
+	const uint8_t* bytes = (const uint8_t*)readBytecodeBytes(reader, byteCount);
+	uint64_t value = 0;
+	for (size_t i = 0; i < byteCount; ++i) {
+		value |= (uint64_t)bytes[i] << (i * 8);
+	}
+	return value;
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+#include "char_scan.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define CHAR_SCAN_AVX2
+#endif
+
+#define W CHAR_CLASS_WHITESPACE
+#define D CHAR_CLASS_DIGIT
+#define A CHAR_CLASS_ALPHA
+#define U CHAR_CLASS_UNDERSCORE
+
+const uint8_t charClasses[256] = {
+	['\t'] = W, ['\n'] = W, ['\v'] = W, ['\f'] = W, ['\r'] = W, [' '] = W,
+
+	['0'] = D, ['1'] = D, ['2'] = D, ['3'] = D, ['4'] = D,
+	['5'] = D, ['6'] = D, ['7'] = D, ['8'] = D, ['9'] = D,
+
+	['a'] = A, ['b'] = A, ['c'] = A, ['d'] = A, ['e'] = A, ['f'] = A, ['g'] = A,
+	['h'] = A, ['i'] = A, ['j'] = A, ['k'] = A, ['l'] = A, ['m'] = A, ['n'] = A,
+	['o'] = A, ['p'] = A, ['q'] = A, ['r'] = A, ['s'] = A, ['t'] = A, ['u'] = A,
+	['v'] = A, ['w'] = A, ['x'] = A, ['y'] = A, ['z'] = A,
+
+	['A'] = A, ['B'] = A, ['C'] = A, ['D'] = A, ['E'] = A, ['F'] = A, ['G'] = A,
+	['H'] = A, ['I'] = A, ['J'] = A, ['K'] = A, ['L'] = A, ['M'] = A, ['N'] = A,
+	['O'] = A, ['P'] = A, ['Q'] = A, ['R'] = A, ['S'] = A, ['T'] = A, ['U'] = A,
+	['V'] = A, ['W'] = A, ['X'] = A, ['Y'] = A, ['Z'] = A,
+
+	['_'] = U,
+};
+
+#undef W
+#undef D
+#undef A
+#undef U
+
+/**********
+* SCALAR *
+**********/
+
+const char* scanClassScalar(const char* cursor, const char* end, uint8_t charClass) {
+	while (cursor < end && charIsClass(*cursor, charClass)) {
+		++cursor;
+	}
+	return cursor;
+}
+
+const char* scanWhitespaceScalar(const char* cursor, const char* end) {
+	return scanClassScalar(cursor, end, CHAR_CLASS_WHITESPACE);
+}
+
+const char* scanIdentifierScalar(const char* cursor, const char* end) {
+	return scanClassScalar(cursor, end, CHAR_CLASS_IDENTIFIER);
+}
+
+const char* scanDigitsScalar(const char* cursor, const char* end) {
+	return scanClassScalar(cursor, end, CHAR_CLASS_DIGIT);
+}
+
+/********
+* SSE2 *
+********/
+
+#if defined(__SSE2__)
+
+//all comparisons are done as unsigned range checks, (c - low) <= (high - low)
+//there is no unsigned byte compare so min(x, limit) == x is used instead
+static inline __m128i inRangeSSE2(__m128i chars, char low, char high) {
+	__m128i offset = _mm_sub_epi8(chars, _mm_set1_epi8(low));
+	__m128i limit = _mm_set1_epi8(high - low);
+	return _mm_cmpeq_epi8(_mm_min_epu8(offset, limit), offset);
+}
+
+static inline __m128i whitespaceMaskSSE2(__m128i chars) {
+	__m128i space = _mm_cmpeq_epi8(chars, _mm_set1_epi8(' '));
+	return _mm_or_si128(space, inRangeSSE2(chars, '\t', '\r'));
+}
+
+static inline __m128i digitMaskSSE2(__m128i chars) {
+	return inRangeSSE2(chars, '0', '9');
+}
+
+static inline __m128i identifierMaskSSE2(__m128i chars) {
+	__m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20)); //folds case for letters only
+	__m128i alpha = inRangeSSE2(lower, 'a', 'z');
+	__m128i underscore = _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'));
+	return _mm_or_si128(_mm_or_si128(alpha, underscore), digitMaskSSE2(chars));
+}
+
+#define SCAN_SSE2(name, maskFunction, charClass) \
+const char* name(const char* cursor, const char* end) { \
+	while (end - cursor >= 16) { \
+		__m128i chars = _mm_loadu_si128((const __m128i*)cursor); \
+		unsigned int outside = ~_mm_movemask_epi8(maskFunction(chars)) & 0xFFFF; \
+		if (outside != 0) { \
+			return cursor + __builtin_ctz(outside); \
+		} \
+		cursor += 16; \
+	} \
+	return scanClassScalar(cursor, end, charClass); \
+}
+
+SCAN_SSE2(scanWhitespaceSSE2, whitespaceMaskSSE2, CHAR_CLASS_WHITESPACE)
+SCAN_SSE2(scanIdentifierSSE2, identifierMaskSSE2, CHAR_CLASS_IDENTIFIER)
+SCAN_SSE2(scanDigitsSSE2, digitMaskSSE2, CHAR_CLASS_DIGIT)
+
+#undef SCAN_SSE2
+
+#endif
+
+/********
+* AVX2 *
+********/
+
+#if defined(CHAR_SCAN_AVX2)
+
+__attribute__((target("avx2")))
+static inline __m256i inRangeAVX2(__m256i chars, char low, char high) {
+	__m256i offset = _mm256_sub_epi8(chars, _mm256_set1_epi8(low));
+	__m256i limit = _mm256_set1_epi8(high - low);
+	return _mm256_cmpeq_epi8(_mm256_min_epu8(offset, limit), offset);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i whitespaceMaskAVX2(__m256i chars) {
+	__m256i space = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' '));
+	return _mm256_or_si256(space, inRangeAVX2(chars, '\t', '\r'));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i digitMaskAVX2(__m256i chars) {
+	return inRangeAVX2(chars, '0', '9');
+}
+
+__attribute__((target("avx2")))
+static inline __m256i identifierMaskAVX2(__m256i chars) {
+	__m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+	__m256i alpha = inRangeAVX2(lower, 'a', 'z');
+	__m256i underscore = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('_'));
+	return _mm256_or_si256(_mm256_or_si256(alpha, underscore), digitMaskAVX2(chars));
+}
+
+#define SCAN_AVX2(name, maskFunction, charClass) \
+__attribute__((target("avx2"))) \
+const char* name(const char* cursor, const char* end) { \
+	while (end - cursor >= 32) { \
+		__m256i chars = _mm256_loadu_si256((const __m256i*)cursor); \
+		uint32_t outside = ~(uint32_t)_mm256_movemask_epi8(maskFunction(chars)); \
+		if (outside != 0) { \
+			return cursor + __builtin_ctz(outside); \
+		} \
+		cursor += 32; \
+	} \
+	return scanClassScalar(cursor, end, charClass); \
+}
+
+SCAN_AVX2(scanWhitespaceAVX2, whitespaceMaskAVX2, CHAR_CLASS_WHITESPACE)
+SCAN_AVX2(scanIdentifierAVX2, identifierMaskAVX2, CHAR_CLASS_IDENTIFIER)
+SCAN_AVX2(scanDigitsAVX2, digitMaskAVX2, CHAR_CLASS_DIGIT)
+
+#undef SCAN_AVX2
+
+#endif
+
+/************
+* DISPATCH *
+************/
+
+typedef const char* (*ScanFunction)(const char* cursor, const char* end);
+
+static bool scannerSelected = false;
+static ScanFunction whitespaceScanner = scanWhitespaceScalar;
+static ScanFunction identifierScanner = scanIdentifierScalar;
+static ScanFunction digitScanner = scanDigitsScalar;
+
+bool charScannerSupported(enum CharScanner scanner) {
+	switch (scanner) {
+		case CHAR_SCANNER_SCALAR: return true;
+
+#if defined(__SSE2__)
+		case CHAR_SCANNER_SSE2: return true;
+#endif
+
+#if defined(CHAR_SCAN_AVX2)
+		case CHAR_SCANNER_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+
+		default: return false;
+	}
+}
+
+enum CharScanner bestCharScanner() {
+	if (charScannerSupported(CHAR_SCANNER_AVX2)) {
+		return CHAR_SCANNER_AVX2;
+	}
+	if (charScannerSupported(CHAR_SCANNER_SSE2)) {
+		return CHAR_SCANNER_SSE2;
+	}
+	return CHAR_SCANNER_SCALAR;
+}
+
+bool setCharScanner(enum CharScanner scanner) {
+	if (!charScannerSupported(scanner)) {
+		return false;
+	}
+
+	switch (scanner) {
+		case CHAR_SCANNER_SCALAR:
+		whitespaceScanner = scanWhitespaceScalar;
+		identifierScanner = scanIdentifierScalar;
+		digitScanner = scanDigitsScalar;
+		break;
+
+#if defined(__SSE2__)
+		case CHAR_SCANNER_SSE2:
+		whitespaceScanner = scanWhitespaceSSE2;
+		identifierScanner = scanIdentifierSSE2;
+		digitScanner = scanDigitsSSE2;
+		break;
+#endif
+
+#if defined(CHAR_SCAN_AVX2)
+		case CHAR_SCANNER_AVX2:
+		whitespaceScanner = scanWhitespaceAVX2;
+		identifierScanner = scanIdentifierAVX2;
+		digitScanner = scanDigitsAVX2;
+		break;
+#endif
+
+		default: return false;
+	}
+
+	scannerSelected = true;
+	return true;
+}
+
+const char* charScannerName(enum CharScanner scanner) {
+	switch (scanner) {
+		case CHAR_SCANNER_SCALAR: return "scalar";
+		case CHAR_SCANNER_SSE2: return "sse2";
+		case CHAR_SCANNER_AVX2: return "avx2";
+		default: return "unknown";
+	}
+}
+
+void initCharScanner() {
+	if (!scannerSelected) {
+		setCharScanner(bestCharScanner());
+	}
+}
+
+//most runs are a single character (a space between tokens, a one letter identifier)
+//so the first character is checked before paying for the vector setup
+const char* scanWhitespace(const char* cursor, const char* end) {
+	if (cursor >= end || !charIsClass(*cursor, CHAR_CLASS_WHITESPACE)) {
+		return cursor;
+	}
+	initCharScanner();
+	return whitespaceScanner(cursor + 1, end);
+}
+
+const char* scanIdentifier(const char* cursor, const char* end) {
+	if (cursor >= end || !charIsClass(*cursor, CHAR_CLASS_IDENTIFIER)) {
+		return cursor;
+	}
+	initCharScanner();
+	return identifierScanner(cursor + 1, end);
+}
+
+const char* scanDigits(const char* cursor, const char* end) {
+	if (cursor >= end || !charIsClass(*cursor, CHAR_CLASS_DIGIT)) {
+		return cursor;
+	}
+	initCharScanner();
+	return digitScanner(cursor + 1, end);
+}
\ No newline at end of file
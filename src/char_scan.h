@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//character classes, locale independent
+#define CHAR_CLASS_WHITESPACE 0x01
+#define CHAR_CLASS_DIGIT 0x02
+#define CHAR_CLASS_ALPHA 0x04
+#define CHAR_CLASS_UNDERSCORE 0x08
+#define CHAR_CLASS_IDENTIFIER (CHAR_CLASS_DIGIT | CHAR_CLASS_ALPHA | CHAR_CLASS_UNDERSCORE)
+
+extern const uint8_t charClasses[256];
+
+static inline bool charIsClass(char c, uint8_t charClass) {
+	return (charClasses[(uint8_t)c] & charClass) != 0;
+}
+
+enum CharScanner {
+	CHAR_SCANNER_SCALAR,
+	CHAR_SCANNER_SSE2,
+	CHAR_SCANNER_AVX2,
+};
+
+//the best scanner supported by the running cpu, used by default
+enum CharScanner bestCharScanner();
+//returns false if the scanner is not supported by the running cpu
+bool setCharScanner(enum CharScanner scanner);
+const char* charScannerName(enum CharScanner scanner);
+//selects the best scanner unless one was already set, scanning does this lazily
+//must be called before scanning from multiple threads
+void initCharScanner();
+
+//each returns the first character at or after the cursor that is not part of the run, or end
+const char* scanWhitespace(const char* cursor, const char* end);
+const char* scanIdentifier(const char* cursor, const char* end);
+const char* scanDigits(const char* cursor, const char* end);
\ No newline at end of file
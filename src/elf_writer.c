@@ -0,0 +1,205 @@
+#include "elf_writer.h"
+
+#include <elf.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "byte_array.h"
+
+#define ELF_PAGE_SIZE 0x1000
+#define ELF_BASE_ADDRESS 0x400000
+
+static inline size_t alignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void padTo(struct ByteBuffer* buffer, size_t length) {
+	if (buffer->length < length) {
+		appendZeroes(buffer, length - buffer->length);
+	}
+}
+
+//returns the offset of the name in the string table
+uint32_t appendString(struct ByteBuffer* table, const char* string) {
+	uint32_t offset = table->length;
+	appendBytes(table, string, strlen(string) + 1);
+	return offset;
+}
+
+void appendSectionHeader(struct ByteBuffer* buffer, uint32_t name, uint32_t type, uint64_t flags, uint64_t address,
+	uint64_t offset, uint64_t size, uint32_t link, uint32_t info, uint64_t alignment, uint64_t entrySize) {
+	Elf64_Shdr header = {name, type, flags, address, offset, size, link, info, alignment, entrySize};
+	appendBytes(buffer, &header, sizeof(header));
+}
+
+Elf64_Ehdr makeElfHeader(uint16_t type, uint64_t entry, uint64_t programHeaderOffset, uint16_t programHeaderCount,
+	uint64_t sectionHeaderOffset, uint16_t sectionHeaderCount, uint16_t sectionNamesIndex) {
+	Elf64_Ehdr header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.e_ident, ELFMAG, SELFMAG);
+	header.e_ident[EI_CLASS] = ELFCLASS64;
+	header.e_ident[EI_DATA] = ELFDATA2LSB;
+	header.e_ident[EI_VERSION] = EV_CURRENT;
+	header.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+	header.e_type = type;
+	header.e_machine = EM_X86_64;
+	header.e_version = EV_CURRENT;
+	header.e_entry = entry;
+	header.e_phoff = programHeaderOffset;
+	header.e_shoff = sectionHeaderOffset;
+	header.e_ehsize = sizeof(Elf64_Ehdr);
+	header.e_phentsize = programHeaderCount == 0 ? 0 : sizeof(Elf64_Phdr);
+	header.e_phnum = programHeaderCount;
+	header.e_shentsize = sizeof(Elf64_Shdr);
+	header.e_shnum = sectionHeaderCount;
+	header.e_shstrndx = sectionNamesIndex;
+	return header;
+}
+
+void appendProgramHeader(struct ByteBuffer* buffer, uint32_t flags, uint64_t offset, uint64_t address, uint64_t size) {
+	Elf64_Phdr header = {PT_LOAD, flags, offset, address, address, size, size, ELF_PAGE_SIZE};
+	appendBytes(buffer, &header, sizeof(header));
+}
+
+void writeElfBuffer(struct ByteBuffer* buffer, FILE* file) {
+	if (fwrite(buffer->ptr, 1, buffer->length, file) != buffer->length) {
+		fprintf(stderr, "ERROR: Could not write elf output!\n");
+		exit(1);
+	}
+	freeByteBuffer(buffer);
+}
+
+void writeElfExecutable(struct X86Code code, FILE* file) {
+	//file offsets and addresses are congruent so each section can be mapped straight from the file
+	size_t textOffset = ELF_PAGE_SIZE;
+	size_t dataOffset = alignUp(textOffset + code.text.length, ELF_PAGE_SIZE);
+	uint64_t textAddress = ELF_BASE_ADDRESS + textOffset;
+	uint64_t dataAddress = ELF_BASE_ADDRESS + dataOffset;
+
+	struct ByteBuffer sectionNames = allocByteBuffer(64);
+	appendString(&sectionNames, "");
+	uint32_t textName = appendString(&sectionNames, ".text");
+	uint32_t dataName = appendString(&sectionNames, ".data");
+	uint32_t sectionNamesName = appendString(&sectionNames, ".shstrtab");
+
+	size_t sectionNamesOffset = dataOffset + code.data.length;
+	size_t sectionHeaderOffset = alignUp(sectionNamesOffset + sectionNames.length, 8);
+
+	struct ByteBuffer output = allocByteBuffer(sectionHeaderOffset + 4 * sizeof(Elf64_Shdr));
+
+	Elf64_Ehdr header = makeElfHeader(ET_EXEC, textAddress + code.entryOffset, sizeof(Elf64_Ehdr), 2, sectionHeaderOffset, 4, 3);
+	appendBytes(&output, &header, sizeof(header));
+	appendProgramHeader(&output, PF_R | PF_X, textOffset, textAddress, code.text.length);
+	appendProgramHeader(&output, PF_R | PF_W, dataOffset, dataAddress, code.data.length);
+
+	//text with the static addresses filled in
+	padTo(&output, textOffset);
+	appendBytes(&output, code.text.ptr, code.text.length);
+	for (size_t i = 0; i < code.relocationCount; ++i) {
+		size_t fieldOffset = textOffset + code.relocationOffsets[i];
+		uint64_t staticOffset = 0;
+		memcpy(&staticOffset, output.ptr + fieldOffset, 8);
+		patchUInt(&output, fieldOffset, dataAddress + staticOffset, 8);
+	}
+
+	padTo(&output, dataOffset);
+	appendBytes(&output, code.data.ptr, code.data.length);
+	appendBytes(&output, sectionNames.ptr, sectionNames.length);
+
+	padTo(&output, sectionHeaderOffset);
+	appendSectionHeader(&output, 0, SHT_NULL, 0, 0, 0, 0, 0, 0, 0, 0);
+	appendSectionHeader(&output, textName, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, textAddress, textOffset, code.text.length, 0, 0, 16, 0);
+	appendSectionHeader(&output, dataName, SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, dataAddress, dataOffset, code.data.length, 0, 0, 16, 0);
+	appendSectionHeader(&output, sectionNamesName, SHT_STRTAB, 0, 0, sectionNamesOffset, sectionNames.length, 0, 0, 1, 0);
+
+	freeByteBuffer(&sectionNames);
+	writeElfBuffer(&output, file);
+}
+
+void writeElfObject(struct X86Code code, FILE* file) {
+	//section indices
+	enum {
+		SECTION_NULL, SECTION_TEXT, SECTION_DATA, SECTION_RELA_TEXT, SECTION_SYMTAB, SECTION_STRTAB, SECTION_SHSTRTAB,
+		SECTION_COUNT,
+	};
+	//symbol indices, locals must come first
+	enum {
+		SYMBOL_NULL, SYMBOL_TEXT, SYMBOL_DATA, SYMBOL_START,
+		SYMBOL_COUNT,
+	};
+
+	struct ByteBuffer sectionNames = allocByteBuffer(64);
+	appendString(&sectionNames, "");
+	uint32_t textName = appendString(&sectionNames, ".text");
+	uint32_t dataName = appendString(&sectionNames, ".data");
+	uint32_t relaTextName = appendString(&sectionNames, ".rela.text");
+	uint32_t symtabName = appendString(&sectionNames, ".symtab");
+	uint32_t strtabName = appendString(&sectionNames, ".strtab");
+	uint32_t shstrtabName = appendString(&sectionNames, ".shstrtab");
+
+	struct ByteBuffer strings = allocByteBuffer(64);
+	appendString(&strings, "");
+	uint32_t startName = appendString(&strings, "_start");
+
+	size_t textOffset = sizeof(Elf64_Ehdr);
+	size_t dataOffset = alignUp(textOffset + code.text.length, 16);
+	size_t relaOffset = alignUp(dataOffset + code.data.length, 8);
+	size_t relaSize = code.relocationCount * sizeof(Elf64_Rela);
+	size_t symtabOffset = relaOffset + relaSize;
+	size_t symtabSize = SYMBOL_COUNT * sizeof(Elf64_Sym);
+	size_t strtabOffset = symtabOffset + symtabSize;
+	size_t shstrtabOffset = strtabOffset + strings.length;
+	size_t sectionHeaderOffset = alignUp(shstrtabOffset + sectionNames.length, 8);
+
+	struct ByteBuffer output = allocByteBuffer(sectionHeaderOffset + SECTION_COUNT * sizeof(Elf64_Shdr));
+
+	Elf64_Ehdr header = makeElfHeader(ET_REL, 0, 0, 0, sectionHeaderOffset, SECTION_COUNT, SECTION_SHSTRTAB);
+	appendBytes(&output, &header, sizeof(header));
+
+	//static address fields are zeroed, the linker writes data + addend
+	appendBytes(&output, code.text.ptr, code.text.length);
+	padTo(&output, dataOffset);
+	appendBytes(&output, code.data.ptr, code.data.length);
+
+	padTo(&output, relaOffset);
+	for (size_t i = 0; i < code.relocationCount; ++i) {
+		size_t fieldOffset = textOffset + code.relocationOffsets[i];
+		uint64_t staticOffset = 0;
+		memcpy(&staticOffset, output.ptr + fieldOffset, 8);
+		patchUInt(&output, fieldOffset, 0, 8);
+
+		Elf64_Rela relocation = {code.relocationOffsets[i], ELF64_R_INFO(SYMBOL_DATA, R_X86_64_64), (int64_t)staticOffset};
+		appendBytes(&output, &relocation, sizeof(relocation));
+	}
+
+	Elf64_Sym symbols[SYMBOL_COUNT];
+	memset(symbols, 0, sizeof(symbols));
+	symbols[SYMBOL_TEXT].st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+	symbols[SYMBOL_TEXT].st_shndx = SECTION_TEXT;
+	symbols[SYMBOL_DATA].st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+	symbols[SYMBOL_DATA].st_shndx = SECTION_DATA;
+	symbols[SYMBOL_START].st_name = startName;
+	symbols[SYMBOL_START].st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+	symbols[SYMBOL_START].st_shndx = SECTION_TEXT;
+	symbols[SYMBOL_START].st_value = code.entryOffset;
+	appendBytes(&output, symbols, sizeof(symbols));
+
+	appendBytes(&output, strings.ptr, strings.length);
+	appendBytes(&output, sectionNames.ptr, sectionNames.length);
+
+	padTo(&output, sectionHeaderOffset);
+	appendSectionHeader(&output, 0, SHT_NULL, 0, 0, 0, 0, 0, 0, 0, 0);
+	appendSectionHeader(&output, textName, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0, textOffset, code.text.length, 0, 0, 16, 0);
+	appendSectionHeader(&output, dataName, SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 0, dataOffset, code.data.length, 0, 0, 16, 0);
+	appendSectionHeader(&output, relaTextName, SHT_RELA, SHF_INFO_LINK, 0, relaOffset, relaSize, SECTION_SYMTAB, SECTION_TEXT, 8, sizeof(Elf64_Rela));
+	appendSectionHeader(&output, symtabName, SHT_SYMTAB, 0, 0, symtabOffset, symtabSize, SECTION_STRTAB, SYMBOL_START, 8, sizeof(Elf64_Sym));
+	appendSectionHeader(&output, strtabName, SHT_STRTAB, 0, 0, strtabOffset, strings.length, 0, 0, 1, 0);
+	appendSectionHeader(&output, shstrtabName, SHT_STRTAB, 0, 0, shstrtabOffset, sectionNames.length, 0, 0, 1, 0);
+
+	freeByteBuffer(&sectionNames);
+	freeByteBuffer(&strings);
+	writeElfBuffer(&output, file);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <stdio.h>
+
+#include "x86_emit.h"
+
+//static linux executable, text and data each get their own segment and _start is the entry point
+void writeElfExecutable(struct X86Code code, FILE* file);
+
+//relocatable object for linking with other objects, static addresses become relocations
+void writeElfObject(struct X86Code code, FILE* file);
\ No newline at end of file
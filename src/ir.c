@@ -0,0 +1,516 @@
+#include "ir.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "bytecode_reader.h"
+
+//highest dynamic variable ID seen in the function being decoded
+static uint32_t highestVariableID = 0;
+
+struct IROperand irConstant(struct IRValueType type, uint64_t value) {
+	struct IROperand constant = {0, type, type.sizeExp, value};
+	if (type.sizeExp == (uint8_t)-1) {
+		constant.dataSizeExp = 6; //word sized constants are stored as 64 bits
+	}
+	return constant;
+}
+
+struct IRValueType decodeValueType(struct BytecodeReader* reader) {
+	struct IRValueType type;
+	type.type = (int8_t)readU8(reader);
+	type.sizeExp = readU8(reader);
+	return type;
+}
+
+struct IRValueType* decodeValueTypes(struct BytecodeReader* reader, uint32_t count) {
+	//every type is 2 bytes, so a corrupt count cant allocate more than the bytecode
+	if (count > (reader->length - reader->index) / 2) {
+		bytecodeOutOfBounds(reader, (size_t)count * 2);
+	}
+	struct IRValueType* types = arenaAlloc(ARENA_CODEGEN, count * sizeof(struct IRValueType));
+	for (uint32_t i = 0; i < count; ++i) {
+		types[i] = decodeValueType(reader);
+	}
+	return types;
+}
+
+uint32_t decodeVariableID(struct BytecodeReader* reader) {
+	uint32_t ID = readU32(reader);
+	if (!irIsStaticVariable(ID) && ID > highestVariableID) {
+		highestVariableID = ID;
+	}
+	return ID;
+}
+
+struct IROperand decodeOperand(struct BytecodeReader* reader) {
+	struct IROperand operand = {decodeVariableID(reader), {0, 0}, 0, 0};
+	if (operand.variableID != 0) {
+		return operand;
+	}
+
+	operand.type = decodeValueType(reader);
+	operand.dataSizeExp = operand.type.sizeExp;
+	if (operand.type.sizeExp == (uint8_t)-1) {
+		operand.dataSizeExp = readU8(reader);
+	}
+	if (operand.dataSizeExp < 3 || operand.dataSizeExp > 6) {
+		fprintf(stderr, "ERROR: Constant data size currently not supported!\n");
+		exit(1);
+	}
+	operand.value = readUInt(reader, 1 << (operand.dataSizeExp - 3));
+	return operand;
+}
+
+//allocates and decodes the results and operands, results come first in the bytecode
+void decodeResultsAndOperands(struct BytecodeReader* reader, struct IRInstruction* instruction, uint32_t resultCount, uint32_t operandCount) {
+	//results and sources are each at least a 4 byte variable ID, the counts of user calls come from the bytecode
+	size_t count = (size_t)resultCount + operandCount;
+	if (count > (reader->length - reader->index) / 4) {
+		bytecodeOutOfBounds(reader, count * 4);
+	}
+	instruction->resultCount = resultCount;
+	instruction->operandCount = operandCount;
+	instruction->results = arenaAlloc(ARENA_CODEGEN, resultCount * sizeof(uint32_t));
+	instruction->operands = arenaAlloc(ARENA_CODEGEN, operandCount * sizeof(struct IROperand));
+	for (uint32_t i = 0; i < resultCount; ++i) {
+		instruction->results[i] = decodeVariableID(reader);
+	}
+	for (uint32_t i = 0; i < operandCount; ++i) {
+		instruction->operands[i] = decodeOperand(reader);
+	}
+}
+
+//reads the block and the arguments passed to it, the arguments are added to the end of the operands
+void decodeTarget(struct BytecodeReader* reader, struct IRInstruction* instruction) {
+	struct IRTarget* target = &instruction->targets[instruction->targetCount];
+	++instruction->targetCount;
+	target->block = readU64(reader);
+	target->argumentCount = readU32(reader);
+	target->firstArgument = instruction->operandCount;
+
+	//every source is at least its 4 byte variable ID
+	if (target->argumentCount > (reader->length - reader->index) / 4) {
+		bytecodeOutOfBounds(reader, (size_t)target->argumentCount * 4);
+	}
+	uint32_t operandCount = instruction->operandCount + target->argumentCount;
+	struct IROperand* operands = arenaAlloc(ARENA_CODEGEN, operandCount * sizeof(struct IROperand));
+	if (instruction->operandCount != 0) {
+		memcpy(operands, instruction->operands, instruction->operandCount * sizeof(struct IROperand));
+	}
+	for (uint32_t i = instruction->operandCount; i < operandCount; ++i) {
+		operands[i] = decodeOperand(reader);
+	}
+	instruction->operands = operands;
+	instruction->operandCount = operandCount;
+}
+
+struct IRInstruction decodeInstruction(struct BytecodeReader* reader, const struct IRFunction* function) {
+	struct IRInstruction instruction;
+	memset(&instruction, 0, sizeof(instruction));
+	instruction.ID = readU32(reader);
+
+	switch (instruction.ID) {
+		case IR_DECLARE:
+		instruction.declaredType = decodeValueType(reader);
+		decodeResultsAndOperands(reader, &instruction, 1, 0);
+		break;
+
+		case IR_MOVE:
+		decodeResultsAndOperands(reader, &instruction, 1, 1);
+		break;
+
+		case IR_RETURN:
+		decodeResultsAndOperands(reader, &instruction, 0, function->outputCount);
+		break;
+
+		case IR_JUMP:
+		decodeResultsAndOperands(reader, &instruction, 0, 0);
+		decodeTarget(reader, &instruction);
+		break;
+
+		case IR_BRANCH:
+		decodeResultsAndOperands(reader, &instruction, 0, 1);
+		decodeTarget(reader, &instruction);
+		decodeTarget(reader, &instruction);
+		break;
+
+		case IR_ADD:
+		case IR_SUBTRACT:
+		case IR_MULTIPLY:
+		case IR_DIVIDE:
+		case IR_REMAINDER:
+		decodeResultsAndOperands(reader, &instruction, 1, 2);
+		break;
+
+		case IR_PRINT:
+		decodeResultsAndOperands(reader, &instruction, 0, 2);
+		break;
+
+		default:
+		if (irIsSpecID(instruction.ID)) {
+			fprintf(stderr, "ERROR: Unknown instruction %d in bytecode!\n", (int32_t)instruction.ID);
+			exit(1);
+		}
+
+		//user function calls state their own output and input counts
+		uint32_t outputCount = readU32(reader);
+		uint32_t inputCount = readU32(reader);
+		decodeResultsAndOperands(reader, &instruction, outputCount, inputCount);
+		break;
+	}
+
+	return instruction;
+}
+
+struct IRBlock decodeBlock(struct BytecodeReader* reader, const struct IRFunction* function, bool firstBlock) {
+	struct IRBlock block;
+	block.instructionCount = readU64(reader);
+	block.argumentCount = readU32(reader);
+	block.argumentTypes = decodeValueTypes(reader, block.argumentCount);
+
+	//the first block inherits the function inputs as its arguments, later blocks give the ID of each
+	if (firstBlock) {
+		if (block.argumentCount != 0 && block.argumentCount != function->inputCount) {
+			fprintf(stderr, "ERROR: First block of function %u has arguments other than the inputs!\n", function->ID);
+			exit(1);
+		}
+		block.argumentCount = function->inputCount;
+		block.argumentTypes = function->inputTypes;
+	}
+	block.argumentIDs = arenaAlloc(ARENA_CODEGEN, block.argumentCount * sizeof(uint32_t));
+	for (uint32_t i = 0; i < block.argumentCount; ++i) {
+		block.argumentIDs[i] = firstBlock ? i + 1 : decodeVariableID(reader);
+	}
+
+	//every instruction is at least its 4 byte ID, so a corrupt count cant allocate more than the bytecode
+	if (block.instructionCount > (reader->length - reader->index) / 4) {
+		bytecodeOutOfBounds(reader, block.instructionCount * 4);
+	}
+	block.instructions = arenaAlloc(ARENA_CODEGEN, block.instructionCount * sizeof(struct IRInstruction));
+	for (size_t i = 0; i < block.instructionCount; ++i) {
+		block.instructions[i] = decodeInstruction(reader, function);
+	}
+	return block;
+}
+
+//jumps and branches have to end their block and pass a block the arguments it takes
+void checkControlFlow(const struct IRFunction* function) {
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			if (instruction->targetCount != 0 && j + 1 != block->instructionCount) {
+				fprintf(stderr, "ERROR: Jump in the middle of block %zu of function %u!\n", i, function->ID);
+				exit(1);
+			}
+			for (uint32_t k = 0; k < instruction->targetCount; ++k) {
+				const struct IRTarget* target = &instruction->targets[k];
+				if (target->block >= function->blockCount) {
+					fprintf(stderr, "ERROR: Jump to block %zu outside of function %u!\n", target->block, function->ID);
+					exit(1);
+				}
+				if (target->argumentCount != function->blocks[target->block].argumentCount) {
+					fprintf(stderr, "ERROR: Jump to block %zu of function %u with the wrong argument count!\n", target->block, function->ID);
+					exit(1);
+				}
+			}
+		}
+
+		bool fallsThrough = block->instructionCount == 0 || !irIsTerminator(block->instructions[block->instructionCount - 1].ID);
+		if (fallsThrough && i + 1 < function->blockCount && function->blocks[i + 1].argumentCount != 0) {
+			fprintf(stderr, "ERROR: Block %zu of function %u carries on into a block with arguments!\n", i, function->ID);
+			exit(1);
+		}
+	}
+}
+
+struct IRFunction decodeFunction(struct BytecodeReader* reader) {
+	struct IRFunction function;
+	function.ID = readU32(reader);
+	if (irIsSpecID(function.ID)) {
+		fprintf(stderr, "ERROR: Definition of specification function %u in bytecode!\n", function.ID);
+		exit(1);
+	}
+	function.blockCount = readU64(reader);
+	function.outputCount = readU32(reader);
+	function.inputCount = readU32(reader);
+	function.outputTypes = decodeValueTypes(reader, function.outputCount);
+	function.inputTypes = decodeValueTypes(reader, function.inputCount);
+
+	//every block is at least its 12 byte header
+	if (function.blockCount > (reader->length - reader->index) / 12) {
+		bytecodeOutOfBounds(reader, function.blockCount * 12);
+	}
+
+	highestVariableID = function.inputCount;
+	function.blocks = arenaAlloc(ARENA_CODEGEN, function.blockCount * sizeof(struct IRBlock));
+	for (size_t i = 0; i < function.blockCount; ++i) {
+		function.blocks[i] = decodeBlock(reader, &function, i == 0);
+	}
+	checkControlFlow(&function);
+	function.variableCount = highestVariableID + 1;
+	function.variableTypes = arenaAlloc(ARENA_CODEGEN, function.variableCount * sizeof(struct IRValueType));
+	memset(function.variableTypes, 0, function.variableCount * sizeof(struct IRValueType));
+
+	return function;
+}
+
+uint64_t irConstantValue(struct IROperand operand) {
+	if (operand.type.type == IR_INTEGER && operand.dataSizeExp < 6) {
+		size_t shift = 64 - (8 << (operand.dataSizeExp - 3));
+		return (uint64_t)((int64_t)(operand.value << shift) >> shift);
+	}
+	return operand.value;
+}
+
+struct IRValueType irOperandType(const struct IRFunction* function, struct IROperand operand) {
+	if (operand.variableID == 0) {
+		return operand.type;
+	}
+	if (irIsStaticVariable(operand.variableID)) {
+		struct IRValueType pointer = {-2, 3}; //statics are only referred to by pointer, their type isnt needed yet
+		return pointer;
+	}
+	return function->variableTypes[operand.variableID];
+}
+
+//fills in the type of every dynamic variable, call results need the output types of every function so this is done last
+void inferVariableTypes(struct IRProgram* program, struct IRFunction* function, const uint32_t* functionIndices, size_t functionIndexCount) {
+	for (uint32_t i = 0; i < function->inputCount; ++i) {
+		function->variableTypes[i + 1] = function->inputTypes[i];
+	}
+
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (uint32_t j = 0; j < block->argumentCount; ++j) {
+			function->variableTypes[block->argumentIDs[j]] = block->argumentTypes[j];
+		}
+
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			if (instruction->resultCount == 0 || instruction->results[0] == 0 || irIsStaticVariable(instruction->results[0])) {
+				continue;
+			}
+
+			struct IRValueType type = {0, 0};
+			if (instruction->ID == IR_DECLARE) {
+				type = instruction->declaredType;
+			} else if (instruction->ID == IR_MOVE) {
+				type = function->variableTypes[instruction->results[0]];
+				if (type.type == 0) {
+					type = irOperandType(function, instruction->operands[0]);
+				}
+			} else if (irIsSpecID(instruction->ID)) {
+				type = irOperandType(function, instruction->operands[0]);
+			} else {
+				//user call, the outputs are in order
+				if (instruction->ID >= functionIndexCount || functionIndices[instruction->ID] == UINT32_MAX) {
+					fprintf(stderr, "ERROR: Call to undefined function %u!\n", instruction->ID);
+					exit(1);
+				}
+				const struct IRFunction* callee = &program->functions[functionIndices[instruction->ID]];
+				if (callee->outputCount != instruction->resultCount) {
+					fprintf(stderr, "ERROR: Call to function %u with the wrong output count!\n", instruction->ID);
+					exit(1);
+				}
+				for (uint32_t k = 0; k < instruction->resultCount; ++k) {
+					if (instruction->results[k] != 0) {
+						function->variableTypes[instruction->results[k]] = callee->outputTypes[k];
+					}
+				}
+				continue;
+			}
+			function->variableTypes[instruction->results[0]] = type;
+		}
+	}
+}
+
+//types of results depend on the functions called, so are only inferred once every function is decoded
+void inferProgramTypes(struct IRProgram* program) {
+	//index of each user function by ID, for looking up callees
+	size_t functionIndexCount = program->functionIDLimit;
+	uint32_t* functionIndices = arenaAlloc(ARENA_CODEGEN, functionIndexCount * sizeof(uint32_t));
+	memset(functionIndices, 0xFF, functionIndexCount * sizeof(uint32_t));
+	for (size_t i = 0; i < program->functionCount; ++i) {
+		functionIndices[program->functions[i].ID] = i;
+	}
+
+	for (size_t i = 0; i < program->functionCount; ++i) {
+		inferVariableTypes(program, &program->functions[i], functionIndices, functionIndexCount);
+	}
+}
+
+struct IRProgram decodeIRProgram(struct BytecodeReader* reader, size_t functionIDLimit) {
+	struct IRProgram program = {0, NULL, functionIDLimit};
+	size_t capacity = 0;
+
+	while (bytecodeHasBytes(reader, 1)) {
+		if (program.functionCount == capacity) {
+			capacity = capacity == 0 ? 16 : capacity * 2;
+			struct IRFunction* grown = arenaAlloc(ARENA_CODEGEN, capacity * sizeof(struct IRFunction));
+			if (program.functionCount != 0) {
+				memcpy(grown, program.functions, program.functionCount * sizeof(struct IRFunction));
+			}
+			program.functions = grown;
+		}
+		program.functions[program.functionCount] = decodeFunction(reader);
+		if (program.functions[program.functionCount].ID >= functionIDLimit) {
+			fprintf(stderr, "ERROR: Definition of function %u, which isnt in the function table!\n", program.functions[program.functionCount].ID);
+			exit(1);
+		}
+		++program.functionCount;
+	}
+
+	inferProgramTypes(&program);
+	return program;
+}
+
+//the definition must be exactly the indexed bytes, and of the indexed function
+struct IRFunction decodeIndexedFunction(const struct BytecodeReader* programLogic, const struct IRFunctionIndex* index, size_t entry) {
+	size_t offset = index->offsets[entry];
+	size_t length = index->lengths[entry];
+	if (offset > programLogic->length || length > programLogic->length - offset) {
+		fprintf(stderr, "ERROR: Function index entry for function %u out of bounds!\n", index->IDs[entry]);
+		exit(1);
+	}
+
+	struct BytecodeReader definition = makeBytecodeReader(programLogic->ptr + offset, length);
+	struct IRFunction function = decodeFunction(&definition);
+	if (function.ID != index->IDs[entry] || bytecodeHasBytes(&definition, 1)) {
+		fprintf(stderr, "ERROR: Function index entry for function %u does not match its definition!\n", index->IDs[entry]);
+		exit(1);
+	}
+	return function;
+}
+
+struct IRProgram decodeIndexedIRProgram(const struct BytecodeReader* programLogic, const struct IRFunctionIndex* index, uint32_t entryID, size_t functionIDLimit) {
+	//entry of each function ID in the index
+	size_t entryCount = functionIDLimit;
+	size_t* entries = arenaAlloc(ARENA_CODEGEN, entryCount * sizeof(size_t));
+	memset(entries, 0xFF, entryCount * sizeof(size_t));
+	for (size_t i = 0; i < index->count; ++i) {
+		if (index->IDs[i] >= entryCount) {
+			fprintf(stderr, "ERROR: Function index entry for function %u, which isnt in the function table!\n", index->IDs[i]);
+			exit(1);
+		}
+		entries[index->IDs[i]] = i;
+	}
+
+	//decoded functions by index entry, then walked from the entry through their calls
+	struct IRFunction* decoded = arenaAlloc(ARENA_CODEGEN, index->count * sizeof(struct IRFunction));
+	bool* isDecoded = arenaAlloc(ARENA_CODEGEN, index->count * sizeof(bool));
+	size_t* worklist = arenaAlloc(ARENA_CODEGEN, index->count * sizeof(size_t));
+	memset(isDecoded, 0, index->count * sizeof(bool));
+	size_t worklistCount = 0;
+	if (entryID < entryCount && entries[entryID] != SIZE_MAX) {
+		worklist[0] = entries[entryID];
+		worklistCount = 1;
+	} else {
+		for (size_t i = 0; i < index->count; ++i) {
+			worklist[i] = index->count - 1 - i;
+		}
+		worklistCount = index->count;
+	}
+	for (size_t i = 0; i < worklistCount; ++i) {
+		isDecoded[worklist[i]] = true;
+	}
+
+	while (worklistCount > 0) {
+		--worklistCount;
+		size_t entry = worklist[worklistCount];
+		decoded[entry] = decodeIndexedFunction(programLogic, index, entry);
+
+		const struct IRFunction* function = &decoded[entry];
+		for (size_t i = 0; i < function->blockCount; ++i) {
+			for (size_t j = 0; j < function->blocks[i].instructionCount; ++j) {
+				uint32_t ID = function->blocks[i].instructions[j].ID;
+				if (irIsSpecID(ID) || ID >= entryCount || entries[ID] == SIZE_MAX || isDecoded[entries[ID]]) {
+					continue;
+				}
+				isDecoded[entries[ID]] = true;
+				worklist[worklistCount] = entries[ID];
+				++worklistCount;
+			}
+		}
+	}
+
+	//the index is in order of definition, so keeping its order keeps the bytecode's
+	struct IRProgram program = {0, NULL, functionIDLimit};
+	program.functions = arenaAlloc(ARENA_CODEGEN, index->count * sizeof(struct IRFunction));
+	for (size_t i = 0; i < index->count; ++i) {
+		if (isDecoded[i]) {
+			program.functions[program.functionCount] = decoded[i];
+			++program.functionCount;
+		}
+	}
+
+	inferProgramTypes(&program);
+	return program;
+}
+
+uint32_t irBlockSuccessors(const struct IRFunction* function, size_t blockIndex, size_t successors[2]) {
+	const struct IRBlock* block = &function->blocks[blockIndex];
+	if (block->instructionCount != 0) {
+		const struct IRInstruction* last = &block->instructions[block->instructionCount - 1];
+		if (irIsTerminator(last->ID)) {
+			for (uint32_t i = 0; i < last->targetCount; ++i) {
+				successors[i] = last->targets[i].block;
+			}
+			return last->targetCount;
+		}
+	}
+
+	if (blockIndex + 1 < function->blockCount) {
+		successors[0] = blockIndex + 1;
+		return 1;
+	}
+	return 0;
+}
+
+bool irIsTailCall(const struct IRFunction* function, size_t blockIndex, size_t instructionIndex) {
+	const struct IRInstruction* call = &function->blocks[blockIndex].instructions[instructionIndex];
+	if (irIsSpecID(call->ID)) {
+		return false;
+	}
+
+	//the values still to be returned, followed through jumps that only pass them on
+	uint32_t valueCount = call->resultCount;
+	const uint32_t* values = call->results;
+	size_t index = instructionIndex + 1;
+	for (size_t steps = 0; steps <= function->blockCount; ++steps) {
+		const struct IRBlock* block = &function->blocks[blockIndex];
+		while (index < block->instructionCount && block->instructions[index].ID == IR_DECLARE) {
+			++index;
+		}
+		if (index >= block->instructionCount) {
+			return false;
+		}
+
+		const struct IRInstruction* next = &block->instructions[index];
+		if (next->ID == IR_RETURN && next->operandCount == 0) {
+			return true;
+		}
+		if ((next->ID != IR_RETURN && next->ID != IR_JUMP) || next->operandCount != valueCount) {
+			return false;
+		}
+		for (uint32_t i = 0; i < valueCount; ++i) {
+			if (values[i] == 0 || next->operands[i].variableID != values[i]) {
+				return false;
+			}
+		}
+		if (next->ID == IR_RETURN) {
+			return true;
+		}
+
+		blockIndex = next->targets[0].block;
+		values = function->blocks[blockIndex].argumentIDs;
+		index = 0;
+	}
+	return false;
+}
\ No newline at end of file
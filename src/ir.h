@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bytecode_gen.h" //for the type IDs
+#include "bytecode_reader.h"
+
+//specification defined instruction IDs, see IR_spec.md
+#define IR_DECLARE ((uint32_t)-1)
+#define IR_MOVE ((uint32_t)-2)
+
+#define IR_RETURN ((uint32_t)-64)
+#define IR_JUMP ((uint32_t)-65)
+#define IR_BRANCH ((uint32_t)-66)
+
+#define IR_ADD ((uint32_t)-128)
+#define IR_SUBTRACT ((uint32_t)-129)
+#define IR_MULTIPLY ((uint32_t)-130)
+#define IR_DIVIDE ((uint32_t)-131)
+#define IR_REMAINDER ((uint32_t)-132)
+
+#define IR_PRINT ((uint32_t)-256)
+
+//every spec ID is within this many of the max
+#define IR_SPEC_ID_RANGE 256
+
+//user IDs grow up from 0 and spec IDs grow down from the max, the top half is treated as spec IDs
+static inline bool irIsSpecID(uint32_t ID) {
+	return ID > UINT32_MAX / 2;
+}
+
+//in memory form of the program logic, decoded from bytecode so passes and the backend can walk it freely
+//everything is allocated in the codegen arena
+
+//type ID and size exponent as in the bytecode, see IR_spec.md
+struct IRValueType {
+	int8_t type;
+	uint8_t sizeExp;
+};
+
+//a variable, or a constant when variableID is 0
+struct IROperand {
+	uint32_t variableID;
+
+	//only for constants
+	struct IRValueType type;
+	uint8_t dataSizeExp; //size of the data in the bytecode, only differs from the type for word sized types
+	uint64_t value;
+};
+
+//a block jumped to, the arguments passed to it are a run of the instruction's operands
+struct IRTarget {
+	size_t block;
+	uint32_t firstArgument; //index into the operands
+	uint32_t argumentCount;
+};
+
+struct IRInstruction {
+	uint32_t ID;
+	struct IRValueType declaredType; //only for declare
+
+	uint32_t resultCount;
+	uint32_t operandCount;
+	uint32_t* results;
+	struct IROperand* operands;
+
+	//only for jumps and branches, a branch goes to the first target when its condition is not 0
+	uint32_t targetCount;
+	struct IRTarget targets[2];
+};
+
+struct IRBlock {
+	uint32_t argumentCount;
+	struct IRValueType* argumentTypes;
+	uint32_t* argumentIDs; //the first block's arguments are the function inputs, the rest are given in the bytecode
+
+	size_t instructionCount;
+	struct IRInstruction* instructions;
+};
+
+struct IRFunction {
+	uint32_t ID;
+
+	uint32_t outputCount;
+	uint32_t inputCount;
+	struct IRValueType* outputTypes;
+	struct IRValueType* inputTypes; //inputs are variables 1 to inputCount
+
+	size_t blockCount;
+	struct IRBlock* blocks;
+
+	uint32_t variableCount; //one more than the highest dynamic variable ID, IDs are unique within the function
+	struct IRValueType* variableTypes; //by variable ID, results take the type of their first operand
+};
+
+struct IRProgram {
+	size_t functionCount;
+	struct IRFunction* functions;
+	size_t functionIDLimit; //every function ID is below this, so lookups by ID can be this long
+};
+
+//reads function definitions from the reader until the end of the bytecode
+//functionIDLimit is the number of user functions in the function table, definitions of other IDs are rejected
+struct IRProgram decodeIRProgram(struct BytecodeReader* reader, size_t functionIDLimit);
+
+//where each function definition is in the program logic, from the optional function index section
+struct IRFunctionIndex {
+	size_t count;
+	uint32_t* IDs;
+	size_t* offsets; //from the start of the program logic
+	size_t* lengths;
+};
+
+//decodes only the functions the entry function can end up calling, each found through the index when first called
+//they keep their order in the bytecode, every function is decoded if the entry isnt in the index
+struct IRProgram decodeIndexedIRProgram(const struct BytecodeReader* programLogic, const struct IRFunctionIndex* index, uint32_t entryID, size_t functionIDLimit);
+
+//static variables share the ID space with dynamic variables, growing down from the max
+static inline bool irIsStaticVariable(uint32_t ID) {
+	return ID > UINT32_MAX / 2;
+}
+
+//constant operand of the given type
+struct IROperand irConstant(struct IRValueType type, uint64_t value);
+//value of a constant operand, signed integers are sign extended to 64 bits
+uint64_t irConstantValue(struct IROperand operand);
+//type of a variable or constant in the function, static variables are pointers
+struct IRValueType irOperandType(const struct IRFunction* function, struct IROperand operand);
+
+//jumps, branches and returns end their block, any other last instruction carries on into the next block
+static inline bool irIsTerminator(uint32_t ID) {
+	return ID == IR_RETURN || ID == IR_JUMP || ID == IR_BRANCH;
+}
+
+//blocks control can go to from the end of the block, returns how many were written to successors
+//a branch to the same block on both edges gives it twice
+uint32_t irBlockSuccessors(const struct IRFunction* function, size_t blockIndex, size_t successors[2]);
+//a call to a user function followed by a return of exactly its results, or a return of nothing
+//jumps passing the results on as a block's arguments are followed to the return, e.g. to a return shared by several blocks
+//nothing is left to do in the caller after such a call, so it can be a jump
+bool irIsTailCall(const struct IRFunction* function, size_t blockIndex, size_t instructionIndex);
\ No newline at end of file
@@ -0,0 +1,220 @@
+#include "ir_inline.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+//blocks of the caller as it is rebuilt, grown in the codegen arena
+struct BlockList {
+	struct IRBlock* blocks;
+	size_t count;
+	size_t capacity;
+};
+
+//variable types of the caller as the callees' variables are added
+struct TypeList {
+	struct IRValueType* types;
+	uint32_t count;
+	uint32_t capacity;
+};
+
+bool canInlineFunction(const struct IRFunction* function) {
+	if (function->blockCount == 0) {
+		return function->outputCount == 0;
+	}
+	const struct IRBlock* last = &function->blocks[function->blockCount - 1];
+	bool fallsOffEnd = last->instructionCount == 0 || !irIsTerminator(last->instructions[last->instructionCount - 1].ID);
+	return !fallsOffEnd || function->outputCount == 0;
+}
+
+struct IRBlock* appendBlock(struct BlockList* list) {
+	if (list->count == list->capacity) {
+		list->capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+		struct IRBlock* grown = arenaAlloc(ARENA_CODEGEN, list->capacity * sizeof(struct IRBlock));
+		if (list->count != 0) {
+			memcpy(grown, list->blocks, list->count * sizeof(struct IRBlock));
+		}
+		list->blocks = grown;
+	}
+	++list->count;
+	return &list->blocks[list->count - 1];
+}
+
+//the ID of a new variable of the type
+uint32_t appendVariable(struct TypeList* list, struct IRValueType type) {
+	if (list->count == list->capacity) {
+		list->capacity *= 2;
+		struct IRValueType* grown = arenaAlloc(ARENA_CODEGEN, list->capacity * sizeof(struct IRValueType));
+		memcpy(grown, list->types, list->count * sizeof(struct IRValueType));
+		list->types = grown;
+	}
+	list->types[list->count] = type;
+	++list->count;
+	return list->count - 1;
+}
+
+struct IRInstruction jumpInstruction(size_t block, struct IROperand* arguments, uint32_t argumentCount) {
+	struct IRInstruction jump;
+	memset(&jump, 0, sizeof(jump));
+	jump.ID = IR_JUMP;
+	jump.operandCount = argumentCount;
+	jump.operands = arguments;
+	jump.targetCount = 1;
+	jump.targets[0].block = block;
+	jump.targets[0].firstArgument = 0;
+	jump.targets[0].argumentCount = argumentCount;
+	return jump;
+}
+
+static inline uint32_t renumberVariable(uint32_t variableID, uint32_t offset) {
+	if (variableID == 0 || irIsStaticVariable(variableID)) {
+		return variableID;
+	}
+	return variableID + offset;
+}
+
+//copy of the instruction with the callee's variables and blocks renumbered, returns become jumps to the block after the call
+struct IRInstruction copyCalleeInstruction(const struct IRInstruction* instruction, uint32_t variableOffset, size_t blockOffset, size_t continuation) {
+	struct IRInstruction copy = *instruction;
+	copy.results = arenaAlloc(ARENA_CODEGEN, instruction->resultCount * sizeof(uint32_t));
+	copy.operands = arenaAlloc(ARENA_CODEGEN, instruction->operandCount * sizeof(struct IROperand));
+	for (uint32_t i = 0; i < instruction->resultCount; ++i) {
+		copy.results[i] = renumberVariable(instruction->results[i], variableOffset);
+	}
+	for (uint32_t i = 0; i < instruction->operandCount; ++i) {
+		copy.operands[i] = instruction->operands[i];
+		copy.operands[i].variableID = renumberVariable(instruction->operands[i].variableID, variableOffset);
+	}
+	for (uint32_t i = 0; i < instruction->targetCount; ++i) {
+		copy.targets[i].block += blockOffset;
+	}
+
+	if (instruction->ID == IR_RETURN) {
+		return jumpInstruction(continuation, copy.operands, copy.operandCount);
+	}
+	return copy;
+}
+
+//appends the callee's blocks, the first is entered with the inputs as its arguments
+void appendCalleeBlocks(struct BlockList* blocks, const struct IRFunction* callee, uint32_t variableOffset, size_t continuation) {
+	size_t blockOffset = blocks->count;
+	for (size_t i = 0; i < callee->blockCount; ++i) {
+		const struct IRBlock* source = &callee->blocks[i];
+
+		//anything after a return is never run
+		size_t instructionCount = source->instructionCount;
+		for (size_t j = 0; j < source->instructionCount; ++j) {
+			if (source->instructions[j].ID == IR_RETURN) {
+				instructionCount = j + 1;
+				break;
+			}
+		}
+		bool fallsOffEnd = i + 1 == callee->blockCount && (instructionCount == 0 || !irIsTerminator(source->instructions[instructionCount - 1].ID));
+
+		struct IRBlock* block = appendBlock(blocks);
+		block->argumentCount = source->argumentCount;
+		block->argumentTypes = source->argumentTypes;
+		block->argumentIDs = arenaAlloc(ARENA_CODEGEN, source->argumentCount * sizeof(uint32_t));
+		for (uint32_t j = 0; j < source->argumentCount; ++j) {
+			block->argumentIDs[j] = renumberVariable(source->argumentIDs[j], variableOffset);
+		}
+		block->instructionCount = instructionCount + fallsOffEnd;
+		block->instructions = arenaAlloc(ARENA_CODEGEN, block->instructionCount * sizeof(struct IRInstruction));
+		for (size_t j = 0; j < instructionCount; ++j) {
+			block->instructions[j] = copyCalleeInstruction(&source->instructions[j], variableOffset, blockOffset, continuation);
+		}
+		if (fallsOffEnd) {
+			block->instructions[instructionCount] = jumpInstruction(continuation, NULL, 0);
+		}
+	}
+}
+
+size_t inlineCalls(struct IRFunction* caller, const struct IRProgram* program, const uint32_t* functionIndices, size_t functionIndexCount, const bool* inlineable) {
+	struct BlockList blocks = {NULL, 0, 0};
+	struct TypeList types;
+	types.capacity = caller->variableCount;
+	types.count = caller->variableCount;
+	types.types = caller->variableTypes;
+
+	//where each of the caller's blocks starts and ends up once split
+	size_t* firstSegments = arenaAlloc(ARENA_CODEGEN, caller->blockCount * sizeof(size_t));
+	size_t* lastSegments = arenaAlloc(ARENA_CODEGEN, caller->blockCount * sizeof(size_t));
+	size_t inlinedCount = 0;
+
+	for (size_t i = 0; i < caller->blockCount; ++i) {
+		const struct IRBlock* source = &caller->blocks[i];
+		firstSegments[i] = blocks.count;
+
+		//the block is cut at each inlined call, every piece after the first takes the call's outputs as arguments
+		struct IRBlock segment = *source;
+		size_t segmentStart = 0;
+		for (size_t j = 0; j < source->instructionCount; ++j) {
+			const struct IRInstruction* call = &source->instructions[j];
+			if (irIsSpecID(call->ID) || call->ID >= functionIndexCount || functionIndices[call->ID] == UINT32_MAX) {
+				continue;
+			}
+			uint32_t calleeIndex = functionIndices[call->ID];
+			const struct IRFunction* callee = &program->functions[calleeIndex];
+			if (!inlineable[calleeIndex] || callee == caller) {
+				continue;
+			}
+
+			//the piece before the call jumps into the callee's first block, which comes straight after it
+			size_t entry = blocks.count + 1;
+			segment.instructionCount = j - segmentStart + 1;
+			segment.instructions = arenaAlloc(ARENA_CODEGEN, segment.instructionCount * sizeof(struct IRInstruction));
+			memcpy(segment.instructions, source->instructions + segmentStart, (j - segmentStart) * sizeof(struct IRInstruction));
+			segment.instructions[j - segmentStart] = jumpInstruction(entry, call->operands, call->operandCount);
+			*appendBlock(&blocks) = segment;
+
+			uint32_t variableOffset = types.count - 1;
+			for (uint32_t k = 1; k < callee->variableCount; ++k) {
+				appendVariable(&types, callee->variableTypes[k]);
+			}
+			size_t continuation = entry + callee->blockCount;
+			appendCalleeBlocks(&blocks, callee, variableOffset, continuation);
+
+			//discarded outputs still need a variable to arrive in
+			segment.argumentCount = callee->outputCount;
+			segment.argumentTypes = callee->outputTypes;
+			segment.argumentIDs = arenaAlloc(ARENA_CODEGEN, callee->outputCount * sizeof(uint32_t));
+			for (uint32_t k = 0; k < callee->outputCount; ++k) {
+				segment.argumentIDs[k] = call->results[k] != 0 ? call->results[k] : appendVariable(&types, callee->outputTypes[k]);
+			}
+			segmentStart = j + 1;
+			++inlinedCount;
+		}
+
+		segment.instructionCount = source->instructionCount - segmentStart;
+		segment.instructions = source->instructions + segmentStart;
+		lastSegments[i] = blocks.count;
+		*appendBlock(&blocks) = segment;
+	}
+
+	if (inlinedCount == 0) {
+		return 0;
+	}
+
+	//the caller's own jumps are all in the last piece of their block, and still go to the old block indices
+	for (size_t i = 0; i < caller->blockCount; ++i) {
+		struct IRBlock* block = &blocks.blocks[lastSegments[i]];
+		if (block->instructionCount == 0) {
+			continue;
+		}
+		struct IRInstruction* jump = &block->instructions[block->instructionCount - 1];
+		for (uint32_t j = 0; j < jump->targetCount; ++j) {
+			jump->targets[j].block = firstSegments[jump->targets[j].block];
+		}
+	}
+
+	caller->blocks = blocks.blocks;
+	caller->blockCount = blocks.count;
+	caller->variableTypes = types.types;
+	caller->variableCount = types.count;
+	return inlinedCount;
+}
\ No newline at end of file
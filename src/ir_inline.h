@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ir.h"
+
+//whether a function's body can be copied into its callers, it has to end every path with a return unless it has no outputs
+bool canInlineFunction(const struct IRFunction* function);
+
+//replaces every call in caller to a function whose index in program is marked in inlineable with a copy of its body
+//the call's block is split around the copy, the inputs and outputs are passed as block arguments and the callee's variables and blocks are renumbered after the caller's
+//functionIndices maps IDs to indices in program, UINT32_MAX for IDs without a function, returns the number of calls inlined
+size_t inlineCalls(struct IRFunction* caller, const struct IRProgram* program, const uint32_t* functionIndices, size_t functionIndexCount, const bool* inlineable);
\ No newline at end of file
@@ -0,0 +1,1106 @@
+#include "ir_passes.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "ir_inline.h"
+
+static FILE* passReport = NULL;
+static size_t inlineThreshold = 16;
+
+void setIRPassReport(FILE* report) {
+	passReport = report;
+}
+
+void setIRInlineThreshold(size_t threshold) {
+	inlineThreshold = threshold;
+}
+
+size_t countInstructions(const struct IRFunction* function) {
+	size_t count = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		count += function->blocks[i].instructionCount;
+	}
+	return count;
+}
+
+static inline bool isDynamicVariable(uint32_t variableID) {
+	return variableID != 0 && !irIsStaticVariable(variableID);
+}
+
+static inline bool sameType(struct IRValueType a, struct IRValueType b) {
+	return a.type == b.type && a.sizeExp == b.sizeExp;
+}
+
+//instructions that do something other than define their results
+bool hasSideEffects(const struct IRInstruction* instruction) {
+	switch (instruction->ID) {
+		case IR_DECLARE:
+		case IR_MOVE:
+		case IR_ADD:
+		case IR_SUBTRACT:
+		case IR_MULTIPLY:
+		case IR_DIVIDE:
+		case IR_REMAINDER:
+		return false;
+
+		//print, return and user calls, which could do anything
+		default: return true;
+	}
+}
+
+//number of times each variable is defined, inputs and block arguments included
+uint32_t* countDefinitions(const struct IRFunction* function) {
+	uint32_t* definitions = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(uint32_t));
+	memset(definitions, 0, function->variableCount * sizeof(uint32_t));
+
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (uint32_t j = 0; j < block->argumentCount; ++j) {
+			++definitions[block->argumentIDs[j]];
+		}
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			if (instruction->ID == IR_DECLARE) {
+				continue;
+			}
+			for (uint32_t k = 0; k < instruction->resultCount; ++k) {
+				if (isDynamicVariable(instruction->results[k])) {
+					++definitions[instruction->results[k]];
+				}
+			}
+		}
+	}
+	return definitions;
+}
+
+//removes the instructions marked in removed, keeping the order of the rest
+void compactBlock(struct IRBlock* block, const bool* removed) {
+	size_t kept = 0;
+	for (size_t i = 0; i < block->instructionCount; ++i) {
+		if (!removed[i]) {
+			block->instructions[kept] = block->instructions[i];
+			++kept;
+		}
+	}
+	block->instructionCount = kept;
+}
+
+//follows replaced variables until a value that isnt replaced
+struct IROperand resolveReplacement(const struct IROperand* replacements, const bool* isReplaced, struct IROperand operand) {
+	while (isDynamicVariable(operand.variableID) && isReplaced[operand.variableID]) {
+		operand = replacements[operand.variableID];
+	}
+	return operand;
+}
+
+void propagateCopies(struct IRFunction* function) {
+	uint32_t* definitions = countDefinitions(function);
+	struct IROperand* copies = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(struct IROperand));
+	bool* isCopy = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(bool));
+	memset(isCopy, 0, function->variableCount * sizeof(bool));
+
+	//a move is a copy if its the only definition of the destination, and doesnt change the type
+	//blocks can jump backwards so every copy is found before any use is replaced
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			if (instruction->ID != IR_MOVE) {
+				continue;
+			}
+			uint32_t destination = instruction->results[0];
+			if (!isDynamicVariable(destination) || definitions[destination] != 1) {
+				continue;
+			}
+			struct IROperand source = instruction->operands[0];
+			if (!sameType(irOperandType(function, source), function->variableTypes[destination])) {
+				continue;
+			}
+			copies[destination] = source;
+			isCopy[destination] = true;
+		}
+	}
+
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		bool* removed = arenaAlloc(ARENA_CODEGEN, block->instructionCount * sizeof(bool));
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			struct IRInstruction* instruction = &block->instructions[j];
+			removed[j] = instruction->ID == IR_MOVE && isDynamicVariable(instruction->results[0]) && isCopy[instruction->results[0]];
+			for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+				instruction->operands[k] = resolveReplacement(copies, isCopy, instruction->operands[k]);
+			}
+		}
+		compactBlock(block, removed);
+	}
+}
+
+//blocks reachable from the entry stay, in the same order so blocks carrying on into the next still do
+//a block that carries on into an unreachable one is unreachable itself
+void removeUnreachableBlocks(struct IRFunction* function) {
+	size_t blockCount = function->blockCount;
+	if (blockCount == 0) {
+		return;
+	}
+	size_t* newIndices = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	size_t* stack = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	for (size_t i = 0; i < blockCount; ++i) {
+		newIndices[i] = SIZE_MAX;
+	}
+	newIndices[0] = 0;
+	stack[0] = 0;
+	size_t stackCount = 1;
+	while (stackCount > 0) {
+		--stackCount;
+		size_t successors[2];
+		uint32_t successorCount = irBlockSuccessors(function, stack[stackCount], successors);
+		for (uint32_t i = 0; i < successorCount; ++i) {
+			if (newIndices[successors[i]] == SIZE_MAX) {
+				newIndices[successors[i]] = 0;
+				stack[stackCount] = successors[i];
+				++stackCount;
+			}
+		}
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < blockCount; ++i) {
+		if (newIndices[i] != SIZE_MAX) {
+			newIndices[i] = kept;
+			function->blocks[kept] = function->blocks[i];
+			++kept;
+		}
+	}
+	function->blockCount = kept;
+	for (size_t i = 0; i < kept; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		if (block->instructionCount == 0) {
+			continue;
+		}
+		struct IRInstruction* jump = &block->instructions[block->instructionCount - 1];
+		for (uint32_t j = 0; j < jump->targetCount; ++j) {
+			jump->targets[j].block = newIndices[jump->targets[j].block];
+		}
+	}
+}
+
+void mergeBlocks(struct IRFunction* function) {
+	size_t blockCount = function->blockCount;
+	uint32_t* predecessorCounts = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(uint32_t));
+	memset(predecessorCounts, 0, blockCount * sizeof(uint32_t));
+	for (size_t i = 0; i < blockCount; ++i) {
+		size_t successors[2];
+		uint32_t successorCount = irBlockSuccessors(function, i, successors);
+		for (uint32_t j = 0; j < successorCount; ++j) {
+			++predecessorCounts[successors[j]];
+		}
+	}
+
+	struct IROperand* replacements = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(struct IROperand));
+	bool* isReplaced = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(bool));
+	memset(isReplaced, 0, function->variableCount * sizeof(bool));
+	bool merged = false;
+
+	for (size_t i = 0; i < blockCount; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		while (block->instructionCount != 0) {
+			const struct IRInstruction* jump = &block->instructions[block->instructionCount - 1];
+			if (jump->ID != IR_JUMP) {
+				break;
+			}
+			size_t successorIndex = jump->targets[0].block;
+			struct IRBlock* successor = &function->blocks[successorIndex];
+
+			//the entry block is also entered by the call, and the last block can return by falling off the end
+			bool fallsOffEnd = successorIndex + 1 == blockCount && (successor->instructionCount == 0 || !irIsTerminator(successor->instructions[successor->instructionCount - 1].ID));
+			if (successorIndex == i || successorIndex == 0 || predecessorCounts[successorIndex] != 1 || fallsOffEnd) {
+				break;
+			}
+
+			//the arguments are whatever the jump passed, values of another type are moved in so uses keep the argument's type
+			uint32_t moveCount = 0;
+			for (uint32_t j = 0; j < successor->argumentCount; ++j) {
+				if (sameType(irOperandType(function, jump->operands[j]), successor->argumentTypes[j])) {
+					replacements[successor->argumentIDs[j]] = jump->operands[j];
+					isReplaced[successor->argumentIDs[j]] = true;
+				} else {
+					++moveCount;
+				}
+			}
+
+			//a successor carrying on into the next block now needs to jump there
+			bool carriesOn = successor->instructionCount == 0 || !irIsTerminator(successor->instructions[successor->instructionCount - 1].ID);
+			size_t instructionCount = block->instructionCount - 1 + moveCount + successor->instructionCount + carriesOn;
+			struct IRInstruction* instructions = arenaAlloc(ARENA_CODEGEN, instructionCount * sizeof(struct IRInstruction));
+			memcpy(instructions, block->instructions, (block->instructionCount - 1) * sizeof(struct IRInstruction));
+			struct IRInstruction* move = instructions + block->instructionCount - 1;
+			for (uint32_t j = 0; j < successor->argumentCount; ++j) {
+				if (isReplaced[successor->argumentIDs[j]]) {
+					continue;
+				}
+				memset(move, 0, sizeof(struct IRInstruction));
+				move->ID = IR_MOVE;
+				move->resultCount = 1;
+				move->operandCount = 1;
+				move->results = &successor->argumentIDs[j];
+				move->operands = &jump->operands[j];
+				++move;
+			}
+			memcpy(move, successor->instructions, successor->instructionCount * sizeof(struct IRInstruction));
+			if (carriesOn) {
+				struct IRInstruction* next = &instructions[instructionCount - 1];
+				memset(next, 0, sizeof(struct IRInstruction));
+				next->ID = IR_JUMP;
+				next->targetCount = 1;
+				next->targets[0].block = successorIndex + 1;
+			}
+			block->instructions = instructions;
+			block->instructionCount = instructionCount;
+
+			//left with no predecessors, and so removed below
+			successor->instructionCount = 0;
+			successor->argumentCount = 0;
+			predecessorCounts[successorIndex] = 0;
+			merged = true;
+		}
+	}
+
+	if (!merged) {
+		return;
+	}
+	for (size_t i = 0; i < blockCount; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			struct IRInstruction* instruction = &block->instructions[j];
+			for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+				instruction->operands[k] = resolveReplacement(replacements, isReplaced, instruction->operands[k]);
+			}
+		}
+	}
+	removeUnreachableBlocks(function);
+}
+
+//control flow of a function, blocks are indexed as in the function
+struct ControlFlow {
+	size_t* predecessorStarts; //predecessors of block i are predecessors[predecessorStarts[i]] up to the next block's start
+	size_t* predecessors;
+
+	size_t* order; //reachable blocks in reverse postorder
+	size_t orderCount;
+	size_t* orderIndices; //position of each block in order, BLOCK_NONE when unreachable
+	size_t* dominators; //immediate dominator of each block, the entry block is its own
+};
+
+#define BLOCK_NONE SIZE_MAX
+
+//finger walk from Cooper, Harvey and Kennedy's "A Simple, Fast Dominance Algorithm"
+size_t commonDominator(const struct ControlFlow* flow, size_t a, size_t b) {
+	while (a != b) {
+		while (flow->orderIndices[a] > flow->orderIndices[b]) {
+			a = flow->dominators[a];
+		}
+		while (flow->orderIndices[b] > flow->orderIndices[a]) {
+			b = flow->dominators[b];
+		}
+	}
+	return a;
+}
+
+struct ControlFlow analyseControlFlow(const struct IRFunction* function) {
+	size_t blockCount = function->blockCount;
+	struct ControlFlow flow;
+	flow.predecessorStarts = arenaAlloc(ARENA_CODEGEN, (blockCount + 1) * sizeof(size_t));
+	flow.order = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	flow.orderCount = 0;
+	flow.orderIndices = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	flow.dominators = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+
+	//predecessors are counted first, then placed
+	memset(flow.predecessorStarts, 0, (blockCount + 1) * sizeof(size_t));
+	for (size_t i = 0; i < blockCount; ++i) {
+		size_t successors[2];
+		uint32_t successorCount = irBlockSuccessors(function, i, successors);
+		for (uint32_t j = 0; j < successorCount; ++j) {
+			++flow.predecessorStarts[successors[j] + 1];
+		}
+	}
+	for (size_t i = 0; i < blockCount; ++i) {
+		flow.predecessorStarts[i + 1] += flow.predecessorStarts[i];
+	}
+	flow.predecessors = arenaAlloc(ARENA_CODEGEN, flow.predecessorStarts[blockCount] * sizeof(size_t));
+	size_t* placed = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	memcpy(placed, flow.predecessorStarts, blockCount * sizeof(size_t));
+	for (size_t i = 0; i < blockCount; ++i) {
+		size_t successors[2];
+		uint32_t successorCount = irBlockSuccessors(function, i, successors);
+		for (uint32_t j = 0; j < successorCount; ++j) {
+			flow.predecessors[placed[successors[j]]] = i;
+			++placed[successors[j]];
+		}
+	}
+
+	//depth first from the entry block, blocks are added to the order once all their successors are visited
+	for (size_t i = 0; i < blockCount; ++i) {
+		flow.orderIndices[i] = BLOCK_NONE;
+		flow.dominators[i] = BLOCK_NONE;
+	}
+	if (blockCount == 0) {
+		return flow;
+	}
+	size_t* stack = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	uint32_t* nextSuccessor = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(uint32_t));
+	bool* visited = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(bool));
+	memset(visited, 0, blockCount * sizeof(bool));
+	size_t stackCount = 1;
+	stack[0] = 0;
+	nextSuccessor[0] = 0;
+	visited[0] = true;
+	size_t postorderCount = 0;
+	while (stackCount > 0) {
+		size_t block = stack[stackCount - 1];
+		size_t successors[2];
+		uint32_t successorCount = irBlockSuccessors(function, block, successors);
+		if (nextSuccessor[block] < successorCount) {
+			size_t successor = successors[nextSuccessor[block]];
+			++nextSuccessor[block];
+			if (!visited[successor]) {
+				visited[successor] = true;
+				nextSuccessor[successor] = 0;
+				stack[stackCount] = successor;
+				++stackCount;
+			}
+			continue;
+		}
+		--stackCount;
+		flow.order[postorderCount] = block;
+		++postorderCount;
+	}
+	flow.orderCount = postorderCount;
+	for (size_t i = 0; i < postorderCount / 2; ++i) {
+		size_t swap = flow.order[i];
+		flow.order[i] = flow.order[postorderCount - 1 - i];
+		flow.order[postorderCount - 1 - i] = swap;
+	}
+	for (size_t i = 0; i < postorderCount; ++i) {
+		flow.orderIndices[flow.order[i]] = i;
+	}
+
+	//immediate dominators, repeated until nothing changes as loops are seen before their back edges
+	flow.dominators[0] = 0;
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (size_t i = 1; i < flow.orderCount; ++i) {
+			size_t block = flow.order[i];
+			size_t dominator = BLOCK_NONE;
+			for (size_t j = flow.predecessorStarts[block]; j < flow.predecessorStarts[block + 1]; ++j) {
+				size_t predecessor = flow.predecessors[j];
+				if (flow.dominators[predecessor] == BLOCK_NONE) {
+					continue;
+				}
+				dominator = dominator == BLOCK_NONE ? predecessor : commonDominator(&flow, predecessor, dominator);
+			}
+			if (flow.dominators[block] != dominator) {
+				flow.dominators[block] = dominator;
+				changed = true;
+			}
+		}
+	}
+	return flow;
+}
+
+//whether every path from the entry to b goes through a first, a block doesnt strictly dominate itself
+bool strictlyDominates(const struct ControlFlow* flow, size_t a, size_t b) {
+	if (flow->dominators[b] == BLOCK_NONE) {
+		return false;
+	}
+	while (b != 0) {
+		b = flow->dominators[b];
+		if (b == a) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline bool sameOperand(struct IROperand a, struct IROperand b) {
+	if (a.variableID != b.variableID) {
+		return false;
+	}
+	return a.variableID != 0 || (sameType(a.type, b.type) && a.value == b.value);
+}
+
+//a computation, equal expressions in blocks that dominate each other give the same value
+struct ValueKey {
+	uint32_t ID;
+	struct IRValueType type; //of the result, e.g. moves that only change the type
+	uint32_t operandCount;
+	struct IROperand operands[2];
+};
+
+struct ValueEntry {
+	struct ValueKey key;
+	uint32_t variableID;
+	size_t next; //in the bucket, BLOCK_NONE at the end
+};
+
+//chained hash of the expressions available in the current block
+//entries are only ever added on top and removed from the top when leaving a block, so a bucket's head is always its newest entry
+struct ValueTable {
+	size_t* buckets;
+	size_t bucketMask;
+	struct ValueEntry* entries;
+	size_t entryCount;
+};
+
+static inline bool isCommutative(uint32_t ID) {
+	return ID == IR_ADD || ID == IR_MULTIPLY;
+}
+
+size_t hashValueKey(const struct ValueKey* key) {
+	uint64_t hash = 0xcbf29ce484222325 ^ key->ID;
+	hash = (hash ^ ((uint64_t)(uint8_t)key->type.type << 8 | key->type.sizeExp)) * 0x100000001b3;
+	for (uint32_t i = 0; i < key->operandCount; ++i) {
+		const struct IROperand* operand = &key->operands[i];
+		hash = (hash ^ operand->variableID) * 0x100000001b3;
+		if (operand->variableID == 0) {
+			hash = (hash ^ operand->value) * 0x100000001b3;
+		}
+	}
+	return hash ^ (hash >> 29);
+}
+
+bool sameValueKey(const struct ValueKey* a, const struct ValueKey* b) {
+	if (a->ID != b->ID || !sameType(a->type, b->type) || a->operandCount != b->operandCount) {
+		return false;
+	}
+	for (uint32_t i = 0; i < a->operandCount; ++i) {
+		if (!sameOperand(a->operands[i], b->operands[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//the variable already holding the value, or 0 once its added as held by variableID
+uint32_t findOrAddValue(struct ValueTable* table, const struct ValueKey* key, uint32_t variableID) {
+	size_t bucket = hashValueKey(key) & table->bucketMask;
+	for (size_t i = table->buckets[bucket]; i != BLOCK_NONE; i = table->entries[i].next) {
+		if (sameValueKey(&table->entries[i].key, key)) {
+			return table->entries[i].variableID;
+		}
+	}
+
+	struct ValueEntry* entry = &table->entries[table->entryCount];
+	entry->key = *key;
+	entry->variableID = variableID;
+	entry->next = table->buckets[bucket];
+	table->buckets[bucket] = table->entryCount;
+	++table->entryCount;
+	return 0;
+}
+
+//drops the entries added since the table had entryCount entries
+void truncateValueTable(struct ValueTable* table, size_t entryCount) {
+	while (table->entryCount > entryCount) {
+		--table->entryCount;
+		const struct ValueEntry* entry = &table->entries[table->entryCount];
+		table->buckets[hashValueKey(&entry->key) & table->bucketMask] = entry->next;
+	}
+}
+
+//the value every jump to the block passes for the argument, ignoring jumps passing the argument back to itself
+//false if they disagree or the value isnt available in the block
+bool agreedArgument(const struct IRFunction* function, const struct ControlFlow* flow, const size_t* definitionBlocks, const struct IROperand* replacements, const bool* isReplaced, size_t blockIndex, uint32_t argumentIndex, struct IROperand* agreed) {
+	const struct IRBlock* block = &function->blocks[blockIndex];
+	uint32_t argumentID = block->argumentIDs[argumentIndex];
+	bool found = false;
+
+	for (size_t i = flow->predecessorStarts[blockIndex]; i < flow->predecessorStarts[blockIndex + 1]; ++i) {
+		size_t predecessor = flow->predecessors[i];
+		if (flow->orderIndices[predecessor] == BLOCK_NONE) {
+			continue; //never taken
+		}
+		const struct IRBlock* predecessorBlock = &function->blocks[predecessor];
+		const struct IRInstruction* jump = &predecessorBlock->instructions[predecessorBlock->instructionCount - 1];
+		for (uint32_t j = 0; j < jump->targetCount; ++j) {
+			if (jump->targets[j].block != blockIndex) {
+				continue;
+			}
+			struct IROperand value = resolveReplacement(replacements, isReplaced, jump->operands[jump->targets[j].firstArgument + argumentIndex]);
+			if (value.variableID == argumentID) {
+				continue;
+			}
+			if (found && !sameOperand(value, *agreed)) {
+				return false;
+			}
+			*agreed = value;
+			found = true;
+		}
+	}
+
+	if (!found || !sameType(irOperandType(function, *agreed), block->argumentTypes[argumentIndex])) {
+		return false;
+	}
+	if (agreed->variableID == 0 || irIsStaticVariable(agreed->variableID)) {
+		return true;
+	}
+	return strictlyDominates(flow, definitionBlocks[agreed->variableID], blockIndex);
+}
+
+//one walk down the dominator tree, returns whether anything was replaced
+bool numberValues(struct IRFunction* function, const struct ControlFlow* flow, struct IROperand* replacements, bool* isReplaced) {
+	uint32_t* definitions = countDefinitions(function);
+	size_t blockCount = function->blockCount;
+
+	//block each variable is defined in
+	size_t* definitionBlocks = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(size_t));
+	size_t pureCount = 0;
+	for (size_t i = 0; i < blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (uint32_t j = 0; j < block->argumentCount; ++j) {
+			definitionBlocks[block->argumentIDs[j]] = i;
+		}
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			for (uint32_t k = 0; k < instruction->resultCount; ++k) {
+				if (isDynamicVariable(instruction->results[k])) {
+					definitionBlocks[instruction->results[k]] = i;
+				}
+			}
+			pureCount += !hasSideEffects(instruction);
+		}
+	}
+
+	//children in the dominator tree
+	size_t* childStarts = arenaAlloc(ARENA_CODEGEN, (blockCount + 1) * sizeof(size_t));
+	memset(childStarts, 0, (blockCount + 1) * sizeof(size_t));
+	for (size_t i = 1; i < flow->orderCount; ++i) {
+		++childStarts[flow->dominators[flow->order[i]] + 1];
+	}
+	for (size_t i = 0; i < blockCount; ++i) {
+		childStarts[i + 1] += childStarts[i];
+	}
+	size_t* children = arenaAlloc(ARENA_CODEGEN, childStarts[blockCount] * sizeof(size_t));
+	size_t* placed = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	memcpy(placed, childStarts, blockCount * sizeof(size_t));
+	for (size_t i = 1; i < flow->orderCount; ++i) {
+		size_t dominator = flow->dominators[flow->order[i]];
+		children[placed[dominator]] = flow->order[i];
+		++placed[dominator];
+	}
+
+	struct ValueTable table;
+	size_t bucketCount = 16;
+	while (bucketCount < 2 * pureCount) {
+		bucketCount *= 2;
+	}
+	table.buckets = arenaAlloc(ARENA_CODEGEN, bucketCount * sizeof(size_t));
+	memset(table.buckets, 0xFF, bucketCount * sizeof(size_t));
+	table.bucketMask = bucketCount - 1;
+	table.entries = arenaAlloc(ARENA_CODEGEN, pureCount * sizeof(struct ValueEntry));
+	table.entryCount = 0;
+
+	//preorder walk, each block is on the stack with the table size to go back to once its children are done
+	size_t* stack = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	size_t* entryCounts = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	size_t* nextChild = arenaAlloc(ARENA_CODEGEN, blockCount * sizeof(size_t));
+	size_t stackCount = 0;
+	bool changed = false;
+	if (blockCount != 0) {
+		stack[0] = 0;
+		stackCount = 1;
+		nextChild[0] = BLOCK_NONE;
+	}
+	while (stackCount > 0) {
+		size_t blockIndex = stack[stackCount - 1];
+		struct IRBlock* block = &function->blocks[blockIndex];
+
+		//first visit, number the block
+		if (nextChild[blockIndex] == BLOCK_NONE) {
+			entryCounts[blockIndex] = table.entryCount;
+			nextChild[blockIndex] = childStarts[blockIndex];
+
+			for (uint32_t i = 0; blockIndex != 0 && i < block->argumentCount; ++i) {
+				uint32_t argumentID = block->argumentIDs[i];
+				struct IROperand agreed;
+				if (!isReplaced[argumentID] && agreedArgument(function, flow, definitionBlocks, replacements, isReplaced, blockIndex, i, &agreed)) {
+					replacements[argumentID] = agreed;
+					isReplaced[argumentID] = true;
+					changed = true;
+				}
+			}
+
+			bool* removed = arenaAlloc(ARENA_CODEGEN, block->instructionCount * sizeof(bool));
+			for (size_t i = 0; i < block->instructionCount; ++i) {
+				struct IRInstruction* instruction = &block->instructions[i];
+				removed[i] = false;
+				for (uint32_t j = 0; j < instruction->operandCount; ++j) {
+					instruction->operands[j] = resolveReplacement(replacements, isReplaced, instruction->operands[j]);
+				}
+
+				uint32_t result = instruction->resultCount == 0 ? 0 : instruction->results[0];
+				if (instruction->ID == IR_DECLARE || hasSideEffects(instruction) || !isDynamicVariable(result) || definitions[result] != 1) {
+					continue;
+				}
+
+				struct ValueKey key;
+				memset(&key, 0, sizeof(key));
+				key.ID = instruction->ID;
+				key.type = function->variableTypes[result];
+				key.operandCount = instruction->operandCount;
+				for (uint32_t j = 0; j < instruction->operandCount; ++j) {
+					key.operands[j] = instruction->operands[j];
+					key.operands[j].dataSizeExp = 0;
+				}
+				//operands of commutative operations are ordered so both orders are found
+				if (isCommutative(key.ID) && (key.operands[0].variableID < key.operands[1].variableID || (key.operands[0].variableID == key.operands[1].variableID && key.operands[0].value < key.operands[1].value))) {
+					struct IROperand swap = key.operands[0];
+					key.operands[0] = key.operands[1];
+					key.operands[1] = swap;
+				}
+
+				uint32_t existing = findOrAddValue(&table, &key, result);
+				if (existing != 0) {
+					struct IROperand value = {existing, {0, 0}, 0, 0};
+					replacements[result] = value;
+					isReplaced[result] = true;
+					removed[i] = true;
+					changed = true;
+				}
+			}
+			compactBlock(block, removed);
+		}
+
+		if (nextChild[blockIndex] < childStarts[blockIndex + 1]) {
+			size_t child = children[nextChild[blockIndex]];
+			++nextChild[blockIndex];
+			nextChild[child] = BLOCK_NONE;
+			stack[stackCount] = child;
+			++stackCount;
+			continue;
+		}
+
+		truncateValueTable(&table, entryCounts[blockIndex]);
+		--stackCount;
+	}
+
+	//uses on back edges and in unreachable blocks are seen before or without their replacements
+	for (size_t i = 0; i < blockCount; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			struct IRInstruction* instruction = &block->instructions[j];
+			for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+				instruction->operands[k] = resolveReplacement(replacements, isReplaced, instruction->operands[k]);
+			}
+		}
+	}
+	return changed;
+}
+
+void numberGlobalValues(struct IRFunction* function) {
+	struct ControlFlow flow = analyseControlFlow(function);
+	struct IROperand* replacements = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(struct IROperand));
+	bool* isReplaced = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(bool));
+	memset(isReplaced, 0, function->variableCount * sizeof(bool));
+
+	//arguments found to be equal to a value let more expressions match, which is only seen by another walk
+	while (numberValues(function, &flow, replacements, isReplaced)) {
+	}
+}
+
+//times the argument is passed back to itself by jumps to its block, e.g. a value carried unchanged around a loop
+uint32_t countSelfArguments(const struct IRFunction* function, size_t blockIndex, uint32_t argumentIndex) {
+	uint32_t argumentID = function->blocks[blockIndex].argumentIDs[argumentIndex];
+	uint32_t count = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		if (block->instructionCount == 0) {
+			continue;
+		}
+		const struct IRInstruction* jump = &block->instructions[block->instructionCount - 1];
+		for (uint32_t j = 0; j < jump->targetCount; ++j) {
+			if (jump->targets[j].block == blockIndex && jump->operands[jump->targets[j].firstArgument + argumentIndex].variableID == argumentID) {
+				++count;
+			}
+		}
+	}
+	return count;
+}
+
+//removes the argument from the block and every jump to it, uses of the values the jumps passed are dropped
+void removeBlockArgument(struct IRFunction* function, size_t blockIndex, uint32_t argumentIndex, uint32_t* uses) {
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		if (block->instructionCount == 0) {
+			continue;
+		}
+		struct IRInstruction* jump = &block->instructions[block->instructionCount - 1];
+		for (uint32_t j = 0; j < jump->targetCount; ++j) {
+			if (jump->targets[j].block != blockIndex) {
+				continue;
+			}
+			uint32_t operandIndex = jump->targets[j].firstArgument + argumentIndex;
+			if (isDynamicVariable(jump->operands[operandIndex].variableID)) {
+				--uses[jump->operands[operandIndex].variableID];
+			}
+			memmove(jump->operands + operandIndex, jump->operands + operandIndex + 1, (jump->operandCount - operandIndex - 1) * sizeof(struct IROperand));
+			--jump->operandCount;
+			--jump->targets[j].argumentCount;
+			for (uint32_t k = 0; k < jump->targetCount; ++k) {
+				if (jump->targets[k].firstArgument > operandIndex) {
+					--jump->targets[k].firstArgument;
+				}
+			}
+		}
+	}
+
+	struct IRBlock* block = &function->blocks[blockIndex];
+	uint32_t after = block->argumentCount - argumentIndex - 1;
+	memmove(block->argumentIDs + argumentIndex, block->argumentIDs + argumentIndex + 1, after * sizeof(uint32_t));
+	memmove(block->argumentTypes + argumentIndex, block->argumentTypes + argumentIndex + 1, after * sizeof(struct IRValueType));
+	--block->argumentCount;
+}
+
+void eliminateDeadCode(struct IRFunction* function) {
+	uint32_t* uses = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(uint32_t));
+	memset(uses, 0, function->variableCount * sizeof(uint32_t));
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+				if (isDynamicVariable(instruction->operands[k].variableID)) {
+					++uses[instruction->operands[k].variableID];
+				}
+			}
+		}
+	}
+
+	//backwards so uses are removed before their definitions are looked at
+	//repeated until nothing changes, as jumps back to earlier blocks can use later definitions
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (size_t i = function->blockCount; i > 0; --i) {
+			struct IRBlock* block = &function->blocks[i - 1];
+			bool* removed = arenaAlloc(ARENA_CODEGEN, block->instructionCount * sizeof(bool));
+			bool removedAny = false;
+
+			for (size_t j = block->instructionCount; j > 0; --j) {
+				const struct IRInstruction* instruction = &block->instructions[j - 1];
+				removed[j - 1] = false;
+				if (hasSideEffects(instruction)) {
+					continue;
+				}
+
+				bool used = false;
+				for (uint32_t k = 0; k < instruction->resultCount; ++k) {
+					uint32_t result = instruction->results[k];
+					used = used || (isDynamicVariable(result) && uses[result] != 0) || irIsStaticVariable(result);
+				}
+				if (used) {
+					continue;
+				}
+
+				removed[j - 1] = true;
+				removedAny = true;
+				if (instruction->ID == IR_DECLARE) {
+					continue;
+				}
+				for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+					if (isDynamicVariable(instruction->operands[k].variableID)) {
+						--uses[instruction->operands[k].variableID];
+					}
+				}
+			}
+
+			if (removedAny) {
+				compactBlock(block, removed);
+				changed = true;
+			}
+		}
+
+		//arguments of blocks after the first can go too, the first block's are the function inputs
+		for (size_t i = 1; i < function->blockCount; ++i) {
+			for (uint32_t j = function->blocks[i].argumentCount; j > 0; --j) {
+				uint32_t argumentID = function->blocks[i].argumentIDs[j - 1];
+				if (uses[argumentID] == countSelfArguments(function, i, j - 1)) {
+					removeBlockArgument(function, i, j - 1, uses);
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
+//puts a move before the call for each argument whose type differs from its input, the call is then passed the moved values
+struct IRInstruction* convertTailCallArguments(struct IRFunction* function, struct IRBlock* block, size_t callIndex, uint32_t moveCount) {
+	struct IRValueType* variableTypes = arenaAlloc(ARENA_CODEGEN, (function->variableCount + moveCount) * sizeof(struct IRValueType));
+	memcpy(variableTypes, function->variableTypes, function->variableCount * sizeof(struct IRValueType));
+	function->variableTypes = variableTypes;
+
+	size_t instructionCount = block->instructionCount + moveCount;
+	struct IRInstruction* instructions = arenaAlloc(ARENA_CODEGEN, instructionCount * sizeof(struct IRInstruction));
+	memcpy(instructions, block->instructions, callIndex * sizeof(struct IRInstruction));
+	memcpy(instructions + callIndex + moveCount, block->instructions + callIndex, (block->instructionCount - callIndex) * sizeof(struct IRInstruction));
+	struct IRInstruction* call = &instructions[callIndex + moveCount];
+	struct IROperand* operands = arenaAlloc(ARENA_CODEGEN, call->operandCount * sizeof(struct IROperand));
+	memcpy(operands, call->operands, call->operandCount * sizeof(struct IROperand));
+	call->operands = operands;
+
+	struct IRInstruction* move = &instructions[callIndex];
+	for (uint32_t k = 0; k < call->operandCount; ++k) {
+		if (sameType(irOperandType(function, operands[k]), function->inputTypes[k])) {
+			continue;
+		}
+		uint32_t* result = arenaAlloc(ARENA_CODEGEN, sizeof(uint32_t));
+		*result = function->variableCount;
+		variableTypes[*result] = function->inputTypes[k];
+		++function->variableCount;
+
+		memset(move, 0, sizeof(struct IRInstruction));
+		move->ID = IR_MOVE;
+		move->resultCount = 1;
+		move->operandCount = 1;
+		move->results = result;
+		move->operands = arenaAlloc(ARENA_CODEGEN, sizeof(struct IROperand));
+		move->operands[0] = operands[k];
+		++move;
+
+		memset(&operands[k], 0, sizeof(struct IROperand));
+		operands[k].variableID = *result;
+	}
+
+	block->instructions = instructions;
+	block->instructionCount = instructionCount;
+	return call;
+}
+
+size_t eliminateTailRecursion(struct IRFunction* function) {
+	size_t loopedCount = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			struct IRInstruction* call = &block->instructions[j];
+			if (call->ID != function->ID || call->operandCount != function->inputCount || !irIsTailCall(function, i, j)) {
+				continue;
+			}
+
+			//the arguments are already the call's operands, they become the first block's arguments
+			//one of another type than its input is first moved into a new variable of the input's type, as jumps dont convert
+			uint32_t moveCount = 0;
+			for (uint32_t k = 0; k < call->operandCount; ++k) {
+				moveCount += !sameType(irOperandType(function, call->operands[k]), function->inputTypes[k]);
+			}
+			if (moveCount != 0) {
+				call = convertTailCallArguments(function, block, j, moveCount);
+				j += moveCount;
+			}
+			call->ID = IR_JUMP;
+			call->resultCount = 0;
+			call->results = NULL;
+			call->targetCount = 1;
+			call->targets[0].block = 0;
+			call->targets[0].firstArgument = 0;
+			call->targets[0].argumentCount = call->operandCount;
+			block->instructionCount = j + 1;
+			++loopedCount;
+			break;
+		}
+	}
+
+	//the blocks the results were passed through may no longer be jumped to
+	if (loopedCount != 0) {
+		removeUnreachableBlocks(function);
+	}
+	return loopedCount;
+}
+
+//size of a function for inlining, declarations only give types so arent counted
+size_t countBodyInstructions(const struct IRFunction* function) {
+	size_t count = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			count += block->instructions[j].ID != IR_DECLARE;
+		}
+	}
+	return count;
+}
+
+//index of the called function, UINT32_MAX for spec functions and IDs without one
+static inline uint32_t calleeIndex(const struct IRInstruction* instruction, const uint32_t* functionIndices, size_t functionIndexCount) {
+	if (irIsSpecID(instruction->ID) || instruction->ID >= functionIndexCount) {
+		return UINT32_MAX;
+	}
+	return functionIndices[instruction->ID];
+}
+
+//functions the entry can end up calling, walking the calls of each function reached
+//without an entry every function is kept
+void markReachableFunctions(const struct IRProgram* program, uint32_t entryID, const uint32_t* functionIndices, size_t functionIndexCount, bool* reachable) {
+	size_t functionCount = program->functionCount;
+	uint32_t entryIndex = entryID < functionIndexCount ? functionIndices[entryID] : UINT32_MAX;
+	memset(reachable, entryIndex == UINT32_MAX, functionCount * sizeof(bool));
+	if (entryIndex == UINT32_MAX) {
+		return;
+	}
+
+	uint32_t* worklist = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(uint32_t));
+	worklist[0] = entryIndex;
+	size_t worklistCount = 1;
+	reachable[entryIndex] = true;
+	while (worklistCount > 0) {
+		--worklistCount;
+		const struct IRFunction* function = &program->functions[worklist[worklistCount]];
+		for (size_t i = 0; i < function->blockCount; ++i) {
+			for (size_t j = 0; j < function->blocks[i].instructionCount; ++j) {
+				uint32_t callee = calleeIndex(&function->blocks[i].instructions[j], functionIndices, functionIndexCount);
+				if (callee != UINT32_MAX && !reachable[callee]) {
+					reachable[callee] = true;
+					worklist[worklistCount] = callee;
+					++worklistCount;
+				}
+			}
+		}
+	}
+}
+
+void runIRPasses(struct IRProgram* program, uint32_t entryID, const char* (*functionName)(size_t ID)) {
+	size_t functionCount = program->functionCount;
+	size_t* before = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(size_t));
+	size_t* inlinedCounts = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(size_t));
+	size_t* loopedCounts = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(size_t));
+
+	for (size_t i = 0; i < functionCount; ++i) {
+		before[i] = countInstructions(&program->functions[i]);
+		inlinedCounts[i] = 0;
+		loopedCounts[i] = 0;
+	}
+	size_t functionIndexCount = program->functionIDLimit;
+	uint32_t* functionIndices = arenaAlloc(ARENA_CODEGEN, functionIndexCount * sizeof(uint32_t));
+	memset(functionIndices, 0xFF, functionIndexCount * sizeof(uint32_t));
+	for (size_t i = 0; i < functionCount; ++i) {
+		functionIndices[program->functions[i].ID] = i;
+	}
+
+	//functions never called from the entry arent optimised, and their calls dont count
+	bool* reachable = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(bool));
+	markReachableFunctions(program, entryID, functionIndices, functionIndexCount, reachable);
+
+	//calls made by each function and how many places call each function, from before anything is inlined
+	size_t* calleeStarts = arenaAlloc(ARENA_CODEGEN, (functionCount + 1) * sizeof(size_t));
+	uint32_t* callSiteCounts = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(uint32_t));
+	memset(callSiteCounts, 0, functionCount * sizeof(uint32_t));
+	calleeStarts[0] = 0;
+	for (size_t i = 0; i < functionCount; ++i) {
+		const struct IRFunction* function = &program->functions[i];
+		calleeStarts[i + 1] = calleeStarts[i];
+		for (size_t j = 0; j < function->blockCount; ++j) {
+			for (size_t k = 0; k < function->blocks[j].instructionCount; ++k) {
+				uint32_t callee = calleeIndex(&function->blocks[j].instructions[k], functionIndices, functionIndexCount);
+				if (callee != UINT32_MAX) {
+					callSiteCounts[callee] += reachable[i];
+					++calleeStarts[i + 1];
+				}
+			}
+		}
+	}
+	uint32_t* callees = arenaAlloc(ARENA_CODEGEN, calleeStarts[functionCount] * sizeof(uint32_t));
+	for (size_t i = 0; i < functionCount; ++i) {
+		const struct IRFunction* function = &program->functions[i];
+		size_t placed = calleeStarts[i];
+		for (size_t j = 0; j < function->blockCount; ++j) {
+			for (size_t k = 0; k < function->blocks[j].instructionCount; ++k) {
+				uint32_t callee = calleeIndex(&function->blocks[j].instructions[k], functionIndices, functionIndexCount);
+				if (callee != UINT32_MAX) {
+					callees[placed] = callee;
+					++placed;
+				}
+			}
+		}
+	}
+
+	//callees are finished before their callers so what gets inlined is already optimised
+	//a function still on the stack is part of a recursive cycle and isnt inlined, which breaks the cycle
+	bool* visited = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(bool));
+	bool* inlineable = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(bool));
+	size_t* nextCallee = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(size_t));
+	size_t* stack = arenaAlloc(ARENA_CODEGEN, functionCount * sizeof(size_t));
+	memset(visited, 0, functionCount * sizeof(bool));
+	memset(inlineable, 0, functionCount * sizeof(bool));
+	for (size_t i = 0; i < functionCount; ++i) {
+		if (visited[i] || !reachable[i]) {
+			continue;
+		}
+		visited[i] = true;
+		nextCallee[i] = calleeStarts[i];
+		stack[0] = i;
+		size_t stackCount = 1;
+
+		while (stackCount > 0) {
+			size_t index = stack[stackCount - 1];
+			if (nextCallee[index] < calleeStarts[index + 1]) {
+				uint32_t callee = callees[nextCallee[index]];
+				++nextCallee[index];
+				if (!visited[callee]) {
+					visited[callee] = true;
+					nextCallee[callee] = calleeStarts[callee];
+					stack[stackCount] = callee;
+					++stackCount;
+				}
+				continue;
+			}
+			--stackCount;
+
+			struct IRFunction* function = &program->functions[index];
+			if (inlineThreshold != 0) {
+				inlinedCounts[index] = inlineCalls(function, program, functionIndices, functionIndexCount, inlineable);
+			}
+			mergeBlocks(function);
+			propagateCopies(function);
+			loopedCounts[index] = eliminateTailRecursion(function);
+			numberGlobalValues(function);
+			eliminateDeadCode(function);
+
+			//single callers get the body whatever its size, as the original is then never called
+			size_t size = countBodyInstructions(function);
+			inlineable[index] = canInlineFunction(function) && (size <= inlineThreshold || callSiteCounts[index] == 1);
+		}
+	}
+
+	//inlining can leave functions no longer called at all
+	markReachableFunctions(program, entryID, functionIndices, functionIndexCount, reachable);
+	for (size_t i = 0; passReport != NULL && i < functionCount; ++i) {
+		const char* name = functionName(program->functions[i].ID);
+		if (!reachable[i]) {
+			const char* entryName = functionName(entryID);
+			fprintf(passReport, "%s: removed, unreachable from %s\n", name == NULL ? "?" : name, entryName == NULL ? "?" : entryName);
+			continue;
+		}
+		fprintf(passReport, "%s: %zu -> %zu instructions", name == NULL ? "?" : name, before[i], countInstructions(&program->functions[i]));
+		if (inlinedCounts[i] != 0) {
+			fprintf(passReport, ", %zu calls inlined", inlinedCounts[i]);
+		}
+		if (loopedCounts[i] != 0) {
+			fprintf(passReport, ", %zu tail calls looped", loopedCounts[i]);
+		}
+		fprintf(passReport, "\n");
+	}
+
+	size_t keptCount = 0;
+	for (size_t i = 0; i < functionCount; ++i) {
+		if (reachable[i]) {
+			program->functions[keptCount] = program->functions[i];
+			++keptCount;
+		}
+	}
+	program->functionCount = keptCount;
+}
\ No newline at end of file
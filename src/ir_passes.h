@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "ir.h"
+
+//instruction counts of each function before and after the passes are written here, NULL for no report
+void setIRPassReport(FILE* report);
+
+//calls to user functions with at most this many instructions, not counting declarations, are inlined, 0 turns inlining off
+//functions with a single call site are inlined whatever their size
+void setIRInlineThreshold(size_t threshold);
+
+//runs the optimisation pipeline over every function, callees before callers so they are inlined once optimised
+//functions the entry function never calls, directly or not, are removed from the program, UINT32_MAX for no entry keeps them all
+//functionName is only used for the report
+void runIRPasses(struct IRProgram* program, uint32_t entryID, const char* (*functionName)(size_t ID));
+
+//the passes, each keeps the function in valid ssa
+//blocks only ever jumped to from one block are joined onto the end of it, their arguments replaced by what the jump passed
+//blocks that become unreachable are removed
+void mergeBlocks(struct IRFunction* function);
+//uses of variables that are only ever a copy of another value are replaced by that value, and the copy removed
+void propagateCopies(struct IRFunction* function);
+//calls to the function itself in tail position become jumps back to the first block, passing the arguments as its arguments
+//returns how many were replaced
+size_t eliminateTailRecursion(struct IRFunction* function);
+//dominator tree based value numbering, expressions already computed in a dominating block are replaced by that result
+//block arguments that every jump passes the same available value are replaced by it
+void numberGlobalValues(struct IRFunction* function);
+//removes instructions without side effects whose results are never used, declarations of unused variables and unused block arguments
+void eliminateDeadCode(struct IRFunction* function);
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "keyword.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "token.h"
+
+//perfect hash over the first character, last character and length
+//the multipliers were searched for so that every keyword gets its own slot
+//a collision shows up as an overridden initializer warning (-Woverride-init, part of -Wextra)
+#define KEYWORD_TABLE_SIZE 32
+#define KEYWORD_HASH(first, last, length) (((first) ^ ((last) * 4) ^ ((length) * 5)) & (KEYWORD_TABLE_SIZE - 1))
+
+#define KEYWORD(text, first, last, type) \
+	[KEYWORD_HASH(first, last, sizeof(text) - 1)] = {text, sizeof(text) - 1, type, BUILTIN_TYPE_NONE, 0}
+#define BUILTIN_TYPE(text, first, last, builtinType, sizeExp) \
+	[KEYWORD_HASH(first, last, sizeof(text) - 1)] = {text, sizeof(text) - 1, TOKEN_BUILTIN_TYPE, builtinType, sizeExp}
+
+static const struct Keyword keywordTable[KEYWORD_TABLE_SIZE] = {
+	KEYWORD("if", 'i', 'f', TOKEN_KEYWORD_IF),
+	KEYWORD("else", 'e', 'e', TOKEN_KEYWORD_ELSE),
+	KEYWORD("while", 'w', 'e', TOKEN_KEYWORD_WHILE),
+	KEYWORD("return", 'r', 'n', TOKEN_KEYWORD_RETURN),
+
+	BUILTIN_TYPE("bool", 'b', 'l', BUILTIN_TYPE_BOOL, 3), //bools are one byte always
+
+	BUILTIN_TYPE("i8", 'i', '8', BUILTIN_TYPE_INTEGER, 3),
+	BUILTIN_TYPE("i16", 'i', '6', BUILTIN_TYPE_INTEGER, 4),
+	BUILTIN_TYPE("i32", 'i', '2', BUILTIN_TYPE_INTEGER, 5),
+	BUILTIN_TYPE("i64", 'i', '4', BUILTIN_TYPE_INTEGER, 6),
+	BUILTIN_TYPE("isize", 'i', 'e', BUILTIN_TYPE_INTEGER, (uint8_t)-1), //word size
+
+	BUILTIN_TYPE("u8", 'u', '8', BUILTIN_TYPE_UNSIGNED, 3),
+	BUILTIN_TYPE("u16", 'u', '6', BUILTIN_TYPE_UNSIGNED, 4),
+	BUILTIN_TYPE("u32", 'u', '2', BUILTIN_TYPE_UNSIGNED, 5),
+	BUILTIN_TYPE("u64", 'u', '4', BUILTIN_TYPE_UNSIGNED, 6),
+	BUILTIN_TYPE("usize", 'u', 'e', BUILTIN_TYPE_UNSIGNED, (uint8_t)-1), //word size
+
+	BUILTIN_TYPE("f32", 'f', '2', BUILTIN_TYPE_FLOAT, 5),
+	BUILTIN_TYPE("f64", 'f', '4', BUILTIN_TYPE_FLOAT, 6),
+};
+
+#undef KEYWORD
+#undef BUILTIN_TYPE
+
+const struct Keyword* findKeyword(const char* identifier, size_t length) {
+	//shortest keyword is 2 characters, longest is 6
+	if (length < 2 || length > 6) {
+		return NULL;
+	}
+
+	const struct Keyword* keyword = &keywordTable[KEYWORD_HASH((uint8_t)identifier[0], (uint8_t)identifier[length - 1], length)];
+	if (keyword->length != length || memcmp(keyword->text, identifier, length) != 0) {
+		return NULL;
+	}
+	return keyword;
+}
\ No newline at end of file
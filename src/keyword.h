@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "token.h"
+
+struct Keyword {
+	const char* text;
+	size_t length;
+	enum TokenType type;
+
+	//only set for TOKEN_BUILTIN_TYPE
+	enum BuiltinType builtinType;
+	uint8_t sizeExp;
+};
+
+//returns NULL if the identifier is not a keyword or builtin type name
+const struct Keyword* findKeyword(const char* identifier, size_t length);
\ No newline at end of file
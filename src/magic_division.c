@@ -0,0 +1,85 @@
+#include "magic_division.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TWO_63 ((uint64_t)1 << 63)
+
+struct SignedDivisionMagic signedDivisionMagic(int64_t divisor) {
+	uint64_t absoluteDivisor = divisorMagnitude(divisor, true);
+	uint64_t t = TWO_63 + ((uint64_t)divisor >> 63);
+	uint64_t absoluteNc = t - 1 - t % absoluteDivisor; //absolute value of nc
+
+	//smallest power of two where the reciprocal is precise enough for every dividend
+	uint32_t p = 63;
+	uint64_t q1 = TWO_63 / absoluteNc;
+	uint64_t r1 = TWO_63 - q1 * absoluteNc;
+	uint64_t q2 = TWO_63 / absoluteDivisor;
+	uint64_t r2 = TWO_63 - q2 * absoluteDivisor;
+	uint64_t delta = 0;
+	do {
+		++p;
+		q1 *= 2;
+		r1 *= 2;
+		if (r1 >= absoluteNc) {
+			++q1;
+			r1 -= absoluteNc;
+		}
+		q2 *= 2;
+		r2 *= 2;
+		if (r2 >= absoluteDivisor) {
+			++q2;
+			r2 -= absoluteDivisor;
+		}
+		delta = absoluteDivisor - r2;
+	} while (q1 < delta || (q1 == delta && r1 == 0));
+
+	struct SignedDivisionMagic magic;
+	magic.multiplier = (int64_t)(q2 + 1);
+	if (divisor < 0) {
+		magic.multiplier = -magic.multiplier;
+	}
+	magic.shift = p - 64;
+	return magic;
+}
+
+struct UnsignedDivisionMagic unsignedDivisionMagic(uint64_t divisor) {
+	struct UnsignedDivisionMagic magic;
+	magic.add = false;
+
+	uint64_t nc = -1 - (-divisor) % divisor;
+	uint32_t p = 63;
+	uint64_t q1 = TWO_63 / nc;
+	uint64_t r1 = TWO_63 - q1 * nc;
+	uint64_t q2 = (TWO_63 - 1) / divisor;
+	uint64_t r2 = (TWO_63 - 1) - q2 * divisor;
+	uint64_t delta = 0;
+	do {
+		++p;
+		if (r1 >= nc - r1) {
+			q1 = 2 * q1 + 1;
+			r1 = 2 * r1 - nc;
+		} else {
+			q1 = 2 * q1;
+			r1 = 2 * r1;
+		}
+		if (r2 + 1 >= divisor - r2) {
+			if (q2 >= TWO_63 - 1) {
+				magic.add = true;
+			}
+			q2 = 2 * q2 + 1;
+			r2 = 2 * r2 + 1 - divisor;
+		} else {
+			if (q2 >= TWO_63) {
+				magic.add = true;
+			}
+			q2 = 2 * q2;
+			r2 = 2 * r2 + 1;
+		}
+		delta = divisor - 1 - r2;
+	} while (p < 128 && (q1 < delta || (q1 == delta && r1 == 0)));
+
+	magic.multiplier = q2 + 1;
+	magic.shift = p - 64;
+	return magic;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//division by a constant as a multiplication by its fixed point reciprocal, see hackers delight chapter 10
+//the quotient is the high half of the 128 bit product shifted right
+
+//q = (mulhi(n, multiplier) (+ n if the divisor is positive and the multiplier negative, - n if the other way round)) >> shift, plus 1 if negative
+struct SignedDivisionMagic {
+	int64_t multiplier;
+	uint8_t shift;
+};
+
+//q = mulhi(n, multiplier) >> shift, when add is set the multiplier needs 65 bits so q = (((n - t) >> 1) + t) >> (shift - 1)
+struct UnsignedDivisionMagic {
+	uint64_t multiplier;
+	uint8_t shift;
+	bool add;
+};
+
+//the divisor MUST NOT be -1, 0 or 1
+struct SignedDivisionMagic signedDivisionMagic(int64_t divisor);
+//the divisor MUST NOT be 0 or a power of two
+struct UnsignedDivisionMagic unsignedDivisionMagic(uint64_t divisor);
+
+static inline bool isPowerOfTwo(uint64_t value) {
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+//value MUST be a power of two
+static inline uint8_t powerOfTwoExponent(uint64_t value) {
+	uint8_t exponent = 0;
+	while (value > 1) {
+		value >>= 1;
+		++exponent;
+	}
+	return exponent;
+}
+
+//magnitude of the divisor as the type sees it
+static inline uint64_t divisorMagnitude(uint64_t divisor, bool isSigned) {
+	if (isSigned && (int64_t)divisor < 0) {
+		return -divisor;
+	}
+	return divisor;
+}
+
+//divisions by these are only shifts, no multiplication needed
+static inline bool isShiftDivisor(uint64_t divisor, bool isSigned) {
+	return isPowerOfTwo(divisorMagnitude(divisor, isSigned));
+}
\ No newline at end of file
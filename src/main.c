@@ -1,50 +1,280 @@
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <time.h>
 
+#include "arena.h"
 #include "byte_array.h"
+#include "char_scan.h"
+#include "elf_writer.h"
+#include "ir_passes.h"
 #include "parser.h"
+#include "source_file.h"
+#include "thread_pool.h"
+#include "tokeniser.h"
 #include "x86_64_linux.h"
 
+double secondsNow() {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static const enum CharScanner charScanners[] = {CHAR_SCANNER_SCALAR, CHAR_SCANNER_SSE2, CHAR_SCANNER_AVX2};
+#define CHAR_SCANNER_COUNT (sizeof(charScanners) / sizeof(charScanners[0]))
+
+//lexes the whole source with each supported character scanner and reports the throughput
+void benchmarkLexing(struct SourceFile source) {
+	//large sources would otherwise be lexed in chunks over every core, which times the cores and not the scanner
+	setThreadPoolSize(1);
+
+	for (size_t i = 0; i < CHAR_SCANNER_COUNT; ++i) {
+		if (!setCharScanner(charScanners[i])) {
+			printf("%-8s unsupported\n", charScannerName(charScanners[i]));
+			continue;
+		}
+
+		//repeat until at least a second has passed for a stable number
+		size_t runs = 0;
+		double start = secondsNow();
+		double elapsed = 0;
+		do {
+			resetTokeniserPrelexed(source.ptr, source.length);
+			++runs;
+			elapsed = secondsNow() - start;
+		} while (elapsed < 1.0);
+
+		double bytesPerSecond = (double)source.length * runs / elapsed;
+		printf("%-8s %10.1f MB/s (%zu runs)\n", charScannerName(charScanners[i]), bytesPerSecond / 1e6, runs);
+	}
+}
+
+bool hasExtension(const char* path, const char* extension) {
+	size_t pathLength = strlen(path);
+	size_t extensionLength = strlen(extension);
+	return pathLength >= extensionLength && strcmp(path + pathLength - extensionLength, extension) == 0;
+}
+
+//memory must be freed after use
+char* appendExtension(const char* path, const char* extension) {
+	size_t pathLength = strlen(path);
+	size_t extensionLength = strlen(extension);
+
+	char* extended = calloc(pathLength + extensionLength + 1, sizeof(char));
+	if (extended == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for file path!\n");
+		exit(1);
+	}
+	memcpy(extended, path, pathLength);
+	memcpy(extended + pathLength, extension, extensionLength);
+	return extended;
+}
+
+enum OutputFormat {
+	OUTPUT_EXECUTABLE, //static elf executable, <output>.out
+	OUTPUT_OBJECT, //relocatable elf object, <output>.o
+	OUTPUT_ASM, //nasm text, <output>.xpb.asm
+};
+
 int main(int argc, char* argv[]) {
 	//cl arguments checks
-	if (argc != 2) {
+	const char* sourcePath = NULL; //"-" reads the source from stdin
+	const char* outputPath = NULL; //output files are named after this, defaults to the source path, "-" writes the output to stdout
+	bool benchLex = false;
+	bool printStats = false;
+	bool passReport = false;
+	bool emitBytecode = false;
+	enum OutputFormat outputFormat = OUTPUT_EXECUTABLE;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--bench-lex") == 0) {
+			benchLex = true;
+		} else if (strcmp(argv[i], "--stats") == 0) {
+			printStats = true;
+		} else if (strcmp(argv[i], "--pass-report") == 0) {
+			passReport = true;
+		} else if (strcmp(argv[i], "--inline-threshold") == 0 && i + 1 < argc) {
+			++i;
+			char* end = NULL;
+			unsigned long long threshold = strtoull(argv[i], &end, 10);
+			if (*argv[i] < '0' || *argv[i] > '9' || *end != '\0') {
+				fprintf(stderr, "ERROR: Inline threshold [%s] is not a number.\n", argv[i]);
+				return 1;
+			}
+			setIRInlineThreshold(threshold);
+		} else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			++i;
+			char* end = NULL;
+			unsigned long long threadCount = strtoull(argv[i], &end, 10);
+			if (*argv[i] < '1' || *argv[i] > '9' || *end != '\0' || threadCount > 1024) {
+				fprintf(stderr, "ERROR: Thread count [%s] is not a number from 1 to 1024.\n", argv[i]);
+				return 1;
+			}
+			setThreadPoolSize(threadCount);
+		} else if (strcmp(argv[i], "--char-scanner") == 0 && i + 1 < argc) {
+			++i;
+			size_t scanner = 0;
+			while (scanner < CHAR_SCANNER_COUNT && strcmp(argv[i], charScannerName(charScanners[scanner])) != 0) {
+				++scanner;
+			}
+			if (scanner == CHAR_SCANNER_COUNT) {
+				fprintf(stderr, "ERROR: Unknown character scanner [%s].\n", argv[i]);
+				return 1;
+			}
+			if (!setCharScanner(charScanners[scanner])) {
+				fprintf(stderr, "ERROR: Character scanner [%s] is not supported by this cpu.\n", argv[i]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--emit-bytecode") == 0) {
+			emitBytecode = true;
+		} else if (strcmp(argv[i], "--emit-asm") == 0) {
+			outputFormat = OUTPUT_ASM;
+		} else if (strcmp(argv[i], "--emit-object") == 0) {
+			outputFormat = OUTPUT_OBJECT;
+		} else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			++i;
+			outputPath = argv[i];
+		} else if (sourcePath == NULL) {
+			sourcePath = argv[i];
+		} else {
+			fprintf(stderr, "ERROR: Incorrect argument count.\n");
+			return 1;
+		}
+	}
+	if (sourcePath == NULL) {
 		fprintf(stderr, "ERROR: Incorrect argument count.\n");
 		return 1;
 	}
 
-	//open files
-	FILE* srcPtr = fopen(argv[1], "r");
-	if (srcPtr == NULL) {
-		fprintf(stderr, "ERROR: File [%s] could not be opened.\n", argv[1]);
+	bool fromStdin = strcmp(sourcePath, "-") == 0;
+	//already compiled bytecode skips straight to the backend
+	bool fromBytecode = !fromStdin && hasExtension(sourcePath, ".xpb");
+	char* strippedPath = NULL;
+	if (outputPath == NULL && fromBytecode) {
+		//name the output as if the original source was compiled
+		strippedPath = calloc(strlen(sourcePath) - 3, sizeof(char));
+		if (strippedPath == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for file path!\n");
+			return 1;
+		}
+		memcpy(strippedPath, sourcePath, strlen(sourcePath) - 4);
+		outputPath = strippedPath;
+	} else if (outputPath == NULL) {
+		outputPath = fromStdin ? "out" : sourcePath;
+	}
+	if (fromStdin && benchLex) {
+		fprintf(stderr, "ERROR: Lexing benchmark needs a source file, not stdin.\n");
 		return 1;
 	}
-	FILE* ssaPtr = fopen(strcat(argv[1], ".xpb"), "wb+");
-	if (ssaPtr == NULL) {
-		fprintf(stderr, "ERROR: File [%s] could not be opened.\n", argv[1]);
+	if (strcmp(outputPath, "-") == 0 && emitBytecode) {
+		fprintf(stderr, "ERROR: Bytecode can't be emitted when writing to stdout.\n");
+		return 1;
+	}
+	if (fromBytecode && (benchLex || emitBytecode)) {
+		fprintf(stderr, "ERROR: Source is already bytecode.\n");
 		return 1;
 	}
 
-	//parse
-	struct ByteArray bytecode;
-	bytecode = parseFile(srcPtr);
+	//open files
+	struct SourceFile source = {NULL, 0, false};
+	if (!fromStdin && !openSourceFile(sourcePath, &source)) {
+		fprintf(stderr, "ERROR: File [%s] could not be opened.\n", sourcePath);
+		return 1;
+	}
 
-	//output bytecode
-	fwrite(bytecode.ptr, bytecode.length, 1, ssaPtr);
+	if (benchLex) {
+		benchmarkLexing(source);
+		closeSourceFile(&source);
+		return 0;
+	}
 
-	//free bytecode
-	freeByteArray(&bytecode);
+	//parse
+	struct ByteArray bytecode = {NULL, 0};
+	if (fromStdin) {
+		bytecode = parseStream(stdin);
+	} else if (fromBytecode) {
+		//the backend reads the mapped file directly, it is closed after code generation
+		bytecode.ptr = (char*)source.ptr;
+		bytecode.length = source.length;
+	} else {
+		bytecode = parseFile(source.ptr, source.length);
+	}
+
+	//parse and bytecode data is done with once the bytecode is finalised
+	resetArena(ARENA_PARSE);
+	resetArena(ARENA_BYTECODE);
 
 	//close compilation files
-	fclose(srcPtr);
+	if (!fromBytecode) {
+		closeSourceFile(&source);
+	}
+
+	//output bytecode, only when asked for as the backend reads it from memory
+	char* ssaPath = appendExtension(outputPath, ".xpb");
+	if (emitBytecode) {
+		FILE* ssaPtr = fopen(ssaPath, "wb");
+		if (ssaPtr == NULL) {
+			fprintf(stderr, "ERROR: File [%s] could not be opened.\n", ssaPath);
+			return 1;
+		}
+		fwrite(bytecode.ptr, bytecode.length, 1, ssaPtr);
+		fclose(ssaPtr);
+	}
+
+	//open output file
+	bool toStdout = strcmp(outputPath, "-") == 0;
+	char* outPath = NULL;
+	switch (outputFormat) {
+		case OUTPUT_EXECUTABLE: outPath = appendExtension(outputPath, ".out"); break;
+		case OUTPUT_OBJECT: outPath = appendExtension(outputPath, ".o"); break;
+		case OUTPUT_ASM: outPath = appendExtension(ssaPath, ".asm"); break;
+	}
+	FILE* outPtr = toStdout ? stdout : fopen(outPath, outputFormat == OUTPUT_ASM ? "w" : "wb");
+	if (outPtr == NULL) {
+		fprintf(stderr, "ERROR: File [%s] could not be opened.\n", outPath);
+		return 1;
+	}
 
-	//open asm file
-	FILE* asmPtr = fopen(strcat(argv[1], ".asm"), "w");
-	if (ssaPtr == NULL) {
-		fprintf(stderr, "ERROR: File [%s] could not be opened.\n", argv[1]);
+	if (passReport) {
+		setIRPassReport(stderr);
+	}
+	if (outputFormat == OUTPUT_ASM) {
+		generateASM(bytecode.ptr, bytecode.length, outPtr);
+	} else {
+		struct X86Code code = generateMachineCode(bytecode.ptr, bytecode.length);
+		if (outputFormat == OUTPUT_EXECUTABLE) {
+			writeElfExecutable(code, outPtr);
+			if (!toStdout) {
+				fchmod(fileno(outPtr), 0755);
+			}
+		} else {
+			writeElfObject(code, outPtr);
+		}
+		freeX86Code(&code);
+	}
+	if (!toStdout && fclose(outPtr) != 0) {
+		fprintf(stderr, "ERROR: File [%s] could not be written.\n", outPath);
 		return 1;
 	}
+	resetArena(ARENA_CODEGEN);
 
-	generateASM(ssaPtr, asmPtr);
+	//free bytecode
+	if (fromBytecode) {
+		closeSourceFile(&source);
+	} else {
+		freeByteArray(&bytecode);
+	}
+
+	free(ssaPath);
+	free(outPath);
+	free(strippedPath);
+
+	if (printStats) {
+		fprintf(stderr, "Peak arena bytes: %zu\n", arenaPeakBytes());
+		fprintf(stderr, "Arena block allocations: %zu\n", arenaBlockAllocations());
+	}
+	freeArenas();
 
 	return 0;
 }
\ No newline at end of file
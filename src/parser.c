@@ -7,14 +7,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "arena.h"
 #include "byte_array.h"
 #include "bytecode_gen.h"
+#include "ir.h"
 #include "operation.h"
+#include "symbol_table.h"
 #include "token.h"
 #include "tokeniser.h"
 
-static FILE* srcPtr = NULL;
-
 //state variables
 static uint32_t nextFunctionID = 0;
 static uint32_t nextVariableID = 1;
@@ -23,6 +24,82 @@ static size_t scopeDepth = 0;
 static uint32_t currentFunctionBlockCount = 0;
 static uint64_t currentBlockInstructionCount = 0;
 
+//type of a value, as in the bytecode
+struct ValueType {
+	enum IRType type;
+	uint8_t sizeExp;
+};
+
+//integer literals without a type to match are i64
+static const struct ValueType defaultLiteralType = {IR_INTEGER, 6};
+
+//an instruction operand, a variable or a constant when variableID is 0
+struct Operand {
+	uint32_t variableID;
+	struct ValueType type;
+	uint64_t value; //only for constants
+};
+
+//named variables of the current function, indexed by identifier symbol
+//assignments create a new ssa variable so the current one is tracked, variableID is 0 when undefined
+//variables assigned a constant are propagated as that constant
+struct NamedVariable {
+	uint32_t variableID;
+	struct ValueType type;
+	bool isConstant;
+	uint64_t value;
+};
+static struct NamedVariable* namedVariables = NULL;
+static uint32_t namedVariableCapacity = 0;
+static uint32_t* definedSymbols = NULL; //so only the defined ones need clearing at the end of the function
+static uint32_t definedSymbolCount = 0;
+static uint32_t definedSymbolCapacity = 0;
+
+//signature of each user function by ID, only known once its definition is reached
+struct FunctionSignature {
+	bool defined;
+	bool hasOutput;
+	struct ValueType outputType;
+	uint32_t inputCount;
+	struct ValueType* inputTypes;
+	uint32_t firstForwardCall; //index + 1 of the last call made before the definition, 0 for none
+};
+static struct FunctionSignature* functionSignatures = NULL;
+static uint32_t functionSignatureCapacity = 0;
+
+//a call made before the function was defined, which cant convert its arguments so is checked against the definition
+//forward calls pass their arguments as they are and assume the output is the default literal type
+struct ForwardCall {
+	size_t fileIndex;
+	bool wantResult;
+	uint32_t argumentCount;
+	struct ValueType* argumentTypes;
+	uint32_t nextForwardCall; //index + 1 of the previous forward call to the same function, 0 for none
+};
+static struct ForwardCall* forwardCalls = NULL;
+static uint32_t forwardCallCount = 0;
+static uint32_t forwardCallCapacity = 0;
+
+//output of the function being parsed, for return statements
+static bool currentFunctionHasOutput = false;
+static struct ValueType currentFunctionOutputType = {IR_INTEGER, 6};
+
+void* reallocParser(void* ptr, size_t size) {
+	void* resized = realloc(ptr, size);
+	if (resized == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for parser!\n");
+		exit(1);
+	}
+	return resized;
+}
+
+void clearNamedVariables() {
+	for (uint32_t i = 0; i < definedSymbolCount; ++i) {
+		namedVariables[definedSymbols[i]].variableID = 0;
+	}
+	definedSymbolCount = 0;
+}
+
 void resetState() {
 	nextFunctionID = 0;
 	nextVariableID = 1;
@@ -30,46 +107,250 @@ void resetState() {
 
 	currentFunctionBlockCount = 0;
 	currentBlockInstructionCount = 0;
+
+	//symbols are reset with the bytecode gen, so every entry is stale
+	for (uint32_t i = 0; i < namedVariableCapacity; ++i) {
+		namedVariables[i].variableID = 0;
+	}
+	definedSymbolCount = 0;
+	if (functionSignatureCapacity != 0) {
+		memset(functionSignatures, 0, functionSignatureCapacity * sizeof(struct FunctionSignature));
+	}
+	forwardCallCount = 0;
 }
 
 //forward declaration
 void parse();
-uint32_t parseOperand();
+struct Operand parseOperand();
+struct Operand parseExpression();
 
 void unexpectedToken() {
 	fprintf(stderr, "ERROR: Unexpected token of type %d at file index %zu!\n", currentToken().type, currentToken().fileIndex);
 	exit(1);
 }
 
-uint32_t parseStringLiteral(struct Token literal) {
-	char* buffer = calloc(literal.length - 2, sizeof(char)); //may be slightly larger than neccessary
-	if (buffer == NULL) {
-		fprintf(stderr, "ERROR: Could not allocate memory for string literal temp!\n");
+//NULL if the identifier isnt a variable in the current function
+struct NamedVariable* findNamedVariable(struct Token identifier) {
+	uint32_t symbol = findSymbol(tokenText(identifier), identifier.length);
+	if (symbol == SYMBOL_NONE || symbol >= namedVariableCapacity || namedVariables[symbol].variableID == 0) {
+		return NULL;
+	}
+	return &namedVariables[symbol];
+}
+
+//when streaming the identifier text is only kept until the token after it is moved past
+//so the symbol is interned then, not once the variable is defined
+uint32_t internIdentifier(struct Token identifier) {
+	return internSymbol(tokenText(identifier), identifier.length);
+}
+
+//value is what the variable was assigned, a constant or the variable itself
+void defineNamedVariable(uint32_t symbol, uint32_t variableID, struct ValueType type, struct Operand value) {
+	if (symbol >= namedVariableCapacity) {
+		uint32_t newCapacity = namedVariableCapacity == 0 ? 64 : namedVariableCapacity;
+		while (symbol >= newCapacity) {
+			newCapacity *= 2;
+		}
+		namedVariables = reallocParser(namedVariables, newCapacity * sizeof(struct NamedVariable));
+		memset(namedVariables + namedVariableCapacity, 0, (newCapacity - namedVariableCapacity) * sizeof(struct NamedVariable));
+		namedVariableCapacity = newCapacity;
+	}
+
+	if (namedVariables[symbol].variableID == 0) {
+		if (definedSymbolCount == definedSymbolCapacity) {
+			definedSymbolCapacity = definedSymbolCapacity == 0 ? 64 : definedSymbolCapacity * 2;
+			definedSymbols = reallocParser(definedSymbols, definedSymbolCapacity * sizeof(uint32_t));
+		}
+		definedSymbols[definedSymbolCount] = symbol;
+		++definedSymbolCount;
+	}
+
+	namedVariables[symbol].variableID = variableID;
+	namedVariables[symbol].type = type;
+	namedVariables[symbol].isConstant = value.variableID == 0;
+	namedVariables[symbol].value = value.value;
+}
+
+static inline bool sameValueType(struct ValueType a, struct ValueType b) {
+	return a.type == b.type && a.sizeExp == b.sizeExp;
+}
+
+struct FunctionSignature* getFunctionSignature(uint32_t functionID) {
+	if (functionID >= functionSignatureCapacity) {
+		uint32_t newCapacity = functionSignatureCapacity == 0 ? 64 : functionSignatureCapacity;
+		while (functionID >= newCapacity) {
+			newCapacity *= 2;
+		}
+		functionSignatures = reallocParser(functionSignatures, newCapacity * sizeof(struct FunctionSignature));
+		memset(functionSignatures + functionSignatureCapacity, 0, (newCapacity - functionSignatureCapacity) * sizeof(struct FunctionSignature));
+		functionSignatureCapacity = newCapacity;
+	}
+	return &functionSignatures[functionID];
+}
+
+void addForwardCall(uint32_t functionID, size_t fileIndex, bool wantResult, uint32_t argumentCount, struct ValueType* argumentTypes) {
+	if (forwardCallCount == forwardCallCapacity) {
+		forwardCallCapacity = forwardCallCapacity == 0 ? 64 : forwardCallCapacity * 2;
+		forwardCalls = reallocParser(forwardCalls, forwardCallCapacity * sizeof(struct ForwardCall));
+	}
+	struct FunctionSignature* signature = getFunctionSignature(functionID);
+	struct ForwardCall call = {fileIndex, wantResult, argumentCount, argumentTypes, signature->firstForwardCall};
+	forwardCalls[forwardCallCount] = call;
+	++forwardCallCount;
+	signature->firstForwardCall = forwardCallCount;
+}
+
+//calls before the definition have to have guessed right, as their bytecode is already written
+void checkForwardCall(const struct ForwardCall* call, const struct FunctionSignature* signature) {
+	if (call->wantResult != signature->hasOutput || (call->wantResult && !sameValueType(signature->outputType, defaultLiteralType))) {
+		fprintf(stderr, "ERROR: Call at file index %zu doesn't match the output of the function defined after it, define the function before calling it!\n", call->fileIndex);
+		exit(1);
+	}
+	bool argumentsMatch = call->argumentCount == signature->inputCount;
+	for (uint32_t i = 0; argumentsMatch && i < call->argumentCount; ++i) {
+		argumentsMatch = sameValueType(call->argumentTypes[i], signature->inputTypes[i]);
+	}
+	if (!argumentsMatch) {
+		fprintf(stderr, "ERROR: Call at file index %zu doesn't match the parameters of the function defined after it, define the function before calling it!\n", call->fileIndex);
+		exit(1);
+	}
+}
+
+void defineFunctionSignature(uint32_t functionID, bool hasOutput, struct ValueType outputType, uint32_t inputCount, struct ValueType* inputTypes) {
+	struct FunctionSignature* signature = getFunctionSignature(functionID);
+	signature->defined = true;
+	signature->hasOutput = hasOutput;
+	signature->outputType = outputType;
+	signature->inputCount = inputCount;
+	signature->inputTypes = inputTypes;
+
+	for (uint32_t i = signature->firstForwardCall; i != 0; i = forwardCalls[i - 1].nextForwardCall) {
+		checkForwardCall(&forwardCalls[i - 1], signature);
+	}
+	signature->firstForwardCall = 0;
+}
+
+void insertOperand(struct Operand operand) {
+	if (operand.variableID == 0) {
+		insertConstant(operand.type.type, operand.type.sizeExp, operand.value);
+		return;
+	}
+	insertValue(operand.variableID, 4);
+}
+
+static inline bool isIntegerType(struct ValueType type) {
+	return type.type == IR_INTEGER || type.type == IR_UNSIGNED;
+}
+
+//sizes below 64 bits, the word size is treated as 64 bits
+static inline uint8_t constantBits(struct ValueType type) {
+	if (type.sizeExp < 6) {
+		return 1 << type.sizeExp;
+	}
+	return 64;
+}
+
+//constants are kept truncated to the size of their type
+uint64_t truncateConstant(uint64_t value, struct ValueType type) {
+	uint8_t bits = constantBits(type);
+	if (bits < 64) {
+		value &= ((uint64_t)1 << bits) - 1;
+	}
+	return value;
+}
+
+//signed integers are sign extended, everything else zero extended
+uint64_t extendConstant(uint64_t value, struct ValueType type) {
+	uint8_t bits = constantBits(type);
+	if (type.type == IR_INTEGER && bits < 64) {
+		return (uint64_t)((int64_t)(value << (64 - bits)) >> (64 - bits));
+	}
+	return truncateConstant(value, type);
+}
+
+//floats are stored as their bits, f32 or f64
+double constantToDouble(struct Operand constant) {
+	if (constant.type.type == IR_FLOAT) {
+		if (constant.type.sizeExp == 5) {
+			float single;
+			uint32_t bits = constant.value;
+			memcpy(&single, &bits, sizeof(single));
+			return single;
+		}
+		double value;
+		memcpy(&value, &constant.value, sizeof(value));
+		return value;
+	}
+	if (constant.type.type == IR_INTEGER) {
+		return (int64_t)extendConstant(constant.value, constant.type);
+	}
+	return extendConstant(constant.value, constant.type);
+}
+
+uint64_t doubleToFloatBits(double value, struct ValueType type) {
+	if (type.sizeExp == 5) {
+		float single = value;
+		uint32_t bits;
+		memcpy(&bits, &single, sizeof(bits));
+		return bits;
+	}
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+//constants take the type of whatever they are used with, converting between floats and integers
+struct Operand matchConstantType(struct Operand operand, struct ValueType type) {
+	if (operand.variableID != 0) {
+		return operand;
+	}
+
+	if (type.type == IR_FLOAT && (operand.type.type != IR_FLOAT || operand.type.sizeExp != type.sizeExp)) {
+		operand.value = doubleToFloatBits(constantToDouble(operand), type);
+	} else if (type.type != IR_FLOAT && operand.type.type == IR_FLOAT) {
+		double value = constantToDouble(operand);
+		operand.value = type.type == IR_INTEGER ? (uint64_t)(int64_t)value : (uint64_t)value;
+	} else {
+		operand.value = extendConstant(operand.value, operand.type);
+	}
+
+	operand.type = type;
+	operand.value = truncateConstant(operand.value, type);
+	return operand;
+}
+
+//the character after the backslash in string and character literals
+char decodeEscape(char c, size_t fileIndex) {
+	switch (c) {
+		case '\\': return '\\';
+		case '\'': return '\'';
+		case '"': return '"';
+		case 'n': return '\n';
+
+		default:
+		fprintf(stderr, "ERROR: Invalid escape character at file index %zu!\n", fileIndex);
 		exit(1);
 	}
+}
 
-	//seek to first character in string
-	fseek(srcPtr, literal.fileIndex + 1, SEEK_SET);
+//returns the pointer to the static data, the length is returned through lengthOperand
+struct Operand parseStringLiteral(struct Token literal, struct Operand* lengthOperand) {
+	char* buffer = arenaAlloc(ARENA_PARSE, literal.length - 2); //may be slightly larger than neccessary
+
+	//first character in string
+	const char* text = tokenText(literal) + 1;
 
 	size_t trueLiteralLength = 0;
 	size_t bufferIndex = 0;
 
 	for (size_t i = 0; i < literal.length - 2; ++i) {
-		char c = fgetc(srcPtr);
+		char c = text[i];
 
 		//check if escape character
 		if (c == '\\') {
 			//skip escape character and replace next with relevant char
 			++i;
-			c = fgetc(srcPtr);
-			switch (c) {
-				case '\\': break;
-				case 'n': c = '\n'; break;
-
-				default:
-				fprintf(stderr, "ERROR: Invalid escape character at file index %zu!\n", literal.fileIndex + i + 1);
-				exit(1);
-			}
+			c = decodeEscape(text[i], literal.fileIndex + i + 1);
 		}
 
 		buffer[bufferIndex] = c;
@@ -79,55 +360,241 @@ uint32_t parseStringLiteral(struct Token literal) {
 	}
 
 	uint32_t pointerVariableID = createStaticData(IR_UNSIGNED, 3, trueLiteralLength, buffer);
-	insertValue(pointerVariableID, 4);
-	insertConstant(IR_UNSIGNED, -1, trueLiteralLength);
 
-	free(buffer);
+	struct Operand length = {0, {IR_UNSIGNED, -1}, trueLiteralLength};
+	*lengthOperand = length;
 
-	return pointerVariableID;
+	struct Operand pointer = {pointerVariableID, {IR_POINTER_UNSIGNED, 3}, 0};
+	return pointer;
 }
 
+//decimal, or hexadecimal and binary with 0x and 0b prefixes
+uint64_t parseIntegerLiteral(struct Token literal) {
+	const char* text = tokenText(literal);
+	size_t length = literal.length;
 
+	uint64_t base = 10;
+	size_t i = 0;
+	if (length > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'b')) {
+		base = text[1] == 'x' ? 16 : 2;
+		i = 2;
+	}
 
-//starts on the closing parenthesis or first parameter
-void parseFunctionDefinition(struct Token identifier) {
-	//cant define a function inside a function
-	if (scopeDepth > 0) {
-		fprintf(stderr, "ERROR: Attempted to define a function outside top scope at file index %zu!\n", currentToken().fileIndex);
+	uint64_t value = 0;
+	for (; i < length; ++i) {
+		char c = text[i];
+		uint64_t digit = 0;
+		if (c >= '0' && c <= '9') {
+			digit = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			digit = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			digit = c - 'A' + 10;
+		} else {
+			digit = base;
+		}
+
+		if (digit >= base) {
+			fprintf(stderr, "ERROR: Invalid digit in integer literal at file index %zu!\n", literal.fileIndex + i);
+			exit(1);
+		}
+		if (value > (UINT64_MAX - digit) / base) {
+			fprintf(stderr, "ERROR: Integer literal too large at file index %zu!\n", literal.fileIndex);
+			exit(1);
+		}
+		value = value * base + digit;
+	}
+	return value;
+}
+
+//a single u8 character
+struct Operand parseCharacterLiteral(struct Token literal) {
+	const char* text = tokenText(literal) + 1;
+	size_t length = literal.length - 2;
+
+	struct Operand operand = {0, {IR_UNSIGNED, 3}, 0};
+	if (length == 1 && text[0] != '\\') {
+		operand.value = (uint8_t)text[0];
+	} else if (length == 2 && text[0] == '\\') {
+		operand.value = (uint8_t)decodeEscape(text[1], literal.fileIndex + 2);
+	} else {
+		fprintf(stderr, "ERROR: Character literal must be a single character at file index %zu!\n", literal.fileIndex);
+		exit(1);
+	}
+	return operand;
+}
+
+//an f64 unless matched to another float type
+struct Operand parseFloatLiteral(struct Token literal) {
+	//strtod needs a terminated string, the tokeniser only allows digits and points so the literal is short
+	char buffer[64];
+	if (literal.length >= sizeof(buffer)) {
+		fprintf(stderr, "ERROR: Float literal too long at file index %zu!\n", literal.fileIndex);
+		exit(1);
+	}
+	memcpy(buffer, tokenText(literal), literal.length);
+	buffer[literal.length] = '\0';
+
+	char* end = NULL;
+	double value = strtod(buffer, &end);
+	if (end != buffer + literal.length) {
+		fprintf(stderr, "ERROR: Invalid float literal at file index %zu!\n", literal.fileIndex);
 		exit(1);
 	}
 
-	//add to function table if not already there (could happen if called above definition)
-	uint32_t functionID = findInFunctionTable(identifier);
+	struct ValueType type = {IR_FLOAT, 6};
+	struct Operand operand = {0, type, doubleToFloatBits(value, type)};
+	return operand;
+}
+
+//adds to the function table if not already there (could happen if called above definition)
+uint32_t getFunctionID(struct Token identifier) {
+	uint32_t functionID = findInFunctionTable(tokenText(identifier), identifier.length);
 	if (functionID == (uint32_t)-1) {
-		appendToFunctionTable(identifier, nextFunctionID);
+		appendToFunctionTable(tokenText(identifier), identifier.length, nextFunctionID);
 		functionID = nextFunctionID;
 		++nextFunctionID;
 	}
+	return functionID;
+}
+
+//starts on the type identifier, does not increment token
+struct ValueType parseTypeIdentifier() {
+	//builtin type names are recognised by the tokeniser
+	//TODO support pointers and user types
+	if (currentToken().type != TOKEN_BUILTIN_TYPE) {
+		unexpectedToken();
+	}
+
+	//get IR type
+	struct ValueType type = {IR_INTEGER, currentToken().sizeExp};
+	switch (currentToken().builtinType) {
+		case BUILTIN_TYPE_INTEGER: type.type = IR_INTEGER; break;
+		case BUILTIN_TYPE_UNSIGNED: type.type = IR_UNSIGNED; break;
+		case BUILTIN_TYPE_FLOAT: type.type = IR_FLOAT; break;
+		case BUILTIN_TYPE_BOOL: type.type = IR_BOOL; break;
+
+		default:
+		fprintf(stderr, "ERROR: Unknown type identifier at file index %zu!\n", currentToken().fileIndex);
+		exit(1);
+	}
+
+	return type;
+}
+
+//declares a new ssa variable of the type
+uint32_t insertDeclaration(struct ValueType type) {
+	uint32_t variableID = nextVariableID;
+	++nextVariableID;
+
+	insertValue(IR_DECLARE, 4);
+	insertTypeIdentifier(type.type, type.sizeExp, false);
+	insertValue(variableID, 4);
+	++currentBlockInstructionCount;
+
+	return variableID;
+}
+
+void insertMove(uint32_t destinationID, struct Operand source) {
+	insertValue(IR_MOVE, 4);
+	insertValue(destinationID, 4);
+	insertOperand(source);
+	++currentBlockInstructionCount;
+}
+
+//constants are matched to the type, variables of another type are moved into a new variable of it
+struct Operand convertOperand(struct Operand operand, struct ValueType type) {
+	if (operand.variableID == 0 || sameValueType(operand.type, type)) {
+		return matchConstantType(operand, type);
+	}
+	struct Operand converted = {insertDeclaration(type), type, 0};
+	insertMove(converted.variableID, operand);
+	return converted;
+}
+
+//starts on the opening parenthesis
+void parseFunctionDefinition(uint32_t functionID) {
+	//cant define a function inside a function
+	if (scopeDepth > 0) {
+		fprintf(stderr, "ERROR: Attempted to define a function outside top scope at file index %zu!\n", currentToken().fileIndex);
+		exit(1);
+	}
 
 	//create function definition bytecode
 	initialiseFunctionDefinition(functionID);
+	clearNamedVariables();
+	nextVariableID = 1;
 
-	//currently assuming no parameters
-	//TODO support parameters
+	//parameters are the first variables, in order
+	struct ValueType* inputTypes = NULL;
+	uint32_t inputCount = 0;
+	uint32_t inputCapacity = 0;
+	incrementToken();
+	while (currentToken().type != TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
+		if (currentToken().type != TOKEN_IDENTIFIER) {
+			unexpectedToken();
+		}
+		uint32_t symbol = internIdentifier(currentToken());
+		incrementToken();
+		if (currentToken().type != TOKEN_SYMBOL_COLON) {
+			unexpectedToken();
+		}
+		incrementToken();
+		struct ValueType type = parseTypeIdentifier();
+
+		if (inputCount == inputCapacity) {
+			inputCapacity = inputCapacity == 0 ? 8 : inputCapacity * 2;
+			struct ValueType* grown = arenaAlloc(ARENA_PARSE, inputCapacity * sizeof(struct ValueType));
+			if (inputCount != 0) {
+				memcpy(grown, inputTypes, inputCount * sizeof(struct ValueType));
+			}
+			inputTypes = grown;
+		}
+		inputTypes[inputCount] = type;
+		++inputCount;
+		struct Operand parameter = {nextVariableID, type, 0};
+		defineNamedVariable(symbol, nextVariableID, type, parameter);
+		++nextVariableID;
+
+		incrementToken();
+		if (currentToken().type == TOKEN_SYMBOL_COMMA) {
+			incrementToken();
+		} else if (currentToken().type != TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
+			unexpectedToken();
+		}
+	}
 	incrementToken();
 
 	//confirm that its a function definition
 	if (currentToken().type != TOKEN_SYMBOL_COLON) {
 		unexpectedToken();
 	}
+	incrementToken();
 
-	//currently assuming no descriptors
+	//an output type is the only descriptor for now
 	//TODO support function descriptors
-	incrementToken();
+	currentFunctionHasOutput = false;
+	if (currentToken().type == TOKEN_BUILTIN_TYPE) {
+		currentFunctionHasOutput = true;
+		currentFunctionOutputType = parseTypeIdentifier();
+		incrementToken();
+	}
+	defineFunctionSignature(functionID, currentFunctionHasOutput, currentFunctionOutputType, inputCount, inputTypes);
 
 	if (currentToken().type != TOKEN_SYMBOL_BRACE_LEFT) {
 		unexpectedToken();
 	}
 	++scopeDepth;
 
+	//output then input types follow the function header
+	if (currentFunctionHasOutput) {
+		insertTypeIdentifier(currentFunctionOutputType.type, currentFunctionOutputType.sizeExp, false);
+	}
+	for (uint32_t i = 0; i < inputCount; ++i) {
+		insertTypeIdentifier(inputTypes[i].type, inputTypes[i].sizeExp, false);
+	}
+
 	//create first block header
-	nextVariableID = 1; //currently assuming no parameters
 	currentFunctionBlockCount = 1;
 	currentBlockInstructionCount = 0;
 	initialiseBlockDefinition(0); //always 0 args, inherits function params
@@ -140,269 +607,509 @@ void parseFunctionDefinition(struct Token identifier) {
 	finaliseBlockDefinition(currentBlockInstructionCount);
 
 	//finalise function
-	finaliseFunctionDefinition(currentFunctionBlockCount, 0, 0);
+	finaliseFunctionDefinition(currentFunctionBlockCount, inputCount, currentFunctionHasOutput ? 1 : 0);
 	currentFunctionBlockCount = 0;
+	clearNamedVariables();
 }
 
-void parseFunctionArgument() {
-	switch (currentToken().type) {
-		case TOKEN_LITERAL_STRING:
-		insertValue(parseStringLiteral(currentToken()), 4);
-		return;
+//starts on the first argument or closing parenthesis, ends on the token after the closing parenthesis
+//returns the result, or %0 when the result isnt wanted
+struct Operand parseFunctionCall(uint32_t functionID, bool wantResult) {
+	size_t fileIndex = currentToken().fileIndex;
 
-		//skip commas and closing
-		case TOKEN_SYMBOL_COMMA:
-		case TOKEN_SYMBOL_PARENTHESIS_RIGHT:
-		return;
+	//arguments are parsed before the call is inserted, as they may need instructions of their own
+	struct Operand* arguments = NULL;
+	uint32_t argumentCount = 0;
+	uint32_t argumentCapacity = 0;
 
-		default:
-		unexpectedToken();
-		return;
+	while (currentToken().type != TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
+		//strings are passed as a pointer and a length
+		struct Operand argument[2];
+		uint32_t operandCount = 1;
+		if (currentToken().type == TOKEN_LITERAL_STRING && (nextToken().type == TOKEN_SYMBOL_COMMA || nextToken().type == TOKEN_SYMBOL_PARENTHESIS_RIGHT)) {
+			argument[0] = parseStringLiteral(currentToken(), &argument[1]);
+			operandCount = 2;
+			incrementToken();
+		} else {
+			argument[0] = parseExpression();
+		}
+
+		if (argumentCount + operandCount > argumentCapacity) {
+			argumentCapacity = argumentCapacity == 0 ? 8 : argumentCapacity * 2;
+			struct Operand* grown = arenaAlloc(ARENA_PARSE, argumentCapacity * sizeof(struct Operand));
+			if (argumentCount != 0) {
+				memcpy(grown, arguments, argumentCount * sizeof(struct Operand));
+			}
+			arguments = grown;
+		}
+		for (uint32_t i = 0; i < operandCount; ++i) {
+			arguments[argumentCount] = argument[i];
+			++argumentCount;
+		}
+
+		if (currentToken().type == TOKEN_SYMBOL_COMMA) {
+			incrementToken();
+		} else if (currentToken().type != TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
+			unexpectedToken();
+		}
 	}
-}
+	incrementToken();
 
-//starts on the closing parenthesis or first parameter
-uint32_t parseFunctionCall(struct Token identifier) {
-	//add to function table if not already there (could happen if called above definition)
-	uint32_t functionID = findInFunctionTable(identifier);
-	if (functionID == (uint32_t)-1) {
-		appendToFunctionTable(identifier, nextFunctionID);
-		functionID = nextFunctionID;
-		++nextFunctionID;
+	//arguments take the types of the parameters, calls before the definition are checked once it is reached
+	struct Operand result = {0, defaultLiteralType, 0};
+	bool hasOutput = wantResult;
+	if (irIsSpecID(functionID)) {
+		//specification functions have fixed parameters and no outputs for now
+		if (wantResult) {
+			fprintf(stderr, "ERROR: Specification function has no output at file index %zu!\n", fileIndex);
+			exit(1);
+		}
+	} else if (getFunctionSignature(functionID)->defined) {
+		const struct FunctionSignature* signature = getFunctionSignature(functionID);
+		if (argumentCount != signature->inputCount) {
+			fprintf(stderr, "ERROR: Call with %u arguments to a function with %u parameters at file index %zu!\n", argumentCount, signature->inputCount, fileIndex);
+			exit(1);
+		}
+		if (wantResult && !signature->hasOutput) {
+			fprintf(stderr, "ERROR: Function has no output at file index %zu!\n", fileIndex);
+			exit(1);
+		}
+		for (uint32_t i = 0; i < argumentCount; ++i) {
+			arguments[i] = convertOperand(arguments[i], signature->inputTypes[i]);
+		}
+		hasOutput = signature->hasOutput;
+		result.type = signature->outputType;
+	} else {
+		struct ValueType* argumentTypes = arenaAlloc(ARENA_PARSE, argumentCount * sizeof(struct ValueType));
+		for (uint32_t i = 0; i < argumentCount; ++i) {
+			argumentTypes[i] = arguments[i].type;
+		}
+		addForwardCall(functionID, fileIndex, wantResult, argumentCount, argumentTypes);
 	}
 
 	//create instruction
 	insertValue(functionID, 4);
-	++currentBlockInstructionCount;
-
-	//parse arguments
-	while (currentToken().type != TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
-		parseFunctionArgument();
-		incrementToken();
+	if (!irIsSpecID(functionID)) {
+		//user calls state their output and input counts, an output that isnt wanted is discarded into %0
+		insertValue(hasOutput ? 1 : 0, 4);
+		insertValue(argumentCount, 4);
+		if (wantResult) {
+			result.variableID = nextVariableID;
+			++nextVariableID;
+		}
+		if (hasOutput) {
+			insertValue(result.variableID, 4);
+		}
+	}
+	for (uint32_t i = 0; i < argumentCount; ++i) {
+		insertOperand(arguments[i]);
 	}
+	++currentBlockInstructionCount;
 
-	incrementToken();
+	return result;
+}
 
-	return 0; //TODO, handle proper return value
+//starts on the opening parenthesis, does not increment token
+//a definition is ( ) : or starts with a parameter ( name :, neither can begin a call so three tokens decide it
+bool isFunctionDefinition() {
+	struct Token first = peekToken(1);
+	if (first.type == TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
+		return peekToken(2).type == TOKEN_SYMBOL_COLON;
+	}
+	return first.type == TOKEN_IDENTIFIER && peekToken(2).type == TOKEN_SYMBOL_COLON;
 }
 
-//starts on the opening parenthesis
-uint32_t parseFunction(struct Token identifier) {
+//starts on the opening parenthesis, a call here is a statement so its output is discarded
+void parseFunction(struct Token identifier) {
+	//looked up before moving on, when streaming the identifier text is only kept until then
+	uint32_t functionID = getFunctionID(identifier);
+
+	if (isFunctionDefinition()) {
+		parseFunctionDefinition(functionID);
+		return;
+	}
 	incrementToken();
+	parseFunctionCall(functionID, false);
+}
 
+//does not increment token, starts on first token of operation symbol
+//returns OPERATION_NONE if the token isnt an operation, e.g. the end of the expression
+enum Operation parseOperation() {
 	switch (currentToken().type) {
-		//since both scenarios are followed by a colon in the case of a definition we can use the same code
-		case TOKEN_SYMBOL_PARENTHESIS_RIGHT:
-		case TOKEN_IDENTIFIER:
-		if (nextToken().type == TOKEN_SYMBOL_COLON) {
-			parseFunctionDefinition(identifier);
-			return 0;
-		} else {
-			return parseFunctionCall(identifier);
-		}
-
-		//literal means a function call
-		case TOKEN_LITERAL_STRING:
-		case TOKEN_LITERAL_CHARACTER:
-		case TOKEN_LITERAL_INT:
-		case TOKEN_LITERAL_FLOAT:
-		return parseFunctionCall(identifier);
+		case TOKEN_SYMBOL_PLUS: return OPERATION_ADD;
+		case TOKEN_SYMBOL_MINUS: return OPERATION_SUBTRACT;
+		case TOKEN_SYMBOL_STAR: return OPERATION_MULTIPLY;
+		case TOKEN_SYMBOL_SLASH_FORWARD: return OPERATION_DIVIDE;
 
-		default:
-		unexpectedToken();
-		return 0;
+		default: return OPERATION_NONE;
 	}
 }
 
-void parseTypeIdentifier() {
-	if (currentToken().type != TOKEN_IDENTIFIER) {
-		unexpectedToken();
+//computes the operation on two constants of the same type at parse time
+//returns false if it cant be folded, e.g. division by zero is left to happen at runtime
+bool foldConstants(enum Operation op, struct Operand lhs, struct Operand rhs, struct Operand* result) {
+	result->variableID = 0;
+	result->type = lhs.type;
+
+	if (lhs.type.type == IR_FLOAT && (lhs.type.sizeExp == 5 || lhs.type.sizeExp == 6)) {
+		double a = constantToDouble(lhs);
+		double b = constantToDouble(rhs);
+		double value = 0;
+		switch (op) {
+			case OPERATION_ADD: value = a + b; break;
+			case OPERATION_SUBTRACT: value = a - b; break;
+			case OPERATION_MULTIPLY: value = a * b; break;
+			case OPERATION_DIVIDE: value = a / b; break;
+
+			default: return false;
+		}
+		result->value = doubleToFloatBits(value, lhs.type);
+		return true;
 	}
 
-	fseek(srcPtr, currentToken().fileIndex, SEEK_SET);
-	char typeChar = fgetc(srcPtr);
+	if (!isIntegerType(lhs.type)) {
+		return false;
+	}
 
-	enum IRType typeType;
-	//get IR type
-	switch (typeChar) {
-		case 'i': typeType = IR_INTEGER; break;
-		case 'u': typeType = IR_UNSIGNED; break;
-		case 'f': typeType = IR_FLOAT; break;
-		
-		case 'b':;
-		char boolBuff[4]; //confirm actually full bool name
-		boolBuff[3] = '\n';
-		fread(boolBuff, 1, 3, srcPtr);
-		if (strcmp(boolBuff, "ool") != 0) {
-			fprintf(stderr, "ERROR: Unknown type identifier at file index %zu!\n", currentToken().fileIndex);
-			exit(1);
+	//wrapping arithmetic on the extended values, truncated back to the size of the type
+	uint64_t a = extendConstant(lhs.value, lhs.type);
+	uint64_t b = extendConstant(rhs.value, rhs.type);
+	uint64_t value = 0;
+	switch (op) {
+		case OPERATION_ADD: value = a + b; break;
+		case OPERATION_SUBTRACT: value = a - b; break;
+		case OPERATION_MULTIPLY: value = a * b; break;
+
+		case OPERATION_DIVIDE:
+		if (b == 0) {
+			return false;
 		}
-		insertTypeIdentifier(IR_BOOL, 3, false); //bools are one byte always, but insert one byte as the size to be safe
-		return;
+		if (lhs.type.type == IR_UNSIGNED) {
+			value = a / b;
+			break;
+		}
+		//the minimum divided by -1 overflows
+		if ((int64_t)b == -1 && a == extendConstant((uint64_t)1 << (constantBits(lhs.type) - 1), lhs.type)) {
+			return false;
+		}
+		value = (int64_t)a / (int64_t)b;
+		break;
 
-		//TODO support pointers
+		default: return false;
+	}
+	result->value = truncateConstant(value, lhs.type);
+	return true;
+}
 
-		default:
-		fprintf(stderr, "ERROR: Unknown type identifier at file index %zu!\n", currentToken().fileIndex);
-		exit(1);
+//floats over integers, then the larger size
+struct ValueType widerConstantType(struct ValueType a, struct ValueType b) {
+	if ((a.type == IR_FLOAT) != (b.type == IR_FLOAT)) {
+		return a.type == IR_FLOAT ? a : b;
 	}
+	return constantBits(b) > constantBits(a) ? b : a;
+}
 
-	//get size
-	size_t sizeLen = currentToken().fileIndex + currentToken().length - ftell(srcPtr);
-	char sizeBuff[sizeLen + 1];
-	sizeBuff[sizeLen] = '\0'; //null terminate (thanks C)
-	fread(sizeBuff, 1, sizeLen, srcPtr);
-
-	//get size exponent
-	size_t typeSize = strtol(sizeBuff, NULL, 10);
-	uint8_t exponent = 0;
-	size_t exponentTest = 1;
-	//get as exponent
-	while (exponentTest != typeSize) {
-		if (exponentTest == 0) {
-			fprintf(stderr, "ERROR: Type identifier with non power-of-two size at index %zu!\n", currentToken().fileIndex);
-			exit(1);
-		}
-		exponentTest <<= 1;
-		++exponent;
+//x + 0, x - 0, x * 1 and x / 1 are x, floats are left alone as signed zeroes make them inexact
+bool isIdentityOperand(enum Operation op, struct Operand operand, bool rightHandSide) {
+	if (operand.variableID != 0 || !isIntegerType(operand.type)) {
+		return false;
 	}
+	switch (op) {
+		case OPERATION_ADD: return operand.value == 0;
+		case OPERATION_SUBTRACT: return rightHandSide && operand.value == 0;
+		case OPERATION_MULTIPLY: return operand.value == 1;
+		case OPERATION_DIVIDE: return rightHandSide && operand.value == 1;
 
-	insertTypeIdentifier(typeType, exponent, false);
+		default: return false;
+	}
 }
 
-//does not increment token, starts on first token of operation symbol
-enum Operation parseOperation() {
-	switch (currentToken().type) {
-		case TOKEN_SYMBOL_EQUAL: return OPERATION_ASSIGN;
+struct Operand insertArithmetic(enum Operation op, struct Operand lhs, struct Operand rhs) {
+	//constants take the type of the variable theyre used with, or the wider of the two when both are constants
+	if (lhs.variableID == 0 && rhs.variableID == 0) {
+		struct ValueType type = widerConstantType(lhs.type, rhs.type);
+		lhs = matchConstantType(lhs, type);
+		rhs = matchConstantType(rhs, type);
+	}
+	lhs = matchConstantType(lhs, rhs.type);
+	rhs = matchConstantType(rhs, lhs.type);
 
-		case TOKEN_SYMBOL_PLUS: return OPERATION_ADD;
-		case TOKEN_SYMBOL_MINUS: return OPERATION_SUBTRACT;
-		case TOKEN_SYMBOL_STAR: return OPERATION_MULTIPLY;
-		case TOKEN_SYMBOL_SLASH_FORWARD: return OPERATION_DIVIDE;
+	//constant subexpressions become a single constant
+	struct Operand folded;
+	if (lhs.variableID == 0 && rhs.variableID == 0 && foldConstants(op, lhs, rhs, &folded)) {
+		return folded;
+	}
+	if (isIdentityOperand(op, rhs, true)) {
+		return lhs;
+	}
+	if (isIdentityOperand(op, lhs, false)) {
+		return rhs;
+	}
+
+	struct Operand result = {nextVariableID, lhs.type, 0};
+	++nextVariableID;
+
+	switch (op) {
+		case OPERATION_ADD: insertValue(IR_ADD, 4); break;
+		case OPERATION_SUBTRACT: insertValue(IR_SUBTRACT, 4); break;
+		case OPERATION_MULTIPLY: insertValue(IR_MULTIPLY, 4); break;
+		case OPERATION_DIVIDE: insertValue(IR_DIVIDE, 4); break;
 
 		default:
-		unexpectedToken();
-		return -1; //will never return, to make the language server shut up
+		fprintf(stderr, "ERROR: attempted to insert unsupported instruction\n");
+		exit(1);
 	}
+	insertValue(result.variableID, 4);
+	insertOperand(lhs);
+	insertOperand(rhs);
+	++currentBlockInstructionCount;
+
+	return result;
 }
 
-//starts on the first token of the operation, ends
-uint32_t parseExpression(enum Operation lastOp) {
-	//get variable
-	uint32_t variableID = parseOperand();
+//pending operands and operators of the expressions being parsed, nested expressions (call arguments) work above the outer ones
+//OPERATION_NONE on the operator stack marks an open parenthesis
+static struct Operand* operandStack = NULL;
+static size_t operandStackCount = 0;
+static size_t operandStackCapacity = 0;
+static enum Operation* operatorStack = NULL;
+static size_t operatorStackCount = 0;
+static size_t operatorStackCapacity = 0;
+
+void pushOperand(struct Operand operand) {
+	if (operandStackCount == operandStackCapacity) {
+		operandStackCapacity = operandStackCapacity == 0 ? 64 : operandStackCapacity * 2;
+		operandStack = reallocParser(operandStack, operandStackCapacity * sizeof(struct Operand));
+	}
+	operandStack[operandStackCount] = operand;
+	++operandStackCount;
+}
 
-	//do complicated parsing
-	while (currentToken().type != TOKEN_SYMBOL_SEMICOLON) {
-		enum Operation op = parseOperation();
+void pushOperator(enum Operation op) {
+	if (operatorStackCount == operatorStackCapacity) {
+		operatorStackCapacity = operatorStackCapacity == 0 ? 64 : operatorStackCapacity * 2;
+		operatorStack = reallocParser(operatorStack, operatorStackCapacity * sizeof(enum Operation));
+	}
+	operatorStack[operatorStackCount] = op;
+	++operatorStackCount;
+}
+
+//applies the top operator to the top two operands
+void reduceOperator() {
+	--operatorStackCount;
+	enum Operation op = operatorStack[operatorStackCount];
 
-		//return early if gone down in precedence
-		if (operationPrecedence(op) < operationPrecedence(lastOp)) {
-			return variableID;
+	operandStackCount -= 2;
+	struct Operand lhs = operandStack[operandStackCount];
+	struct Operand rhs = operandStack[operandStackCount + 1];
+	pushOperand(insertArithmetic(op, lhs, rhs));
+}
+
+//reduces the operators above the base that bind at least as tightly as the precedence, stopping at open parentheses
+void reduceOperators(size_t operatorBase, size_t precedence) {
+	while (operatorStackCount > operatorBase) {
+		enum Operation top = operatorStack[operatorStackCount - 1];
+		if (top == OPERATION_NONE || operationPrecedence(top) < precedence) {
+			return;
 		}
-		
-		//recurse
-		uint32_t next = parseExpression(op);
+		reduceOperator();
+	}
+}
 
-		//emit bytecode
-		uint32_t result = nextVariableID;
-		++nextVariableID;
+//starts on the first token of the expression, ends on the first token after it
+//precedence climbing over explicit stacks, so long and deeply parenthesised expressions use constant c stack
+//equal precedence is left associative
+struct Operand parseExpression() {
+	size_t operandBase = operandStackCount;
+	size_t operatorBase = operatorStackCount;
+	size_t openParentheses = 0;
+
+	while (true) {
+		//operand, after any number of opening parentheses
+		while (currentToken().type == TOKEN_SYMBOL_PARENTHESIS_LEFT) {
+			pushOperator(OPERATION_NONE);
+			++openParentheses;
+			incrementToken();
+		}
+		pushOperand(parseOperand());
 
-		switch (op) {
-			case OPERATION_ADD: insertValue(-128, 4); break;
-			case OPERATION_SUBTRACT: insertValue(-129, 4); break;
-			case OPERATION_MULTIPLY: insertValue(-130, 4); break;
-			case OPERATION_DIVIDE: insertValue(-131, 4); break;
-			
-			default:
-			fprintf(stderr, "ERROR: attempted to insert unsupported instruction\n");
-			exit(1);
+		//closing parentheses reduce back to their opening one, a closing parenthesis with none open ends the expression
+		while (openParentheses > 0 && currentToken().type == TOKEN_SYMBOL_PARENTHESIS_RIGHT) {
+			reduceOperators(operatorBase, 0);
+			--operatorStackCount;
+			--openParentheses;
+			incrementToken();
 		}
-		insertValue(result, 4);
-		//test for constants
-		if (variableID == 0) {
 
+		enum Operation op = parseOperation();
+		if (op == OPERATION_NONE) {
+			break;
 		}
-		
-		++currentBlockInstructionCount;
+		reduceOperators(operatorBase, operationPrecedence(op));
+		pushOperator(op);
+		incrementToken();
+	}
 
-		//prepare for next loop
-		variableID = result;
+	if (openParentheses > 0) {
+		unexpectedToken();
 	}
+	reduceOperators(operatorBase, 0);
 
-	//return if end of statement
-	return variableID;
+	struct Operand result = operandStack[operandBase];
+	operandStackCount = operandBase;
+	return result;
 }
 
 //starts on the colon
-uint32_t parseVariableDefinition(struct Token identifier) {
+void parseVariableDefinition(struct Token identifier) {
 	//technically unnecessary check but why not
 	if (currentToken().type != TOKEN_SYMBOL_COLON) {
 		unexpectedToken();
 	}
+	uint32_t symbol = internIdentifier(identifier);
 	incrementToken();
 
 	//create bytecode variable declaration
-	insertValue((uint64_t)-1, 4); //variable declaration instruction
-	parseTypeIdentifier(); //assume next token is type identifier
-
-	uint32_t variableID = nextVariableID;
-	++nextVariableID;
+	struct ValueType type = parseTypeIdentifier(); //assume next token is type identifier
+	uint32_t variableID = insertDeclaration(type);
+	struct Operand value = {variableID, type, 0};
 
 	incrementToken();
 	switch (currentToken().type) {
 		case TOKEN_SYMBOL_SEMICOLON: //just declaration
 		incrementToken();
-		return variableID;
+		break;
 
 		case TOKEN_SYMBOL_EQUAL: //has assignment
 		incrementToken();
-		uint32_t expressionResult = parseExpression(OPERATION_NONE);
-
-		insertValue(-2, 4); //move
-		insertValue(variableID, 4); //into variable
-		insertValue(expressionResult, 4); //from expression
-		++currentBlockInstructionCount;
-
-		return variableID;
+		struct Operand initialiser = matchConstantType(parseExpression(), type);
+		insertMove(variableID, initialiser);
+		if (initialiser.variableID == 0) {
+			value = initialiser;
+		}
+		break;
 
 		default:
 		unexpectedToken();
-		return 0;
 	}
+
+	//defined after the initialiser, so the previous variable of the same name can be used in it
+	defineNamedVariable(symbol, variableID, type, value);
 }
 
-//starts on the identifier
-//returns ssa variable ID
-uint32_t parseIdentifier() {
+//starts on the equals, assigning creates a new ssa variable that the name then refers to
+void parseAssignment(struct Token identifier) {
+	struct NamedVariable* variable = findNamedVariable(identifier);
+	if (variable == NULL) {
+		fprintf(stderr, "ERROR: Assignment to undefined variable at file index %zu!\n", identifier.fileIndex);
+		exit(1);
+	}
+	uint32_t symbol = internIdentifier(identifier);
+	struct ValueType type = variable->type;
+	incrementToken();
+
+	struct Operand value = matchConstantType(parseExpression(), type);
+	uint32_t variableID = insertDeclaration(type);
+	insertMove(variableID, value);
+
+	if (value.variableID != 0) {
+		value.variableID = variableID;
+	}
+	defineNamedVariable(symbol, variableID, type, value);
+}
+
+//starts on the return keyword
+void parseReturn() {
+	incrementToken();
+
+	if (currentToken().type == TOKEN_SYMBOL_SEMICOLON) {
+		if (currentFunctionHasOutput) {
+			fprintf(stderr, "ERROR: Missing return value at file index %zu!\n", currentToken().fileIndex);
+			exit(1);
+		}
+		insertValue(IR_RETURN, 4);
+		++currentBlockInstructionCount;
+		return;
+	}
+
+	if (!currentFunctionHasOutput) {
+		fprintf(stderr, "ERROR: Return value in function without output at file index %zu!\n", currentToken().fileIndex);
+		exit(1);
+	}
+	struct Operand value = convertOperand(parseExpression(), currentFunctionOutputType);
+	insertValue(IR_RETURN, 4);
+	insertOperand(value);
+	++currentBlockInstructionCount;
+}
+
+//starts on the identifier, a statement
+void parseIdentifier() {
 	struct Token identifier = currentToken();
 	incrementToken();
 	
 	switch (currentToken().type) {
-		case TOKEN_SYMBOL_PARENTHESIS_LEFT: return parseFunction(identifier); //function call/definition
-		case TOKEN_SYMBOL_COLON: return parseVariableDefinition(identifier);
+		case TOKEN_SYMBOL_PARENTHESIS_LEFT: parseFunction(identifier); return; //function call/definition
+		case TOKEN_SYMBOL_COLON: parseVariableDefinition(identifier); return;
+		case TOKEN_SYMBOL_EQUAL: parseAssignment(identifier); return;
 
 		default:
 		unexpectedToken();
-		return 0;
 	}
 }
 
-//returns the ssa variable ID of whatever the operand refers to
+//returns the ssa variable or constant the operand refers to, parentheses are handled by parseExpression()
 //ends on the token after the operand
-uint32_t parseOperand() {
+struct Operand parseOperand() {
+	struct Operand operand = {0, defaultLiteralType, 0};
+
 	switch (currentToken().type) {
-		case TOKEN_IDENTIFIER: return parseIdentifier();
-		case TOKEN_LITERAL_STRING: return parseStringLiteral(currentToken());
+		case TOKEN_IDENTIFIER:
+		//function call with its output
+		if (nextToken().type == TOKEN_SYMBOL_PARENTHESIS_LEFT) {
+			uint32_t functionID = getFunctionID(currentToken());
+			incrementToken();
+			incrementToken();
+			return parseFunctionCall(functionID, true);
+		}
+
+		//variable
+		struct NamedVariable* variable = findNamedVariable(currentToken());
+		if (variable == NULL) {
+			fprintf(stderr, "ERROR: Undefined variable at file index %zu!\n", currentToken().fileIndex);
+			exit(1);
+		}
+		operand.variableID = variable->isConstant ? 0 : variable->variableID;
+		operand.type = variable->type;
+		operand.value = variable->value;
+		incrementToken();
+		return operand;
+
+		case TOKEN_LITERAL_STRING: {
+			struct Operand length;
+			operand = parseStringLiteral(currentToken(), &length);
+			incrementToken();
+			return operand;
+		}
 
-		case TOKEN_LITERAL_CHARACTER:
 		case TOKEN_LITERAL_INT:
+		operand.value = parseIntegerLiteral(currentToken());
+		incrementToken();
+		return operand;
+
+		case TOKEN_LITERAL_CHARACTER:
+		operand = parseCharacterLiteral(currentToken());
+		incrementToken();
+		return operand;
+
 		case TOKEN_LITERAL_FLOAT:
-		return 0; //inform that this will have to be processed later
+		operand = parseFloatLiteral(currentToken());
+		incrementToken();
+		return operand;
 
 		default:
 		unexpectedToken();
 	}
-	return 0;
+	return operand;
 }
 
 void parse() {
@@ -412,6 +1119,10 @@ void parse() {
 			parseIdentifier();
 			break;
 
+			case TOKEN_KEYWORD_RETURN:
+			parseReturn();
+			break;
+
 			//end of statement
 			case TOKEN_SYMBOL_SEMICOLON:
 			incrementToken();
@@ -429,15 +1140,14 @@ void parse() {
 	}
 
 	//a bit of debug info
-	printf("Parser exited via EOF");
+	//on stderr as stdout can be carrying the assembly
+	fprintf(stderr, "Parser exited via EOF\n");
 }
 
-struct ByteArray parseFile(FILE* filePtr) {
-	srcPtr = filePtr;
-
+//the tokeniser must already be reset
+struct ByteArray parseTokens() {
 	//setup
-	resetTokeniser(filePtr);
-	resetBytecodeGen(filePtr);
+	resetBytecodeGen();
 	resetState();
 
 	//do the thing
@@ -452,3 +1162,14 @@ struct ByteArray parseFile(FILE* filePtr) {
 	struct ByteArray bytecode = finaliseBytecode();
 	return bytecode;
 }
+
+
+struct ByteArray parseFile(const char* buffer, size_t length) {
+	resetTokeniserPrelexed(buffer, length);
+	return parseTokens();
+}
+
+struct ByteArray parseStream(FILE* filePtr) {
+	resetTokeniserStream(filePtr);
+	return parseTokens();
+}
\ No newline at end of file
@@ -5,4 +5,7 @@
 
 #include "byte_array.h"
 
-struct ByteArray parseFile(FILE* filePtr);
\ No newline at end of file
+//buffer is the whole source file
+struct ByteArray parseFile(const char* buffer, size_t length);
+//for files that cant be seeked or mapped, e.g. stdin
+struct ByteArray parseStream(FILE* filePtr);
\ No newline at end of file
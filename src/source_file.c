@@ -0,0 +1,102 @@
+#include "source_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//fallback for files that cant be mapped (pipes, special files, etc.)
+bool readSourceFile(int fd, struct SourceFile* source) {
+	size_t capacity = 4096;
+	size_t length = 0;
+	char* buffer = malloc(capacity);
+	if (buffer == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for source file!\n");
+		exit(1);
+	}
+
+	while (true) {
+		if (length == capacity) {
+			capacity *= 2;
+			char* grown = realloc(buffer, capacity);
+			if (grown == NULL) {
+				fprintf(stderr, "ERROR: Could not allocate memory for source file!\n");
+				exit(1);
+			}
+			buffer = grown;
+		}
+
+		ssize_t count = read(fd, buffer + length, capacity - length);
+		//interrupted by a signal before anything was read, which isnt a read error
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count < 0) {
+			free(buffer);
+			return false;
+		}
+		if (count == 0) {
+			break;
+		}
+		length += count;
+	}
+
+	source->ptr = buffer;
+	source->length = length;
+	source->mapped = false;
+	return true;
+}
+
+bool openSourceFile(const char* path, struct SourceFile* source) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		close(fd);
+		return false;
+	}
+
+	//mmap cant map empty files, and only regular files have a meaningful size
+	if (S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+		void* mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			//the tokeniser only ever walks forwards
+			madvise(mapping, fileStat.st_size, MADV_SEQUENTIAL);
+			close(fd);
+
+			source->ptr = mapping;
+			source->length = fileStat.st_size;
+			source->mapped = true;
+			return true;
+		}
+	}
+
+	bool success = readSourceFile(fd, source);
+	close(fd);
+	return success;
+}
+
+void closeSourceFile(struct SourceFile* source) {
+	if (source->ptr == NULL) {
+		source->length = 0;
+		return;
+	}
+
+	if (source->mapped) {
+		munmap((void*)source->ptr, source->length);
+	} else {
+		free((void*)source->ptr);
+	}
+
+	source->ptr = NULL;
+	source->length = 0;
+	source->mapped = false;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//the whole source file in memory, memory mapped when possible
+struct SourceFile {
+	const char* ptr;
+	size_t length;
+	bool mapped; //false when the file was read into an allocated buffer instead
+};
+
+//returns false if the file could not be opened or read
+bool openSourceFile(const char* path, struct SourceFile* source);
+void closeSourceFile(struct SourceFile* source); //nulls the pointer and zeroes the length
\ No newline at end of file
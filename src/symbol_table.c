@@ -0,0 +1,124 @@
+#include "symbol_table.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+//per symbol data, text is stored in the bytecode arena
+static const char** symbolTexts = NULL;
+static uint32_t* symbolLengths = NULL;
+static uint64_t* symbolHashes = NULL; //kept so growing the table doesnt rehash the text
+static uint32_t symbolsUsed = 0;
+static uint32_t symbolCapacity = 0;
+
+//open addressing with linear probing, slots hold symbols, capacity is a power of two
+static uint32_t* slots = NULL;
+static size_t slotCapacity = 0;
+
+void* reallocSymbolTable(void* ptr, size_t size) {
+	void* resized = realloc(ptr, size);
+	if (resized == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for symbol table!\n");
+		exit(1);
+	}
+	return resized;
+}
+
+//FNV-1a
+uint64_t hashSymbolText(const char* symbolTextPtr, size_t length) {
+	uint64_t hash = 0xcbf29ce484222325;
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= (uint8_t)symbolTextPtr[i];
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+void resizeSymbolSlots(size_t newCapacity) {
+	free(slots);
+	slots = reallocSymbolTable(NULL, newCapacity * sizeof(uint32_t));
+	memset(slots, 0xFF, newCapacity * sizeof(uint32_t)); //all SYMBOL_NONE
+	slotCapacity = newCapacity;
+
+	for (uint32_t symbol = 0; symbol < symbolsUsed; ++symbol) {
+		size_t slot = symbolHashes[symbol] & (slotCapacity - 1);
+		while (slots[slot] != SYMBOL_NONE) {
+			slot = (slot + 1) & (slotCapacity - 1);
+		}
+		slots[slot] = symbol;
+	}
+}
+
+void resetSymbolTable() {
+	symbolsUsed = 0;
+	resizeSymbolSlots(64);
+}
+
+//returns the slot holding the symbol, or the empty slot it would go in
+size_t findSymbolSlot(const char* symbolTextPtr, size_t length, uint64_t hash) {
+	size_t slot = hash & (slotCapacity - 1);
+	while (slots[slot] != SYMBOL_NONE) {
+		uint32_t symbol = slots[slot];
+		if (symbolHashes[symbol] == hash && symbolLengths[symbol] == length
+			&& memcmp(symbolTexts[symbol], symbolTextPtr, length) == 0) {
+			return slot;
+		}
+		slot = (slot + 1) & (slotCapacity - 1);
+	}
+	return slot;
+}
+
+uint32_t findSymbol(const char* symbolTextPtr, size_t length) {
+	return slots[findSymbolSlot(symbolTextPtr, length, hashSymbolText(symbolTextPtr, length))];
+}
+
+uint32_t internSymbol(const char* symbolTextPtr, size_t length) {
+	uint64_t hash = hashSymbolText(symbolTextPtr, length);
+	size_t slot = findSymbolSlot(symbolTextPtr, length, hash);
+	if (slots[slot] != SYMBOL_NONE) {
+		return slots[slot];
+	}
+
+	//copy text
+	char* textCopy = arenaAlloc(ARENA_BYTECODE, length);
+	memcpy(textCopy, symbolTextPtr, length);
+
+	//add symbol
+	if (symbolsUsed == symbolCapacity) {
+		symbolCapacity = symbolCapacity == 0 ? 64 : symbolCapacity * 2;
+		symbolTexts = reallocSymbolTable(symbolTexts, symbolCapacity * sizeof(const char*));
+		symbolLengths = reallocSymbolTable(symbolLengths, symbolCapacity * sizeof(uint32_t));
+		symbolHashes = reallocSymbolTable(symbolHashes, symbolCapacity * sizeof(uint64_t));
+	}
+	uint32_t symbol = symbolsUsed;
+	symbolTexts[symbol] = textCopy;
+	symbolLengths[symbol] = length;
+	symbolHashes[symbol] = hash;
+	++symbolsUsed;
+
+	slots[slot] = symbol;
+
+	//keep the load factor at or below a half
+	if ((size_t)symbolsUsed * 2 > slotCapacity) {
+		resizeSymbolSlots(slotCapacity * 2);
+	}
+
+	return symbol;
+}
+
+uint32_t symbolCount() {
+	return symbolsUsed;
+}
+
+const char* symbolText(uint32_t symbol) {
+	return symbolTexts[symbol];
+}
+
+size_t symbolLength(uint32_t symbol) {
+	return symbolLengths[symbol];
+}
\ No newline at end of file
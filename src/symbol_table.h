@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+//interned identifier strings, every unique string gets one symbol
+//symbols are dense indices starting from 0 in order of interning
+#define SYMBOL_NONE ((uint32_t)-1)
+
+//MUST be called before using other functions
+void resetSymbolTable();
+
+//identifiers are not null terminated
+uint32_t internSymbol(const char* text, size_t length);
+//returns SYMBOL_NONE if the text has not been interned
+uint32_t findSymbol(const char* text, size_t length);
+
+uint32_t symbolCount();
+//not null terminated
+const char* symbolText(uint32_t symbol);
+size_t symbolLength(uint32_t symbol);
\ No newline at end of file
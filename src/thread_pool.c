@@ -0,0 +1,81 @@
+#include "thread_pool.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+struct ParallelForState {
+	ParallelJob job;
+	void* context;
+	size_t jobCount;
+	atomic_size_t nextJob;
+};
+
+static size_t threadCountOverride = 0;
+
+size_t threadPoolSize() {
+	if (threadCountOverride != 0) {
+		return threadCountOverride;
+	}
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (cores < 1) {
+		return 1;
+	}
+	return cores;
+}
+
+void setThreadPoolSize(size_t threadCount) {
+	threadCountOverride = threadCount;
+}
+
+//workers take the next job index until there are none left, so uneven jobs balance out
+void* parallelForWorker(void* statePtr) {
+	struct ParallelForState* state = statePtr;
+	
+	size_t index = atomic_fetch_add(&state->nextJob, 1);
+	while (index < state->jobCount) {
+		state->job(state->context, index);
+		index = atomic_fetch_add(&state->nextJob, 1);
+	}
+	
+	return NULL;
+}
+
+void parallelFor(size_t jobCount, ParallelJob job, void* context) {
+	struct ParallelForState state;
+	state.job = job;
+	state.context = context;
+	state.jobCount = jobCount;
+	atomic_init(&state.nextJob, 0);
+
+	//the calling thread is also a worker
+	size_t threadCount = threadPoolSize();
+	if (threadCount > jobCount) {
+		threadCount = jobCount;
+	}
+	size_t extraThreadCount = threadCount > 0 ? threadCount - 1 : 0;
+
+	pthread_t* threads = calloc(extraThreadCount + 1, sizeof(pthread_t));
+	if (threads == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for thread pool!\n");
+		exit(1);
+	}
+
+	//if a thread cant be created the remaining jobs are picked up by the others
+	size_t startedCount = 0;
+	for (size_t i = 0; i < extraThreadCount; ++i) {
+		if (pthread_create(&threads[startedCount], NULL, parallelForWorker, &state) == 0) {
+			++startedCount;
+		}
+	}
+
+	parallelForWorker(&state);
+
+	for (size_t i = 0; i < startedCount; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+	free(threads);
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stddef.h>
+
+typedef void (*ParallelJob)(void* context, size_t index);
+
+//number of threads the pool will use, one per online core unless overridden
+size_t threadPoolSize();
+//0 goes back to one thread per online core, more threads than cores are allowed
+void setThreadPoolSize(size_t threadCount);
+
+//runs job(context, index) for every index below jobCount, spread over the pool
+//blocks until every job has completed, jobs may run in any order
+void parallelFor(size_t jobCount, ParallelJob job, void* context);
\ No newline at end of file
@@ -1,12 +1,82 @@
 #include "token.h"
 
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 void printToken(const struct Token token) {
 	printf("Type: %d,	Index: %zu,	Length: %zu,	Seperated: %d\n", 
 		token.type, token.fileIndex, token.length, token.seperatedFromPrevious);
 }
 
+void allocTokenStreamArrays(struct TokenStream* stream, size_t capacity) {
+	stream->types = realloc(stream->types, capacity * sizeof(uint8_t));
+	stream->fileIndices = realloc(stream->fileIndices, capacity * sizeof(uint32_t));
+	stream->lengths = realloc(stream->lengths, capacity * sizeof(uint32_t));
+	stream->seperated = realloc(stream->seperated, capacity * sizeof(uint8_t));
+	stream->builtinTypes = realloc(stream->builtinTypes, capacity * sizeof(uint8_t));
+	stream->sizeExps = realloc(stream->sizeExps, capacity * sizeof(uint8_t));
+	if (stream->types == NULL || stream->fileIndices == NULL || stream->lengths == NULL || stream->seperated == NULL
+		|| stream->builtinTypes == NULL || stream->sizeExps == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for token stream!\n");
+		exit(1);
+	}
+	stream->capacity = capacity;
+}
+
+struct TokenStream allocTokenStream(size_t capacity) {
+	struct TokenStream stream = {NULL, NULL, NULL, NULL, NULL, NULL, 0, 0};
+	if (capacity == 0) {
+		capacity = 1;
+	}
+	allocTokenStreamArrays(&stream, capacity);
+	return stream;
+}
+
+void freeTokenStream(struct TokenStream* stream) {
+	free(stream->types);
+	free(stream->fileIndices);
+	free(stream->lengths);
+	free(stream->seperated);
+	free(stream->builtinTypes);
+	free(stream->sizeExps);
+
+	stream->types = NULL;
+	stream->fileIndices = NULL;
+	stream->lengths = NULL;
+	stream->seperated = NULL;
+	stream->builtinTypes = NULL;
+	stream->sizeExps = NULL;
+	stream->count = 0;
+	stream->capacity = 0;
+}
+
+void appendToTokenStream(struct TokenStream* stream, struct Token token) {
+	if (stream->count == stream->capacity) {
+		allocTokenStreamArrays(stream, stream->capacity * 2);
+	}
+
+	size_t index = stream->count;
+	stream->types[index] = token.type;
+	stream->fileIndices[index] = token.fileIndex;
+	stream->lengths[index] = token.length;
+	stream->seperated[index] = token.seperatedFromPrevious;
+	stream->builtinTypes[index] = token.builtinType;
+	stream->sizeExps[index] = token.sizeExp;
+	++stream->count;
+}
+
+struct Token getStreamToken(const struct TokenStream* stream, size_t index) {
+	struct Token token;
+	token.type = stream->types[index];
+	token.seperatedFromPrevious = stream->seperated[index];
+	token.builtinType = stream->builtinTypes[index];
+	token.sizeExp = stream->sizeExps[index];
+	token.fileIndex = stream->fileIndices[index];
+	token.length = stream->lengths[index];
+	return token;
+}
+
 enum TokenType charToSymbolTokenType(char c) {
 	switch (c) {
 		case '(': return TOKEN_SYMBOL_PARENTHESIS_LEFT;
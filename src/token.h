@@ -2,6 +2,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 enum TokenType {
 	//misc
@@ -18,6 +19,13 @@ enum TokenType {
 	TOKEN_LITERAL_FLOAT,
 
 	//keyword
+	TOKEN_KEYWORD_IF,
+	TOKEN_KEYWORD_ELSE,
+	TOKEN_KEYWORD_WHILE,
+	TOKEN_KEYWORD_RETURN,
+
+	//builtin type name, e.g. i32 or bool
+	TOKEN_BUILTIN_TYPE,
 
 	//symbol
 	TOKEN_SYMBOL_PARENTHESIS_LEFT,
@@ -42,13 +50,48 @@ enum TokenType {
 	TOKEN_SYMBOL_SLASH_BACKWARD,
 };
 
+enum BuiltinType {
+	BUILTIN_TYPE_NONE,
+
+	BUILTIN_TYPE_INTEGER,
+	BUILTIN_TYPE_UNSIGNED,
+	BUILTIN_TYPE_FLOAT,
+	BUILTIN_TYPE_BOOL,
+};
+
+//ordered to avoid padding
 struct Token {
 	enum TokenType type;
+	bool seperatedFromPrevious;
+
+	//only set for TOKEN_BUILTIN_TYPE
+	uint8_t builtinType;
+	uint8_t sizeExp; //the size is 2^sizeExp, all 1s is the word size
+
 	size_t fileIndex;
 	size_t length;
-	bool seperatedFromPrevious;
 };
 
 void printToken(const struct Token token);
 
+//compact struct of arrays token storage, 12 bytes per token
+//file indices and lengths are 32 bit so sources over 4GiB cant be stored
+struct TokenStream {
+	uint8_t* types;
+	uint32_t* fileIndices;
+	uint32_t* lengths;
+	uint8_t* seperated;
+	uint8_t* builtinTypes;
+	uint8_t* sizeExps;
+	size_t count;
+	size_t capacity;
+};
+
+struct TokenStream allocTokenStream(size_t capacity);
+void freeTokenStream(struct TokenStream* stream); //nulls the pointers and zeroes the count
+
+//grows the stream if needed
+void appendToTokenStream(struct TokenStream* stream, struct Token token);
+struct Token getStreamToken(const struct TokenStream* stream, size_t index);
+
 enum TokenType charToSymbolTokenType(char c);
\ No newline at end of file
@@ -1,50 +1,68 @@
 #include "tokeniser.h"
 
-#include <ctype.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "char_scan.h"
+#include "keyword.h"
+#include "thread_pool.h"
 #include "token.h"
 
-static FILE* srcPtr = NULL;
+//sources at least this long are lexed in parallel, smaller ones arent worth starting threads for
+#define PARALLEL_LEX_MIN_LENGTH (8 * 1024 * 1024)
+//more chunks than threads so uneven chunks balance out
+#define PARALLEL_LEX_CHUNKS_PER_THREAD 4
+#define PARALLEL_LEX_MIN_CHUNK_LENGTH (1024 * 1024)
 
-static struct Token tokenCache[2];
-//swapped on token increment
-static struct Token* currentTokenPtr = &tokenCache[0];
-static struct Token* nextTokenPtr = &tokenCache[1];
+//source buffer, tokens are slices of this
+static const char* srcStart = NULL;
+static const char* srcEnd = NULL;
 
-//returns true if whitespace was skipped
-bool skipWhitespace() {
-	bool skipped = false;
-	char c = fgetc(srcPtr);
-	while (isspace(c)) {
-		c = fgetc(srcPtr);
-		skipped = true;
-	}
-	//seek back as to not skip characters
-	//if eof dont seek so that it can be properly detected later
-	if(c != EOF) {
-		fseek(srcPtr, -1, SEEK_CUR);
-	}
-	
-	return skipped;
+//prelexed mode, the whole file is lexed once up front
+static bool prelexed = false;
+static struct TokenStream tokenStream = {NULL, NULL, NULL, NULL, NULL, NULL, 0, 0};
+static size_t streamIndex = 0; //index of the current token
+
+//on demand mode, tokens are lexed as they are peeked
+//ring buffer starting at the current token
+static struct Token* lookahead = NULL;
+static size_t lookaheadCapacity = 0;
+static size_t lookaheadStart = 0;
+static size_t lookaheadCount = 0;
+
+//streamed mode, on demand lexing from a sliding window over a non seekable file
+//only the text from the previous token onwards is kept, so memory is bounded by the tokens being looked at
+#define STREAM_WINDOW_INITIAL_CAPACITY (64 * 1024)
+static FILE* streamPtr = NULL;
+static char* window = NULL;
+static size_t windowCapacity = 0;
+static size_t windowLength = 0;
+static size_t windowFileIndex = 0; //file index of the first character in the window
+static size_t retainedFileIndex = 0; //text before this is no longer needed
+static bool streamEnded = false;
+
+//the lexing functions only use their arguments so chunks of the source can be lexed in parallel
+//end is one past the last character that may be read
+
+//returns the first non whitespace character at or after the cursor
+const char* skipWhitespace(const char* cursor, const char* end) {
+	return scanWhitespace(cursor, end);
 }
 
-//literalType can be either " or '
-void skipTextLiteral(char literalType) {
-	bool endFound = false;
+//literalType can be either " or ', cursor starts after the opening quote
+//returns the character after the closing quote
+const char* skipTextLiteral(const char* cursor, const char* end, char literalType) {
 	bool escape = false;
-	char c = 0;
-	while (!endFound) {
-		c = fgetc(srcPtr);
-
-		//this is horrible
-		if (c == EOF) {
-			endFound = true;
-		} else if (c == literalType && !escape) {
-			endFound = true;
+	while (cursor < end) {
+		char c = *cursor;
+		++cursor;
+
+		if (c == literalType && !escape) {
+			break;
 		} else if (c == '\\') {
 			//this method will correctly handle the situation where you are escaping the escape character
 			escape = !escape;
@@ -52,36 +70,44 @@ void skipTextLiteral(char literalType) {
 			escape = false;
 		}
 	}
+	return cursor;
 }
 
-enum TokenType skipNumberLiteral(char firstChar) {
+//cursor starts on the first character of the literal, is moved to the character after it
+//start is only used for error messages
+enum TokenType skipNumberLiteral(const char** cursorPtr, const char* start, const char* end) {
+	const char* cursor = *cursorPtr;
+
 	//test for different base
 	bool based = false;
-	if (firstChar == '0') {
-		char nextChar = fgetc(srcPtr);
+	if (*cursor == '0' && cursor + 1 < end) {
 		//no octal because octal is STUPID (maybe later)
-		if (nextChar == 'x' || nextChar == 'b') {
+		if (cursor[1] == 'x' || cursor[1] == 'b') {
 			based = true;
 			//start after the x
-			firstChar = fgetc(srcPtr);
+			cursor += 2;
 		}
 	}
 
-	//do the skipping
+	//do the skipping, hex digits include letters so based literals take the whole run and the parser checks the digits
 	bool decimal = false;
-	char c = firstChar;
-	while (isdigit(c) || c == '.') {
-		c = fgetc(srcPtr);
-		if (c == '.') {
-			decimal = true;
-		}
+	if (based) {
+		cursor = scanIdentifier(cursor, end);
+	} else {
+		cursor = scanDigits(cursor, end);
+	}
+	while (cursor < end && *cursor == '.') {
+		decimal = true;
+		cursor = scanDigits(cursor + 1, end);
 	}
 
 	//smidge of error checking
 	if (decimal && based) {
-		fprintf(stderr, "ERROR: Number literal with base and decimal point at file index %zu\n", ftell(srcPtr));
+		fprintf(stderr, "ERROR: Number literal with base and decimal point at file index %zu\n", (size_t)(cursor - start));
 		exit(1);
 	}
+
+	*cursorPtr = cursor;
 	
 	//return token type
 	if (decimal) {
@@ -90,40 +116,39 @@ enum TokenType skipNumberLiteral(char firstChar) {
 	return TOKEN_LITERAL_INT;
 }
 
-void skipIdentifier() {
-	char c = '_'; //fullfills while condition
-	while (isalnum(c) || c == '_') {
-		c = fgetc(srcPtr);
-	}
-	//seek back as to not skip characters
-	fseek(srcPtr, -1, SEEK_CUR);
+//returns the character after the identifier
+const char* skipIdentifier(const char* cursor, const char* end) {
+	return scanIdentifier(cursor, end);
 }
 
-struct Token getToken(size_t searchIndex) {
+//file indices are relative to start
+struct Token lexToken(const char* start, const char* end, size_t searchIndex) {
 	struct Token token;
 	//initialise default values
 	token.type = TOKEN_UNDEFINED;
 	token.fileIndex = 0;
 	token.length = 1;
 	token.seperatedFromPrevious = false;
+	token.builtinType = BUILTIN_TYPE_NONE;
+	token.sizeExp = 0;
 	
-	//seek to search index
-	fseek(srcPtr, searchIndex, SEEK_SET);
-
 	//skip whitespace and set some token data
-	token.seperatedFromPrevious = skipWhitespace();
-	token.fileIndex = ftell(srcPtr);
-
-	//determine token type and length
-	char firstChar = fgetc(srcPtr);
+	const char* tokenStart = start + searchIndex;
+	const char* cursor = skipWhitespace(tokenStart, end);
+	token.seperatedFromPrevious = cursor != tokenStart;
+	token.fileIndex = cursor - start;
+	tokenStart = cursor;
 
 	//check for eof
-	if (firstChar == EOF) {
+	if (cursor >= end) {
 		token.type = TOKEN_EOF;
 		token.length = 0;
 		return token;
 	}
 
+	//determine token type and length
+	char firstChar = *cursor;
+
 	//check if symbol token
 	token.type = charToSymbolTokenType(firstChar);
 	if (token.type != TOKEN_UNDEFINED) {
@@ -133,62 +158,478 @@ struct Token getToken(size_t searchIndex) {
 
 	//check for text literals
 	if (firstChar == '"' || firstChar == '\'') {
-		skipTextLiteral(firstChar);
+		cursor = skipTextLiteral(cursor + 1, end, firstChar);
 		if (firstChar == '"') {token.type = TOKEN_LITERAL_STRING;}
 		else {token.type = TOKEN_LITERAL_CHARACTER;}
-		token.length = ftell(srcPtr) - token.fileIndex;
+		token.length = cursor - tokenStart;
 		return token;
 	}
 
 	//check if number literal
-	if (isdigit(firstChar)) {
-		token.type = skipNumberLiteral(firstChar);
-		token.length = ftell(srcPtr) - token.fileIndex;
+	if (charIsClass(firstChar, CHAR_CLASS_DIGIT)) {
+		token.type = skipNumberLiteral(&cursor, start, end);
+		token.length = cursor - tokenStart;
 		return token;
 	}
 
 	//check if identifier or keyword
-	if (isalpha(firstChar) || firstChar == '_') {
-		skipIdentifier();
-		token.length = ftell(srcPtr) - token.fileIndex;
-		token.type = TOKEN_IDENTIFIER; //TODO check for keywords
+	if (charIsClass(firstChar, CHAR_CLASS_ALPHA | CHAR_CLASS_UNDERSCORE)) {
+		cursor = skipIdentifier(cursor, end);
+		token.length = cursor - tokenStart;
+		token.type = TOKEN_IDENTIFIER;
+
+		const struct Keyword* keyword = findKeyword(tokenStart, token.length);
+		if (keyword != NULL) {
+			token.type = keyword->type;
+			token.builtinType = keyword->builtinType;
+			token.sizeExp = keyword->sizeExp;
+		}
 		//last so no premature return
 	}
 
 	return token;
 }
 
-void resetTokeniser(FILE* filePtr) {
-	srcPtr = filePtr;
-	
-	//cache initial tokens
-	*currentTokenPtr = getToken(0);
-	size_t searchIndex = currentTokenPtr->fileIndex + currentTokenPtr->length;
-	*nextTokenPtr = getToken(searchIndex);
+//discards text that is no longer needed, grows the window if that wasnt enough, then reads more of the stream
+void fillWindow() {
+	size_t discardLength = retainedFileIndex - windowFileIndex;
+	memmove(window, window + discardLength, windowLength - discardLength);
+	windowLength -= discardLength;
+	windowFileIndex += discardLength;
+
+	if (windowLength == windowCapacity) {
+		windowCapacity *= 2;
+		window = realloc(window, windowCapacity);
+		if (window == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for source window!\n");
+			exit(1);
+		}
+	}
+
+	windowLength += fread(window + windowLength, 1, windowCapacity - windowLength, streamPtr);
+	if (ferror(streamPtr)) {
+		fprintf(stderr, "ERROR: Could not read source stream!\n");
+		exit(1);
+	}
+	if (feof(streamPtr)) {
+		streamEnded = true;
+	}
+}
+
+struct Token getStreamedToken(size_t searchIndex) {
+	while (true) {
+		size_t windowEndIndex = windowFileIndex + windowLength;
+		struct Token token = lexToken(window, window + windowLength, searchIndex - windowFileIndex);
+		token.fileIndex += windowFileIndex;
+
+		//a token touching the end of the window might carry on past it, so relex once more is read
+		if (streamEnded || token.fileIndex + token.length < windowEndIndex) {
+			return token;
+		}
+		fillWindow();
+	}
+}
+
+struct Token getToken(size_t searchIndex) {
+	if (streamPtr != NULL) {
+		return getStreamedToken(searchIndex);
+	}
+	return lexToken(srcStart, srcEnd, searchIndex);
+}
+
+//lexes everything between start and end, the stream always ends with an eof token
+struct TokenStream lexRange(const char* start, const char* end) {
+	//rough guess of one token every 4 characters, grows if wrong
+	struct TokenStream stream = allocTokenStream((end - start) / 4 + 16);
+
+	struct Token token;
+	size_t searchIndex = 0;
+	do {
+		token = lexToken(start, end, searchIndex);
+		appendToTokenStream(&stream, token);
+		searchIndex = token.fileIndex + token.length;
+	} while (token.type != TOKEN_EOF);
+
+	return stream;
+}
+
+//cursor is on the opening quote, returns the character after the closing quote
+//a quote is escaped when it follows an odd number of backslashes, same as skipTextLiteral()
+const char* skipTextLiteralFast(const char* cursor, const char* end) {
+	char literalType = *cursor;
+	const char* contentStart = cursor + 1;
+	cursor = contentStart;
+
+	while (cursor < end) {
+		const char* quote = memchr(cursor, literalType, end - cursor);
+		if (quote == NULL) {
+			return end;
+		}
+
+		size_t backslashCount = 0;
+		while (quote - backslashCount > contentStart && quote[-1 - (ptrdiff_t)backslashCount] == '\\') {
+			++backslashCount;
+		}
+
+		cursor = quote + 1;
+		if (backslashCount % 2 == 0) {
+			return cursor;
+		}
+	}
+	return end;
+}
+
+//positions of the next quote of each type, as indices into the source being split
+//nothing is cached until the first search, pointers from different searches are never compared
+struct QuoteCache {
+	bool searched;
+	size_t nextDouble;
+	size_t nextSingle;
+};
+
+//index of the first quote at or after the index, or length if there is none
+size_t findQuoteIndex(const char* start, size_t index, size_t length, char quote) {
+	const char* found = memchr(start + index, quote, length - index);
+	return found == NULL ? length : (size_t)(found - start);
+}
+
+//first quote of either type at or after the cursor, or end
+//cached positions are only searched again once the cursor passes them
+const char* findNextQuote(const char* start, const char* cursor, const char* end, struct QuoteCache* cache) {
+	size_t index = cursor - start;
+	size_t length = end - start;
+	if (!cache->searched || cache->nextDouble < index) {
+		cache->nextDouble = findQuoteIndex(start, index, length, '"');
+	}
+	if (!cache->searched || cache->nextSingle < index) {
+		cache->nextSingle = findQuoteIndex(start, index, length, '\'');
+	}
+	cache->searched = true;
+	return start + (cache->nextDouble < cache->nextSingle ? cache->nextDouble : cache->nextSingle);
+}
+
+//splits the source at newlines outside of text literals, aiming for evenly sized chunks
+//a chunk starts on the newline so the first token is still marked as seperated
+//no token can cross a boundary since newlines only appear in whitespace and literals
+//boundaries must have room for targetChunkCount + 1 entries, returns the actual chunk count
+size_t findChunkBoundaries(const char* start, const char* end, size_t targetChunkCount, size_t* boundaries) {
+	size_t length = end - start;
+	size_t chunkCount = 0;
+	boundaries[0] = 0;
+
+	//everything before the cursor has been checked and the cursor is outside of any literal
+	const char* cursor = start;
+	struct QuoteCache quotes = {false, 0, 0};
+
+	for (size_t i = 1; i < targetChunkCount; ++i) {
+		const char* target = start + length * i / targetChunkCount;
+		if (target < cursor) {
+			target = cursor;
+		}
+
+		//find the first newline after the target that isnt in a literal
+		const char* boundary = NULL;
+		while (boundary == NULL && target < end) {
+			const char* newline = memchr(target, '\n', end - target);
+			if (newline == NULL) {
+				break;
+			}
+
+			//every quote outside a literal starts one, so skip over literals until past the newline
+			const char* quote = findNextQuote(start, cursor, end, &quotes);
+			if (quote > newline) {
+				boundary = newline;
+				cursor = newline;
+			} else {
+				cursor = skipTextLiteralFast(quote, end);
+				if (target < cursor) {
+					target = cursor;
+				}
+			}
+		}
+
+		if (boundary == NULL) {
+			break;
+		}
+		if ((size_t)(boundary - start) > boundaries[chunkCount]) {
+			++chunkCount;
+			boundaries[chunkCount] = boundary - start;
+		}
+	}
+
+	++chunkCount;
+	boundaries[chunkCount] = length;
+	return chunkCount;
+}
+
+struct ParallelLexState {
+	const char* start;
+	const size_t* boundaries;
+	size_t chunkCount;
+
+	struct TokenStream* chunkStreams;
+	size_t* chunkTokenOffsets; //index of each chunks first token in the final stream
+	struct TokenStream* stream;
+};
+
+void lexChunkJob(void* statePtr, size_t index) {
+	struct ParallelLexState* state = statePtr;
+	const char* chunkStart = state->start + state->boundaries[index];
+	const char* chunkEnd = state->start + state->boundaries[index + 1];
+
+	state->chunkStreams[index] = lexRange(chunkStart, chunkEnd);
+
+	//only the last chunk keeps its eof token
+	if (index + 1 < state->chunkCount) {
+		--state->chunkStreams[index].count;
+	}
+}
+
+//copies a chunk into the final stream, fixing up file indices to be relative to the whole source
+void stitchChunkJob(void* statePtr, size_t index) {
+	struct ParallelLexState* state = statePtr;
+	struct TokenStream* chunk = &state->chunkStreams[index];
+	struct TokenStream* stream = state->stream;
+	size_t offset = state->chunkTokenOffsets[index];
+	uint32_t chunkFileIndex = state->boundaries[index];
+
+	memcpy(stream->types + offset, chunk->types, chunk->count * sizeof(uint8_t));
+	memcpy(stream->lengths + offset, chunk->lengths, chunk->count * sizeof(uint32_t));
+	memcpy(stream->seperated + offset, chunk->seperated, chunk->count * sizeof(uint8_t));
+	memcpy(stream->builtinTypes + offset, chunk->builtinTypes, chunk->count * sizeof(uint8_t));
+	memcpy(stream->sizeExps + offset, chunk->sizeExps, chunk->count * sizeof(uint8_t));
+	for (size_t i = 0; i < chunk->count; ++i) {
+		stream->fileIndices[offset + i] = chunk->fileIndices[i] + chunkFileIndex;
+	}
+
+	freeTokenStream(chunk);
+}
+
+struct TokenStream lexParallel(const char* start, const char* end) {
+	//the scanner is selected lazily, which isnt thread safe
+	initCharScanner();
+
+	size_t targetChunkCount = threadPoolSize() * PARALLEL_LEX_CHUNKS_PER_THREAD;
+	size_t maxChunkCount = (end - start) / PARALLEL_LEX_MIN_CHUNK_LENGTH;
+	if (targetChunkCount > maxChunkCount) {
+		targetChunkCount = maxChunkCount;
+	}
+	if (targetChunkCount < 1) {
+		targetChunkCount = 1;
+	}
+
+	struct ParallelLexState state;
+	state.start = start;
+
+	size_t* boundaries = calloc(targetChunkCount + 1, sizeof(size_t));
+	state.chunkStreams = calloc(targetChunkCount, sizeof(struct TokenStream));
+	state.chunkTokenOffsets = calloc(targetChunkCount, sizeof(size_t));
+	if (boundaries == NULL || state.chunkStreams == NULL || state.chunkTokenOffsets == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for parallel lexing!\n");
+		exit(1);
+	}
+	state.chunkCount = findChunkBoundaries(start, end, targetChunkCount, boundaries);
+	state.boundaries = boundaries;
+
+	parallelFor(state.chunkCount, lexChunkJob, &state);
+
+	//lay out the chunks one after another
+	size_t tokenCount = 0;
+	for (size_t i = 0; i < state.chunkCount; ++i) {
+		state.chunkTokenOffsets[i] = tokenCount;
+		tokenCount += state.chunkStreams[i].count;
+	}
+
+	struct TokenStream stream = allocTokenStream(tokenCount);
+	stream.count = tokenCount;
+	state.stream = &stream;
+
+	parallelFor(state.chunkCount, stitchChunkJob, &state);
+
+	free(boundaries);
+	free(state.chunkStreams);
+	free(state.chunkTokenOffsets);
+
+	return stream;
+}
+
+//lexes one more token into the lookahead buffer
+void lexLookahead() {
+	//grow and unwrap the ring buffer if full
+	if (lookaheadCount == lookaheadCapacity) {
+		size_t newCapacity = lookaheadCapacity == 0 ? 4 : lookaheadCapacity * 2;
+		struct Token* grown = malloc(newCapacity * sizeof(struct Token));
+		if (grown == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for token lookahead!\n");
+			exit(1);
+		}
+		for (size_t i = 0; i < lookaheadCount; ++i) {
+			grown[i] = lookahead[(lookaheadStart + i) % lookaheadCapacity];
+		}
+		free(lookahead);
+		lookahead = grown;
+		lookaheadCapacity = newCapacity;
+		lookaheadStart = 0;
+	}
+
+	size_t searchIndex = 0;
+	if (lookaheadCount > 0) {
+		struct Token last = lookahead[(lookaheadStart + lookaheadCount - 1) % lookaheadCapacity];
+		searchIndex = last.fileIndex + last.length;
+	}
+	lookahead[(lookaheadStart + lookaheadCount) % lookaheadCapacity] = getToken(searchIndex);
+	++lookaheadCount;
+}
+
+void clearTokeniserState() {
+	prelexed = false;
+	freeTokenStream(&tokenStream);
+	streamIndex = 0;
+
+	lookaheadStart = 0;
+	lookaheadCount = 0;
+
+	streamPtr = NULL;
+	windowLength = 0;
+	windowFileIndex = 0;
+	retainedFileIndex = 0;
+	streamEnded = false;
+}
+
+void resetTokeniser(const char* buffer, size_t length) {
+	srcStart = buffer;
+	srcEnd = buffer + length;
+	clearTokeniserState();
+
+	//cache initial token
+	lexLookahead();
+}
+
+void resetTokeniserStream(FILE* filePtr) {
+	srcStart = NULL;
+	srcEnd = NULL;
+	clearTokeniserState();
+
+	streamPtr = filePtr;
+	if (window == NULL) {
+		windowCapacity = STREAM_WINDOW_INITIAL_CAPACITY;
+		window = malloc(windowCapacity);
+		if (window == NULL) {
+			fprintf(stderr, "ERROR: Could not allocate memory for source window!\n");
+			exit(1);
+		}
+	}
+
+	//cache initial token
+	lexLookahead();
+}
+
+void resetTokeniserPrelexed(const char* buffer, size_t length) {
+	//token stream indices are 32 bit
+	if (length > UINT32_MAX) {
+		resetTokeniser(buffer, length);
+		return;
+	}
+
+	srcStart = buffer;
+	srcEnd = buffer + length;
+	clearTokeniserState();
+
+	if (length >= PARALLEL_LEX_MIN_LENGTH && threadPoolSize() > 1) {
+		tokenStream = lexParallel(buffer, buffer + length);
+	} else {
+		tokenStream = lexRange(buffer, buffer + length);
+	}
+
+	prelexed = true;
 }
 
 void incrementToken() {
-	//swap pointers
-	struct Token* tokenPtrTemp = currentTokenPtr;
-	currentTokenPtr = nextTokenPtr;
-	nextTokenPtr = tokenPtrTemp;
+	if (prelexed) {
+		//stay on the eof token
+		if (streamIndex + 1 < tokenStream.count) {
+			++streamIndex;
+		}
+		return;
+	}
 
-	//cache next token
-	size_t searchIndex = currentTokenPtr->fileIndex + currentTokenPtr->length;
-	*nextTokenPtr = getToken(searchIndex);
+	//make sure there is a token to move to
+	if (lookaheadCount < 2) {
+		//stay on the eof token
+		if (lookahead[lookaheadStart].type == TOKEN_EOF) {
+			return;
+		}
+		lexLookahead();
+	}
+	//the token being moved past is still needed, e.g. the identifier before a parenthesis
+	retainedFileIndex = lookahead[lookaheadStart].fileIndex;
+	lookaheadStart = (lookaheadStart + 1) % lookaheadCapacity;
+	--lookaheadCount;
+}
+
+struct Token peekToken(size_t n) {
+	if (prelexed) {
+		size_t index = streamIndex + n;
+		if (index >= tokenStream.count) {
+			index = tokenStream.count - 1; //eof
+		}
+		return getStreamToken(&tokenStream, index);
+	}
+
+	while (lookaheadCount <= n) {
+		//nothing after eof
+		struct Token last = lookahead[(lookaheadStart + lookaheadCount - 1) % lookaheadCapacity];
+		if (last.type == TOKEN_EOF) {
+			return last;
+		}
+		lexLookahead();
+	}
+	return lookahead[(lookaheadStart + n) % lookaheadCapacity];
 }
 
 struct Token currentToken() {
-	return *currentTokenPtr;
+	return peekToken(0);
 }
 
 struct Token nextToken() {
-	return *nextTokenPtr;
+	return peekToken(1);
+}
+
+const char* tokenText(struct Token token) {
+	if (streamPtr != NULL) {
+		if (token.fileIndex < windowFileIndex) {
+			fprintf(stderr, "ERROR: Token at file index %zu is no longer in the source window!\n", token.fileIndex);
+			exit(1);
+		}
+		return window + (token.fileIndex - windowFileIndex);
+	}
+	return srcStart + token.fileIndex;
 }
 
 void setTokeniserIndex(size_t index) {
-	//cache initial tokens
-	*currentTokenPtr = getToken(index);
-	index = currentTokenPtr->fileIndex + currentTokenPtr->length;
-	*nextTokenPtr = getToken(index);
+	if (prelexed) {
+		//find the first token at or after the index
+		size_t low = 0;
+		size_t high = tokenStream.count - 1; //eof is always last
+		while (low < high) {
+			size_t middle = low + (high - low) / 2;
+			if (tokenStream.fileIndices[middle] < index) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		streamIndex = low;
+		return;
+	}
+
+	if (streamPtr != NULL && index < windowFileIndex) {
+		fprintf(stderr, "ERROR: Cannot move the tokeniser back to file index %zu on a stream!\n", index);
+		exit(1);
+	}
+
+	//cache initial token
+	lookaheadStart = 0;
+	lookaheadCount = 1;
+	lookahead[0] = getToken(index);
 }
\ No newline at end of file
@@ -6,10 +6,22 @@
 #include "token.h"
 
 //MUST be called before using other functions
-void resetTokeniser(FILE* filePtr);
+//the buffer must outlive the tokeniser, tokens are slices of it
+//tokens are lexed on demand
+void resetTokeniser(const char* buffer, size_t length);
+//tokens are lexed on demand from a file that doesnt need to be seekable, e.g. stdin
+//only the text from the token before the current one onwards stays available to tokenText()
+void resetTokeniserStream(FILE* filePtr);
+//the whole buffer is lexed up front into a token stream, falls back to on demand for sources over 4GiB
+void resetTokeniserPrelexed(const char* buffer, size_t length);
 
 void incrementToken();
 struct Token currentToken();
 struct Token nextToken();
+//n tokens ahead of the current token, 0 is the current token, anything past the end is eof
+struct Token peekToken(size_t n);
+
+//pointer to the first character of the token in the source buffer, not null terminated
+const char* tokenText(struct Token token);
 
 void setTokeniserIndex(size_t index);
\ No newline at end of file
@@ -2,48 +2,45 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-//file details
-static FILE* ssaPtr = NULL;
-static FILE* asmPtr = NULL;
+#include "arena.h"
+#include "bytecode_reader.h"
+#include "ir.h"
+#include "ir_passes.h"
+#include "magic_division.h"
+#include "x86_emit.h"
+#include "x86_regalloc.h"
+
+//magic number, version and the three section offsets
+#define BYTECODE_HEADER_LENGTH 56
+
+//bytecode being compiled, kept in memory
+static struct BytecodeReader ssa = {NULL, 0, 0};
 
 static size_t functionTableOffset = 0;
 static size_t staticVariablesOffset = 0;
 static size_t programLogicOffset = 0;
+static bool hasFunctionIndex = false;
+static size_t functionIndexOffset = 0;
+static struct IRFunctionIndex functionIndex = {0, NULL, NULL, NULL};
 
-static size_t lowestStaticID = 4294967295;
-
-//register variables
-static bool registerUsage[16];
-static const int registerPriorities[] = {
-	12, 13, 14, 15, 1, //fancier register allocation later, all callee saved
-};
-
-int allocateRegister() {
-	for (size_t i = 0; i < sizeof(registerPriorities) / sizeof(int); ++i) {
-		if (!registerUsage[registerPriorities[i]]) {
-			registerUsage[registerPriorities[i]] = true;
-			return registerPriorities[i];
-		}
-	}
-	return -1;
-}
+//function identifiers by ID, loaded once from the function table
+static size_t userFunctionCount = 0;
+static size_t specFunctionCount = 0;
+static const char** userFunctionIdentifiers = NULL;
+static const char** specFunctionIdentifiers = NULL; //indexed by UINT32_MAX - ID
 
 void generateStaticVariable() {
-	size_t variableID;
-	fread(&variableID, 4, 1, ssaPtr);
-
-	//set label
-	fprintf(asmPtr, "	sv_%zu ", variableID);
+	size_t variableID = readU32(&ssa);
 
 	//skip type, it doesnt matter here
-	fseek(ssaPtr, 1, SEEK_CUR);
+	skipBytecode(&ssa, 1);
 	//get size, it does matter here
-	size_t sizeExp = 0;
-	fread(&sizeExp, 1, 1, ssaPtr);
+	size_t sizeExp = readU8(&ssa);
 	if (sizeExp < 3) {
 		fprintf(stderr, "ERROR: Size exponents less than 3 currently not supported\n");
 		exit(1);
@@ -51,257 +48,970 @@ void generateStaticVariable() {
 
 	//set data size
 	size_t dataSize = 1 << (sizeExp - 3);
-	switch (sizeExp) {
-		case 3: fprintf(asmPtr, "db "); break;
-		case 4: fprintf(asmPtr, "d2 "); break;
-		case 5: fprintf(asmPtr, "dd "); break;
-		case 6: fprintf(asmPtr, "dq "); break;
-
-		default:
+	if (sizeExp > 6) {
 		fprintf(stderr, "ERROR: Unsupported static variable data size\n");
 		exit(1);
 	}
 
 	//get data count
-	size_t dataCount = 0;
-	fread(&dataCount, 8, 1, ssaPtr);
-	dataCount *= dataSize;
-
-	//output data
-	char byte;
-	for (size_t i = 0; i < dataCount; ++i) {
-		byte = fgetc(ssaPtr);
-		fprintf(asmPtr, "%d,", byte);
+	size_t dataCount = readU64(&ssa);
+	if (dataCount > (ssa.length - ssa.index) / dataSize) {
+		bytecodeOutOfBounds(&ssa, dataCount * dataSize);
 	}
 
-	//newline
-	fseek(asmPtr, -1, SEEK_CUR);
-	fputc('\n', asmPtr);
+	x86DefineStatic(variableID, dataSize, readBytecodeBytes(&ssa, dataCount * dataSize), dataCount);
 }
 
 void generateDataSection() {
-	fprintf(asmPtr, "section .data\n");
-	fseek(ssaPtr, staticVariablesOffset, SEEK_SET);
+	x86BeginDataSection();
+	seekBytecode(&ssa, staticVariablesOffset);
 
-	size_t staticCount = 0;
-	fread(&staticCount, 4, 1, ssaPtr);
+	size_t staticCount = readU32(&ssa);
 
 	for (size_t i = 0; i < staticCount; ++i) {
 		generateStaticVariable();
 	}
+}
 
-	//bonus newline
-	fputc('\n', asmPtr);
+//NULL if the function table has no such ID
+const char* getFunctionIdentifier(size_t ID) {
+	if (ID < userFunctionCount) {
+		return userFunctionIdentifiers[ID];
+	}
+	if (ID <= UINT32_MAX && UINT32_MAX - ID < specFunctionCount) {
+		return specFunctionIdentifiers[UINT32_MAX - ID];
+	}
+	return NULL;
 }
 
-//memory must be freed after use, will affect file index
-char* getFunctionIdentifier(size_t ID) {
-	fseek(ssaPtr, functionTableOffset, SEEK_SET);
+//the function the program starts in, UINT32_MAX when there is no main
+uint32_t getEntryFunctionID() {
+	for (size_t i = 0; i < userFunctionCount; ++i) {
+		if (userFunctionIdentifiers[i] != NULL && strcmp(userFunctionIdentifiers[i], "main") == 0) {
+			return i;
+		}
+	}
+	return UINT32_MAX;
+}
 
-	size_t functionCount = 0;
-	fread(&functionCount, 4, 1, ssaPtr);
+//reads the whole function table into the ID lookups, names are copied into the codegen arena
+void loadFunctionTable() {
+	seekBytecode(&ssa, functionTableOffset);
+	size_t functionCount = readU32(&ssa);
+	size_t entriesIndex = ssa.index;
 
+	//first pass sizes the lookups by the furthest ID in each direction
+	//user IDs count up densely and spec IDs are within a fixed range of the max, so anything further cant belong
+	userFunctionCount = 0;
+	specFunctionCount = 0;
 	for (size_t i = 0; i < functionCount; ++i) {
-		size_t functionID = 0;
-		fread(&functionID, 4, 1, ssaPtr);
-
-		if (functionID == ID) {
-			size_t identifierLength = 0;
-			fread(&identifierLength, 8, 1, ssaPtr);
-			char* identifier = calloc(identifierLength + 1, 1);
-			if (identifier == NULL) {
-				fprintf(stderr, "ERROR: Could not allocate memory for function identifier!\n");
-				exit(1);
+		size_t functionID = readU32(&ssa);
+		skipBytecode(&ssa, readU64(&ssa));
+
+		if (irIsSpecID(functionID) ? UINT32_MAX - functionID >= IR_SPEC_ID_RANGE : functionID >= functionCount) {
+			fprintf(stderr, "ERROR: Function ID %zu out of range of a function table of %zu functions!\n", functionID, functionCount);
+			exit(1);
+		}
+		if (irIsSpecID(functionID)) {
+			if (UINT32_MAX - functionID >= specFunctionCount) {
+				specFunctionCount = UINT32_MAX - functionID + 1;
 			}
-			fread(identifier, 1, identifierLength, ssaPtr);
-			identifier[identifierLength] = '\0';
-			return identifier;
+		} else if (functionID >= userFunctionCount) {
+			userFunctionCount = functionID + 1;
 		}
+	}
 
-		size_t identifierLength = 0;
-		fread(&identifierLength, 8, 1, ssaPtr);
-		fseek(ssaPtr, identifierLength, SEEK_CUR);
+	userFunctionIdentifiers = arenaAlloc(ARENA_CODEGEN, userFunctionCount * sizeof(char*));
+	specFunctionIdentifiers = arenaAlloc(ARENA_CODEGEN, specFunctionCount * sizeof(char*));
+	for (size_t i = 0; i < userFunctionCount; ++i) {
+		userFunctionIdentifiers[i] = NULL;
+	}
+	for (size_t i = 0; i < specFunctionCount; ++i) {
+		specFunctionIdentifiers[i] = NULL;
 	}
 
-	return NULL;
+	//second pass copies the names
+	seekBytecode(&ssa, entriesIndex);
+	for (size_t i = 0; i < functionCount; ++i) {
+		size_t functionID = readU32(&ssa);
+
+		size_t identifierLength = readU64(&ssa);
+		const char* identifierBytes = readBytecodeBytes(&ssa, identifierLength);
+		char* identifier = arenaAlloc(ARENA_CODEGEN, identifierLength + 1);
+		memcpy(identifier, identifierBytes, identifierLength);
+		identifier[identifierLength] = '\0';
+
+		if (irIsSpecID(functionID)) {
+			specFunctionIdentifiers[UINT32_MAX - functionID] = identifier;
+		} else {
+			userFunctionIdentifiers[functionID] = identifier;
+		}
+	}
 }
 
-void generateConstant() {
-	//skip type byte
-	fseek(ssaPtr, 1, SEEK_CUR);
+//reads the function index into functionIndex, entries are checked against the program logic as they are used
+void loadFunctionIndex() {
+	seekBytecode(&ssa, functionIndexOffset);
+	size_t count = readU32(&ssa);
 
-	//get size
-	size_t sizeExp = 0;
-	fread(&sizeExp, 1, 1, ssaPtr);
-	if (sizeExp < 3) {
-		fprintf(stderr, "ERROR: Size exponents less than 3 currently not supported!\n");
+	//every entry is 20 bytes
+	if (count > (ssa.length - ssa.index) / 20) {
+		bytecodeOutOfBounds(&ssa, count * 20);
+	}
+	functionIndex.count = count;
+	functionIndex.IDs = arenaAlloc(ARENA_CODEGEN, count * sizeof(uint32_t));
+	functionIndex.offsets = arenaAlloc(ARENA_CODEGEN, count * sizeof(size_t));
+	functionIndex.lengths = arenaAlloc(ARENA_CODEGEN, count * sizeof(size_t));
+	for (size_t i = 0; i < count; ++i) {
+		functionIndex.IDs[i] = readU32(&ssa);
+		functionIndex.offsets[i] = readU64(&ssa);
+		functionIndex.lengths[i] = readU64(&ssa);
+	}
+}
+
+//function being generated and where its variables live
+static const struct IRFunction* currentFunction = NULL;
+static struct X86Allocation allocation;
+static bool entryFunction = false;
+static uint32_t calleeSavedCount = 0;
+static uint32_t frameSize = 0; //below the saved registers, keeps the stack 16 byte aligned
+static size_t currentBlock = 0;
+static uint32_t edgeLabelCount = 0; //labels for the code on a branch edge, numbered after the blocks
+
+int32_t slotDisplacement(uint32_t slot) {
+	return -8 * (int32_t)calleeSavedCount - 8 * ((int32_t)slot + 1);
+}
+
+int32_t stackSlotDisplacement(uint32_t variableID) {
+	return slotDisplacement(allocation.stackSlots[variableID]);
+}
+
+//the register holding the operand, constants, statics and spilled variables are first loaded into the scratch register
+enum X86Register operandRegister(struct IROperand operand, enum X86Register scratch) {
+	if (operand.variableID == 0) {
+		x86MovImm(scratch, irConstantValue(operand));
+		return scratch;
+	}
+	if (irIsStaticVariable(operand.variableID)) {
+		x86MovStaticAddress(scratch, operand.variableID);
+		return scratch;
+	}
+
+	enum X86Register reg = allocation.registers[operand.variableID];
+	if (reg == X86_REGISTER_NONE) {
+		x86LoadFrame(scratch, stackSlotDisplacement(operand.variableID));
+		return scratch;
+	}
+	return reg;
+}
+
+void loadOperand(enum X86Register destination, struct IROperand operand) {
+	enum X86Register reg = operandRegister(operand, destination);
+	if (reg != destination) {
+		x86Mov(destination, reg);
+	}
+}
+
+//register to compute the result in, spilled and discarded results use scratch register A
+enum X86Register resultRegister(uint32_t variableID) {
+	if (variableID == 0 || allocation.registers[variableID] == X86_REGISTER_NONE) {
+		return X86_SCRATCH_A;
+	}
+	return allocation.registers[variableID];
+}
+
+//MUST be called after computing a result into resultRegister()
+void storeResult(uint32_t variableID, enum X86Register reg) {
+	if (variableID != 0 && allocation.registers[variableID] == X86_REGISTER_NONE) {
+		x86StoreFrame(stackSlotDisplacement(variableID), reg);
+	}
+}
+
+//the register the variable is kept in, X86_REGISTER_NONE for constants, statics and spilled variables
+enum X86Register variableRegister(struct IROperand operand) {
+	if (operand.variableID == 0 || irIsStaticVariable(operand.variableID)) {
+		return X86_REGISTER_NONE;
+	}
+	return allocation.registers[operand.variableID];
+}
+
+bool isSignedOperand(struct IROperand operand) {
+	return irOperandType(currentFunction, operand).type == IR_INTEGER;
+}
+
+//integers narrower than 64 bits are kept extended from their size over the whole register, sign extended when signed
+//arithmetic is done in 64 bits, so the low bits are right and only the result needs extending again to wrap
+void extendToType(enum X86Register reg, struct IRValueType type) {
+	if ((type.type != IR_INTEGER && type.type != IR_UNSIGNED) || type.sizeExp < 3 || type.sizeExp > 5) {
+		return;
+	}
+	x86Extend(type.type == IR_INTEGER, 1 << type.sizeExp, reg);
+}
+
+static inline bool fitsImm32(int64_t value) {
+	return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+void generatePrologue() {
+	calleeSavedCount = 0;
+	if (!entryFunction) {
+		x86Push(X86_RBP);
+		for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+			if (allocation.calleeSavedUsed & (1 << reg)) {
+				++calleeSavedCount;
+			}
+		}
+	}
+	x86Mov(X86_RBP, X86_RSP);
+
+	//the entry function is never returned from, so its registers dont need saving
+	if (!entryFunction) {
+		for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+			if (allocation.calleeSavedUsed & (1 << reg)) {
+				x86Push(reg);
+			}
+		}
+	}
+
+	//the stack is 16 byte aligned after pushing rbp, and at the entry point
+	frameSize = 8 * allocation.stackSlotCount;
+	if ((calleeSavedCount * 8 + frameSize) % 16 != 0) {
+		frameSize += 8;
+	}
+	if (frameSize != 0) {
+		x86ArithImm(X86_SUB, X86_RSP, frameSize);
+	}
+
+	//inputs arrive in the argument registers, they are pushed then popped into their own locations in case they overlap
+	if (currentFunction->inputCount > X86_ARGUMENT_REGISTER_COUNT) {
+		fprintf(stderr, "ERROR: More than %d function inputs currently not supported!\n", X86_ARGUMENT_REGISTER_COUNT);
 		exit(1);
 	}
-	size_t dataSize = 1 << (sizeExp - 3);
-	if (sizeExp == 255) {
-		fread(&sizeExp, 1, 1, ssaPtr);
-		dataSize = 1 << (sizeExp - 3);
+	bool inPlace = true;
+	for (uint32_t i = 0; i < currentFunction->inputCount; ++i) {
+		inPlace = inPlace && allocation.registers[i + 1] == x86ArgumentRegisters[i];
+	}
+	if (inPlace) {
+		return;
+	}
+	for (uint32_t i = 0; i < currentFunction->inputCount; ++i) {
+		x86Push(x86ArgumentRegisters[i]);
 	}
+	for (uint32_t i = currentFunction->inputCount; i > 0; --i) {
+		enum X86Register destination = resultRegister(i);
+		x86Pop(destination);
+		storeResult(i, destination);
+	}
+}
 
-	//insert data
-	if (dataSize <= sizeof(size_t)) {
-		size_t data = 0;
-		fread(&data, dataSize, 1, ssaPtr);
-		fprintf(asmPtr, "%zu", data);
-	} else {
-		fprintf(stderr, "ERROR: Constant data size larger than currently supported!\n");
+//undoes the prologue, leaving the return address on top of the stack
+void generateFrameRelease() {
+	if (frameSize != 0) {
+		x86ArithImm(X86_ADD, X86_RSP, frameSize);
+	}
+	for (size_t reg = X86_REGISTER_COUNT; reg > 0; --reg) {
+		if (allocation.calleeSavedUsed & (1 << (reg - 1))) {
+			x86Pop(reg - 1);
+		}
+	}
+	x86Pop(X86_RBP);
+}
+
+void generateEpilogue() {
+	if (entryFunction) {
+		x86Comment("exit");
+		x86MovImm(X86_RAX, 60);
+		x86Syscall();
+		return;
+	}
+
+	generateFrameRelease();
+	x86Ret();
+}
+
+//returning from the entry function exits with the output as the status
+void generateReturn(const struct IRInstruction* instruction) {
+	if (instruction->operandCount != 0) {
+		loadOperand(entryFunction ? X86_RDI : X86_OUTPUT_REGISTER, instruction->operands[0]);
+	} else if (entryFunction) {
+		x86MovImm(X86_RDI, 0);
+	}
+	generateEpilogue();
+}
+
+void generateMove(const struct IRInstruction* instruction) {
+	uint32_t resultID = instruction->results[0];
+	enum X86Register destination = resultRegister(resultID);
+	loadOperand(destination, instruction->operands[0]);
+
+	//moves between types convert, values of the same type are already extended
+	struct IRValueType sourceType = irOperandType(currentFunction, instruction->operands[0]);
+	struct IRValueType destinationType = currentFunction->variableTypes[resultID];
+	if (resultID != 0 && (sourceType.type != destinationType.type || sourceType.sizeExp != destinationType.sizeExp)) {
+		extendToType(destination, destinationType);
+	}
+	storeResult(resultID, destination);
+}
+
+//register to register form, MUST be used when no cheaper form applies
+void generateGenericArithmetic(uint32_t ID, enum X86Register destination, struct IROperand lhs, struct IROperand rhs) {
+	//the right hand side cant be in the destination as the left hand side is moved there first
+	enum X86Register rhsRegister = operandRegister(rhs, X86_SCRATCH_B);
+	if (rhsRegister == destination && variableRegister(lhs) != destination) {
+		x86Mov(X86_SCRATCH_B, rhsRegister);
+		rhsRegister = X86_SCRATCH_B;
+	}
+	loadOperand(destination, lhs);
+
+	switch (ID) {
+		case IR_ADD: x86Arith(X86_ADD, destination, rhsRegister); break;
+		case IR_SUBTRACT: x86Arith(X86_SUB, destination, rhsRegister); break;
+		case IR_MULTIPLY: x86Imul(destination, rhsRegister); break;
+
+		default:
+		fprintf(stderr, "ERROR: Unknown arithmetic instruction!\n");
 		exit(1);
 	}
 }
 
-void generateSpecFuncPrint() {
-	fprintf(asmPtr, "	mov rax, 1 ; print\n	mov rdi, 1\n");
+//destination = lhs + value, an lea leaves lhs untouched without a move
+void generateAddImm(enum X86Register destination, struct IROperand lhs, int32_t value) {
+	enum X86Register lhsRegister = variableRegister(lhs);
+	if (lhsRegister != X86_REGISTER_NONE && lhsRegister != destination) {
+		if (value == 0) {
+			x86Mov(destination, lhsRegister);
+		} else {
+			x86Lea(destination, lhsRegister, X86_REGISTER_NONE, 1, value);
+		}
+		return;
+	}
 
-	//find argument ID
-	size_t argumentID = 0;
-	fread(&argumentID, 4, 1, ssaPtr);
+	loadOperand(destination, lhs);
+	if (value != 0) {
+		x86ArithImm(X86_ADD, destination, value);
+	}
+}
 
-	if (argumentID >= lowestStaticID) {
-		fprintf(asmPtr, "	mov rsi, sv_%zu\n", argumentID);
-	} else if (argumentID == 0) {
-		fprintf(stderr, "ERROR: Can't have constant pointer in print!\n");
+void generateAdd(enum X86Register destination, struct IROperand lhs, struct IROperand rhs) {
+	//constants on the right so they can be immediates
+	if (lhs.variableID == 0) {
+		struct IROperand temp = lhs;
+		lhs = rhs;
+		rhs = temp;
+	}
+
+	if (rhs.variableID == 0 && fitsImm32(irConstantValue(rhs))) {
+		generateAddImm(destination, lhs, irConstantValue(rhs));
+		return;
+	}
+
+	//both in other registers, an lea avoids the move
+	enum X86Register lhsRegister = variableRegister(lhs);
+	enum X86Register rhsRegister = variableRegister(rhs);
+	if (lhsRegister != X86_REGISTER_NONE && rhsRegister != X86_REGISTER_NONE && lhsRegister != destination && rhsRegister != destination) {
+		x86Lea(destination, lhsRegister, rhsRegister, 1, 0);
+		return;
+	}
+
+	generateGenericArithmetic(IR_ADD, destination, lhs, rhs);
+}
+
+void generateSubtract(enum X86Register destination, struct IROperand lhs, struct IROperand rhs) {
+	//negated as unsigned so INT64_MIN doesnt overflow, it stays INT64_MIN and so doesnt fit
+	if (rhs.variableID == 0 && fitsImm32((int64_t)-irConstantValue(rhs))) {
+		generateAddImm(destination, lhs, (int64_t)-irConstantValue(rhs));
+		return;
+	}
+
+	//0 - x
+	if (lhs.variableID == 0 && irConstantValue(lhs) == 0) {
+		loadOperand(destination, rhs);
+		x86Neg(destination);
+		return;
+	}
+
+	generateGenericArithmetic(IR_SUBTRACT, destination, lhs, rhs);
+}
+
+void generateMultiply(enum X86Register destination, struct IROperand lhs, struct IROperand rhs) {
+	if (lhs.variableID == 0) {
+		struct IROperand temp = lhs;
+		lhs = rhs;
+		rhs = temp;
+	}
+	if (rhs.variableID != 0) {
+		generateGenericArithmetic(IR_MULTIPLY, destination, lhs, rhs);
+		return;
+	}
+
+	uint64_t value = irConstantValue(rhs);
+	if (value == 0) {
+		x86MovImm(destination, 0);
+		return;
+	}
+	if (isPowerOfTwo(value)) {
+		loadOperand(destination, lhs);
+		if (value != 1) {
+			x86ShiftImm(X86_SHL, destination, powerOfTwoExponent(value));
+		}
+		return;
+	}
+
+	//x * 3, x * 5 and x * 9 as x + x * scale
+	enum X86Register lhsRegister = operandRegister(lhs, destination);
+	if (value == 3 || value == 5 || value == 9) {
+		x86Lea(destination, lhsRegister, lhsRegister, value - 1, 0);
+		return;
+	}
+	if (fitsImm32(value)) {
+		x86ImulImm(destination, lhsRegister, value);
+		return;
+	}
+	x86MovImm(X86_SCRATCH_B, value);
+	if (lhsRegister != destination) {
+		x86Mov(destination, lhsRegister);
+	}
+	x86Imul(destination, X86_SCRATCH_B);
+}
+
+void generateArithmetic(const struct IRInstruction* instruction) {
+	uint32_t resultID = instruction->results[0];
+	enum X86Register destination = resultRegister(resultID);
+
+	switch (instruction->ID) {
+		case IR_ADD: generateAdd(destination, instruction->operands[0], instruction->operands[1]); break;
+		case IR_SUBTRACT: generateSubtract(destination, instruction->operands[0], instruction->operands[1]); break;
+		case IR_MULTIPLY: generateMultiply(destination, instruction->operands[0], instruction->operands[1]); break;
+
+		default:
+		fprintf(stderr, "ERROR: Unknown arithmetic instruction!\n");
 		exit(1);
+	}
+	extendToType(destination, irOperandType(currentFunction, instruction->operands[0]));
+	storeResult(resultID, destination);
+}
+
+void generateHardwareDivision(bool isRemainder, bool isSigned, enum X86Register destination, struct IROperand lhs, struct IROperand rhs) {
+	//divisor first, it could be in rax
+	loadOperand(X86_SCRATCH_B, rhs);
+	loadOperand(X86_RAX, lhs);
+	if (isSigned) {
+		x86Cqo();
 	} else {
-		//handle properly
+		x86Arith(X86_XOR, X86_RDX, X86_RDX);
 	}
+	x86Div(isSigned, X86_SCRATCH_B);
 
-	//print start of next line
-	fprintf(asmPtr, "	mov rdx, ");
+	enum X86Register source = isRemainder ? X86_RDX : X86_RAX;
+	if (destination != source) {
+		x86Mov(destination, source);
+	}
+}
 
-	//next argument ID
-	fread(&argumentID, 4, 1, ssaPtr);
+//unsigned division by a power of two, the remainder is the low bits
+void generateUnsignedShiftDivision(bool isRemainder, enum X86Register destination, struct IROperand lhs, uint64_t divisor) {
+	uint8_t exponent = powerOfTwoExponent(divisor);
+	loadOperand(destination, lhs);
 
-	if (argumentID >= lowestStaticID) {
-		//handle properly
-	} else if (argumentID == 0) {
-		generateConstant();
+	if (!isRemainder) {
+		if (exponent != 0) {
+			x86ShiftImm(X86_SHR, destination, exponent);
+		}
+	} else if (exponent == 0) {
+		x86MovImm(destination, 0);
+	} else if (divisor - 1 <= INT32_MAX) {
+		x86ArithImm(X86_AND, destination, divisor - 1);
 	} else {
-		//handle properly
+		x86ShiftImm(X86_SHL, destination, 64 - exponent);
+		x86ShiftImm(X86_SHR, destination, 64 - exponent);
 	}
-
-	//print finishing touches
-	fprintf(asmPtr, "\n	syscall\n");
 }
 
-void generateInstruction() {
-	//find instruction ID
-	size_t instructionID = 0;
-	fread(&instructionID, 4, 1, ssaPtr);
+//signed division by a power of two, negative dividends are biased by divisor - 1 so the shift rounds towards zero
+void generateSignedShiftDivision(bool isRemainder, enum X86Register destination, struct IROperand lhs, uint64_t divisor) {
+	uint8_t exponent = powerOfTwoExponent(divisorMagnitude(divisor, true));
+	bool negative = (int64_t)divisor < 0;
 
-	switch (instructionID) {
-		case 4294967040:
-		generateSpecFuncPrint();
+	if (exponent == 0) {
+		if (isRemainder) {
+			x86MovImm(destination, 0);
+			return;
+		}
+		loadOperand(destination, lhs);
+		if (negative) {
+			x86Neg(destination);
+		}
 		return;
+	}
 
-		default: break;
+	//scratch = lhs + bias
+	enum X86Register lhsRegister = operandRegister(lhs, X86_SCRATCH_A);
+	x86Mov(X86_SCRATCH_B, lhsRegister);
+	x86ShiftImm(X86_SAR, X86_SCRATCH_B, 63);
+	x86ShiftImm(X86_SHR, X86_SCRATCH_B, 64 - exponent);
+	x86Arith(X86_ADD, X86_SCRATCH_B, lhsRegister);
+
+	if (!isRemainder) {
+		x86ShiftImm(X86_SAR, X86_SCRATCH_B, exponent);
+		if (negative) {
+			x86Neg(X86_SCRATCH_B);
+		}
+		x86Mov(destination, X86_SCRATCH_B);
+		return;
 	}
 
-	//do default func handling here
+	//remainder = lhs - (lhs + bias rounded down to a multiple of the divisor)
+	if (exponent <= 31) {
+		x86ArithImm(X86_AND, X86_SCRATCH_B, -((int64_t)1 << exponent));
+	} else {
+		x86ShiftImm(X86_SAR, X86_SCRATCH_B, exponent);
+		x86ShiftImm(X86_SHL, X86_SCRATCH_B, exponent);
+	}
+	x86Neg(X86_SCRATCH_B);
+	x86Arith(X86_ADD, X86_SCRATCH_B, lhsRegister);
+	x86Mov(destination, X86_SCRATCH_B);
 }
 
-void generateBlock() {
-	//find argument count
-	size_t instructionCount = 0;
-	fread(&instructionCount, 8, 1, ssaPtr);
+//division by any other constant as a multiplication by its reciprocal, the high half of the product ends up in rdx
+void generateMagicDivision(bool isRemainder, bool isSigned, enum X86Register destination, struct IROperand lhs, uint64_t divisor) {
+	//the dividend is needed after the multiplication overwrites rax and rdx
+	enum X86Register lhsRegister = operandRegister(lhs, X86_SCRATCH_A);
+	if (lhsRegister == X86_RAX || lhsRegister == X86_RDX) {
+		x86Mov(X86_SCRATCH_A, lhsRegister);
+		lhsRegister = X86_SCRATCH_A;
+	}
 
-	//TODO allocate registers for arguments, currently assume no arguments
-	fseek(ssaPtr, 4, SEEK_CUR);
+	enum X86Register quotient = X86_RDX;
+	if (isSigned) {
+		struct SignedDivisionMagic magic = signedDivisionMagic(divisor);
+		x86MovImm(X86_RAX, magic.multiplier);
+		x86WideMul(true, lhsRegister);
+		if ((int64_t)divisor > 0 && magic.multiplier < 0) {
+			x86Arith(X86_ADD, X86_RDX, lhsRegister);
+		} else if ((int64_t)divisor < 0 && magic.multiplier > 0) {
+			x86Arith(X86_SUB, X86_RDX, lhsRegister);
+		}
+		if (magic.shift != 0) {
+			x86ShiftImm(X86_SAR, X86_RDX, magic.shift);
+		}
+
+		//round towards zero by adding 1 to negative quotients
+		x86Mov(X86_RAX, X86_RDX);
+		x86ShiftImm(X86_SHR, X86_RAX, 63);
+		x86Arith(X86_ADD, X86_RDX, X86_RAX);
+	} else {
+		struct UnsignedDivisionMagic magic = unsignedDivisionMagic(divisor);
+		x86MovImm(X86_RAX, magic.multiplier);
+		x86WideMul(false, lhsRegister);
+		if (magic.add) {
+			x86Mov(X86_RAX, lhsRegister);
+			x86Arith(X86_SUB, X86_RAX, X86_RDX);
+			x86ShiftImm(X86_SHR, X86_RAX, 1);
+			x86Arith(X86_ADD, X86_RAX, X86_RDX);
+			x86ShiftImm(X86_SHR, X86_RAX, magic.shift - 1);
+			quotient = X86_RAX;
+		} else if (magic.shift != 0) {
+			x86ShiftImm(X86_SHR, X86_RDX, magic.shift);
+		}
+	}
 
-	//generate instructions
-	for (size_t i = 0; i < instructionCount; ++i) {
-		generateInstruction();
+	if (!isRemainder) {
+		if (destination != quotient) {
+			x86Mov(destination, quotient);
+		}
+		return;
 	}
+
+	//remainder = lhs - quotient * divisor
+	if (fitsImm32(divisor)) {
+		x86ImulImm(quotient, quotient, divisor);
+	} else {
+		x86MovImm(X86_SCRATCH_B, divisor);
+		x86Imul(quotient, X86_SCRATCH_B);
+	}
+	x86Mov(X86_SCRATCH_B, lhsRegister);
+	x86Arith(X86_SUB, X86_SCRATCH_B, quotient);
+	x86Mov(destination, X86_SCRATCH_B);
 }
 
-//closer to generateFunction since theres no count in the definitions but whatever
-void generateTextSection() {
-	fprintf(asmPtr, "section .text\n	global _start\n\n");
-	fseek(ssaPtr, programLogicOffset, SEEK_SET);
+void generateDivision(const struct IRInstruction* instruction) {
+	uint32_t resultID = instruction->results[0];
+	struct IROperand lhs = instruction->operands[0];
+	struct IROperand rhs = instruction->operands[1];
+	bool isRemainder = instruction->ID == IR_REMAINDER;
+	bool isSigned = isSignedOperand(lhs);
+	enum X86Register destination = resultRegister(resultID);
+
+	//the register allocator keeps rax and rdx free across divisions unless the divisor is a power of two
+	uint64_t divisor = irConstantValue(rhs);
+	if (rhs.variableID != 0 || divisor == 0) {
+		generateHardwareDivision(isRemainder, isSigned, destination, lhs, rhs);
+	} else if (isShiftDivisor(divisor, isSigned)) {
+		if (isSigned) {
+			generateSignedShiftDivision(isRemainder, destination, lhs, divisor);
+		} else {
+			generateUnsignedShiftDivision(isRemainder, destination, lhs, divisor);
+		}
+	} else {
+		generateMagicDivision(isRemainder, isSigned, destination, lhs, divisor);
+	}
+	//the extended operands divide exactly as the narrow ones would, only the minimum divided by -1 can need wrapping
+	extendToType(destination, irOperandType(currentFunction, lhs));
+	storeResult(resultID, destination);
+}
 
-	//find ID
-	size_t functionID = 0;
-	fread(&functionID, 4, 1, ssaPtr);
+void generateSpecFuncPrint(const struct IRInstruction* instruction) {
+	x86Comment("print");
 
-	//save file index
-	size_t fileIndex = ftell(ssaPtr);
+	if (instruction->operands[0].variableID == 0) {
+		fprintf(stderr, "ERROR: Can't have constant pointer in print!\n");
+		exit(1);
+	}
 
-	//get identifier
-	char* identifier = getFunctionIdentifier(functionID);
+	//the pointer could be in rdx, so is kept in scratch until the length is loaded
+	loadOperand(X86_SCRATCH_B, instruction->operands[0]);
+	loadOperand(X86_RDX, instruction->operands[1]);
+	x86Mov(X86_RSI, X86_SCRATCH_B);
+	x86MovImm(X86_RAX, 1);
+	x86MovImm(X86_RDI, 1);
+	x86Syscall();
+}
 
-	//restore file index
-	fseek(ssaPtr, fileIndex, SEEK_SET);
+//arguments are pushed then popped into the argument registers, they could be in each others registers
+//returns the called function's identifier
+const char* generateCallArguments(const struct IRInstruction* instruction) {
+	if (instruction->operandCount > X86_ARGUMENT_REGISTER_COUNT) {
+		fprintf(stderr, "ERROR: More than %d call arguments currently not supported!\n", X86_ARGUMENT_REGISTER_COUNT);
+		exit(1);
+	}
+	if (instruction->resultCount > 1) {
+		fprintf(stderr, "ERROR: More than 1 call output currently not supported!\n");
+		exit(1);
+	}
 
-	//create label
-	bool mainFunc = false;
+	const char* identifier = getFunctionIdentifier(instruction->ID);
 	if (identifier == NULL) {
 		fprintf(stderr, "ERROR: Could not find function identifier!\n");
 		exit(1);
 	}
-	if (strcmp(identifier, "main") == 0) {
-		mainFunc = true;
-		fprintf(asmPtr, "_start:\n");
-		free(identifier);
+
+	for (uint32_t i = 0; i < instruction->operandCount; ++i) {
+		x86Push(operandRegister(instruction->operands[i], X86_SCRATCH_A));
+	}
+	for (uint32_t i = instruction->operandCount; i > 0; --i) {
+		x86Pop(x86ArgumentRegisters[i - 1]);
+	}
+	return identifier;
+}
+
+void generateCall(const struct IRInstruction* instruction) {
+	const char* identifier = generateCallArguments(instruction);
+	x86Call(instruction->ID, identifier);
+
+	if (instruction->resultCount != 0 && instruction->results[0] != 0) {
+		enum X86Register destination = resultRegister(instruction->results[0]);
+		if (destination != X86_OUTPUT_REGISTER) {
+			x86Mov(destination, X86_OUTPUT_REGISTER);
+		}
+		storeResult(instruction->results[0], destination);
+	}
+}
+
+//the frame is released before jumping, so the callee returns straight to our caller with its output already in place
+//the arguments are only in the argument registers, which the frame release doesnt touch
+void generateTailCall(const struct IRInstruction* instruction) {
+	const char* identifier = generateCallArguments(instruction);
+	generateFrameRelease();
+	x86JumpFunction(instruction->ID, identifier);
+}
+
+//where a value passed along a jump lives, registers are their own number and frame slots come after them
+#define LOCATION_NONE UINT32_MAX //constants and statics, materialised straight into the destination
+
+struct EdgeCopy {
+	uint32_t destination;
+	uint32_t source;
+	struct IROperand operand; //only for a source with no location
+};
+
+uint32_t variableLocation(uint32_t variableID) {
+	if (allocation.registers[variableID] != X86_REGISTER_NONE) {
+		return allocation.registers[variableID];
+	}
+	return X86_REGISTER_COUNT + allocation.stackSlots[variableID];
+}
+
+void generateEdgeCopy(const struct EdgeCopy* copy) {
+	bool toRegister = copy->destination < X86_REGISTER_COUNT;
+	enum X86Register reg = toRegister ? (enum X86Register)copy->destination : X86_SCRATCH_A;
+	if (copy->source == LOCATION_NONE) {
+		loadOperand(reg, copy->operand);
+	} else if (copy->source < X86_REGISTER_COUNT) {
+		reg = toRegister ? reg : (enum X86Register)copy->source;
+		if (reg != copy->source) {
+			x86Mov(reg, copy->source);
+		}
+	} else {
+		x86LoadFrame(reg, slotDisplacement(copy->source - X86_REGISTER_COUNT));
+	}
+	if (!toRegister) {
+		x86StoreFrame(slotDisplacement(copy->destination - X86_REGISTER_COUNT), reg);
+	}
+}
+
+//the arguments are a parallel copy, every value is read before any argument is written
+//copies already in place are dropped, coalescing makes most of them so, the rest are ordered so no value is overwritten before its read
+//what remains are cycles, broken with xchg between registers or by saving one value in scratch register B
+void generateBlockArguments(const struct IRInstruction* instruction, const struct IRTarget* target) {
+	const struct IRBlock* block = &currentFunction->blocks[target->block];
+	struct EdgeCopy* copies = arenaAlloc(ARENA_CODEGEN, target->argumentCount * sizeof(struct EdgeCopy));
+	uint32_t copyCount = 0;
+	for (uint32_t i = 0; i < target->argumentCount; ++i) {
+		struct IROperand argument = instruction->operands[target->firstArgument + i];
+		struct EdgeCopy copy;
+		copy.destination = variableLocation(block->argumentIDs[i]);
+		copy.source = argument.variableID == 0 || irIsStaticVariable(argument.variableID) ? LOCATION_NONE : variableLocation(argument.variableID);
+		copy.operand = argument;
+		if (copy.source != copy.destination) {
+			copies[copyCount] = copy;
+			++copyCount;
+		}
+	}
+
+	while (copyCount > 0) {
+		//a copy whose destination no other copy still reads can go now
+		uint32_t ready = copyCount;
+		for (uint32_t i = 0; i < copyCount && ready == copyCount; ++i) {
+			ready = i;
+			for (uint32_t j = 0; j < copyCount; ++j) {
+				if (j != i && copies[j].source == copies[i].destination) {
+					ready = copyCount;
+					break;
+				}
+			}
+		}
+		if (ready != copyCount) {
+			generateEdgeCopy(&copies[ready]);
+			--copyCount;
+			copies[ready] = copies[copyCount];
+			continue;
+		}
+
+		//only cycles are left, so each destination is read by exactly one other copy
+		struct EdgeCopy* first = &copies[0];
+		uint32_t reader = 1;
+		while (copies[reader].source != first->destination) {
+			++reader;
+		}
+		if (first->destination < X86_REGISTER_COUNT && first->source < X86_REGISTER_COUNT) {
+			x86Xchg(first->destination, first->source);
+			copies[reader].source = first->source;
+			--copyCount;
+			copies[0] = copies[copyCount];
+		} else {
+			struct EdgeCopy save = {X86_SCRATCH_B, first->destination, first->operand};
+			generateEdgeCopy(&save);
+			copies[reader].source = X86_SCRATCH_B;
+		}
+	}
+}
+
+//the jump is left out when the target is the next block and nothing else follows
+void generateJumpTo(const struct IRInstruction* instruction, uint32_t targetIndex, bool canFallThrough) {
+	const struct IRTarget* target = &instruction->targets[targetIndex];
+	generateBlockArguments(instruction, target);
+	if (!canFallThrough || target->block != currentBlock + 1) {
+		x86Jump(target->block);
+	}
+}
+
+//an edge with no arguments is a single conditional jump, when both have arguments the false edge gets its own label
+void generateBranch(const struct IRInstruction* instruction) {
+	struct IROperand condition = instruction->operands[0];
+	if (condition.variableID == 0) {
+		generateJumpTo(instruction, irConstantValue(condition) != 0 ? 0 : 1, true);
+		return;
+	}
+
+	x86ArithImm(X86_CMP, operandRegister(condition, X86_SCRATCH_A), 0);
+	const struct IRTarget* targets = instruction->targets;
+	if (targets[1].argumentCount == 0) {
+		x86JumpIf(X86_CONDITION_E, targets[1].block);
+		generateJumpTo(instruction, 0, true);
+	} else if (targets[0].argumentCount == 0) {
+		x86JumpIf(X86_CONDITION_NE, targets[0].block);
+		generateJumpTo(instruction, 1, true);
 	} else {
-		fprintf(asmPtr, "_%s:\n", identifier);
-		free(identifier);
+		uint32_t falseEdge = currentFunction->blockCount + edgeLabelCount;
+		++edgeLabelCount;
+		x86JumpIf(X86_CONDITION_E, falseEdge);
+		generateJumpTo(instruction, 0, false);
+		x86DefineBlock(falseEdge);
+		generateJumpTo(instruction, 1, true);
 	}
+}
+
+void generateInstruction(const struct IRInstruction* instruction) {
+	switch (instruction->ID) {
+		case IR_DECLARE: return; //only matters for the types
+
+		case IR_MOVE: generateMove(instruction); return;
+		case IR_RETURN: generateReturn(instruction); return;
+		case IR_JUMP: generateJumpTo(instruction, 0, true); return;
+		case IR_BRANCH: generateBranch(instruction); return;
+
+		case IR_ADD:
+		case IR_SUBTRACT:
+		case IR_MULTIPLY:
+		case IR_DIVIDE:
+		case IR_REMAINDER:
+		//constant float expressions are folded by the parser, the rest needs sse
+		if (irOperandType(currentFunction, instruction->operands[0]).type == IR_FLOAT) {
+			fprintf(stderr, "ERROR: Float arithmetic currently not supported!\n");
+			exit(1);
+		}
+		if (instruction->ID == IR_DIVIDE || instruction->ID == IR_REMAINDER) {
+			generateDivision(instruction);
+		} else {
+			generateArithmetic(instruction);
+		}
+		return;
 
-	//find block count
-	size_t blockCount = 0;
-	fread(&blockCount, 4, 1, ssaPtr);
+		case IR_PRINT: generateSpecFuncPrint(instruction); return;
 
-	//TODO allocate registers for parameters, currently assume no parameters
-	fseek(ssaPtr, 8, SEEK_CUR);
+		default: break;
+	}
+
+	generateCall(instruction);
+}
+
+void generateFunction(const struct IRFunction* function) {
+	//get identifier
+	const char* identifier = getFunctionIdentifier(function->ID);
+	if (identifier == NULL) {
+		fprintf(stderr, "ERROR: Could not find function identifier!\n");
+		exit(1);
+	}
+
+	currentFunction = function;
+	entryFunction = strcmp(identifier, "main") == 0;
+	allocation = allocateX86Registers(function);
+
+	x86BeginFunction(function->ID, identifier, entryFunction);
+	generatePrologue();
 
 	//generate blocks
-	for (size_t i = 0; i < blockCount; ++i) {
-		generateBlock();
+	edgeLabelCount = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		currentBlock = i;
+		x86DefineBlock(i);
+		const struct IRBlock* block = &function->blocks[i];
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			//the entry function has nothing to return to, its tail calls stay calls
+			if (!entryFunction && irIsTailCall(function, i, j)) {
+				generateTailCall(&block->instructions[j]);
+				break;
+			}
+			generateInstruction(&block->instructions[j]);
+		}
 	}
 
-	//if main, call exit syscall
-	if (mainFunc) {
-		fprintf(asmPtr, "	mov rax, 60 ; exit\n	mov rdi, 0\n	syscall");
+	//falling off the end returns, the entry function exits with 0
+	const struct IRBlock* lastBlock = function->blockCount == 0 ? NULL : &function->blocks[function->blockCount - 1];
+	if (lastBlock == NULL || lastBlock->instructionCount == 0 || !irIsTerminator(lastBlock->instructions[lastBlock->instructionCount - 1].ID)) {
+		if (entryFunction) {
+			x86MovImm(X86_RDI, 0);
+		}
+		generateEpilogue();
 	}
+
+	x86EndFunction();
 }
 
-void loadBytecodeData() {
-	fseek(ssaPtr, 0, SEEK_SET);
+void generateTextSection() {
+	x86BeginTextSection();
+	seekBytecode(&ssa, programLogicOffset);
+
+	//with an index only what main can reach is decoded, otherwise every definition in order
+	uint32_t entryID = getEntryFunctionID();
+	struct IRProgram program;
+	if (hasFunctionIndex) {
+		struct BytecodeReader programLogic = makeBytecodeReader(ssa.ptr + programLogicOffset, ssa.length - programLogicOffset);
+		program = decodeIndexedIRProgram(&programLogic, &functionIndex, entryID, userFunctionCount);
+	} else {
+		program = decodeIRProgram(&ssa, userFunctionCount);
+	}
+	runIRPasses(&program, entryID, getFunctionIdentifier);
+	for (size_t i = 0; i < program.functionCount; ++i) {
+		generateFunction(&program.functions[i]);
+	}
+}
 
+void loadBytecodeData() {
 	//check magic number
-	static char mNumBuff[4];
-	fread(mNumBuff, 1, 4, ssaPtr);
 	static const char mNum[] = {0x78, 0x70, 0x62, 0xc0};
-	if (strncmp(mNumBuff, mNum, 4) != 0) {
+	if (!bytecodeHasBytes(&ssa, BYTECODE_HEADER_LENGTH)) {
+		fprintf(stderr, "ERROR: Bytecode file too short for its header!\n");
+		exit(1);
+	}
+	if (memcmp(ssa.ptr, mNum, 4) != 0) {
 		fprintf(stderr, "ERROR: Bytecode file magic number incorrect!\n");
 		exit(1);
 	}
 
-	//skip over version, cant be bothered to check it
-	fseek(ssaPtr, 16, SEEK_SET);
+	//the header layout changed in 0.2, before 1.0 every minor version can change it
+	seekBytecode(&ssa, 4);
+	uint32_t versionMajor = readU32(&ssa);
+	uint32_t versionMinor = readU32(&ssa);
+	if (versionMajor != 0 || versionMinor != 2) {
+		fprintf(stderr, "ERROR: Bytecode version %u.%u not supported, expected 0.2!\n", versionMajor, versionMinor);
+		exit(1);
+	}
+	readU32(&ssa); //patch
+	uint64_t flags = readU64(&ssa);
+	hasFunctionIndex = (flags & BYTECODE_FLAG_FUNCTION_INDEX) != 0;
+
+	//load offsets, the function index offset is only meaningful when flagged
+	functionTableOffset = readU64(&ssa);
+	staticVariablesOffset = readU64(&ssa);
+	functionIndexOffset = readU64(&ssa);
+	programLogicOffset = readU64(&ssa);
+	if (!hasFunctionIndex) {
+		functionIndexOffset = programLogicOffset;
+	}
+
+	//validate offsets once so sections can be seeked to without further checks
+	const size_t offsets[] = {functionTableOffset, staticVariablesOffset, functionIndexOffset, programLogicOffset};
+	for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); ++i) {
+		if (offsets[i] < BYTECODE_HEADER_LENGTH || offsets[i] > ssa.length) {
+			fprintf(stderr, "ERROR: Bytecode section offset %zu out of bounds!\n", offsets[i]);
+			exit(1);
+		}
+	}
 
-	//load offsets
-	fread(&functionTableOffset, 8, 1, ssaPtr);
-	fread(&staticVariablesOffset, 8, 1, ssaPtr);
-	fread(&programLogicOffset, 8, 1, ssaPtr);
-	
-	//set lowestStaticID
-	fseek(ssaPtr, staticVariablesOffset, SEEK_SET);
-	size_t staticCount = 0;
-	fread(&staticCount, 4, 1, ssaPtr);
-	lowestStaticID = 4294967295 - staticCount;
+	loadFunctionTable();
+	if (hasFunctionIndex) {
+		loadFunctionIndex();
+	}
 }
 
-void generateASM(FILE* inPtr, FILE* outPtr) {
-	ssaPtr = inPtr;
-	asmPtr = outPtr;
+void generateProgram(const char* bytecode, size_t length) {
+	ssa = makeBytecodeReader(bytecode, length);
 
 	loadBytecodeData();
 
 	generateDataSection();
 	generateTextSection();
+}
+
+void generateASM(const char* bytecode, size_t length, FILE* outPtr) {
+	resetX86Emitter(X86_OUTPUT_ASM, outPtr);
+	generateProgram(bytecode, length);
+	finishX86Emitter();
+}
+
+struct X86Code generateMachineCode(const char* bytecode, size_t length) {
+	resetX86Emitter(X86_OUTPUT_MACHINE, NULL);
+	generateProgram(bytecode, length);
+	return finishX86Emitter();
 }
\ No newline at end of file
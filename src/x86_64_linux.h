@@ -1,5 +1,11 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdio.h>
 
-void generateASM(FILE* inPtr, FILE* outPtr);
\ No newline at end of file
+#include "x86_emit.h"
+
+//bytecode is a whole bytecode file in memory, either from parseFile() or a memory mapped .xpb file
+void generateASM(const char* bytecode, size_t length, FILE* outPtr);
+//same as generateASM() but as machine code, ready for the elf writer
+struct X86Code generateMachineCode(const char* bytecode, size_t length);
\ No newline at end of file
@@ -0,0 +1,795 @@
+#include "x86_emit.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "asm_writer.h"
+#include "byte_array.h"
+
+#define X86_OFFSET_NONE SIZE_MAX
+
+//a location in text that refers to a label
+struct X86Fixup {
+	size_t offset; //of the 4 or 8 byte field
+	uint32_t target;
+};
+
+//a growable list of fixups of one kind
+struct X86FixupList {
+	struct X86Fixup* fixups;
+	size_t count;
+	size_t capacity;
+};
+
+//growable offsets indexed by label, unplaced labels are X86_OFFSET_NONE
+struct X86LabelOffsets {
+	size_t* offsets;
+	size_t capacity;
+};
+
+static enum X86OutputMode outputMode = X86_OUTPUT_ASM;
+
+//machine code output
+static struct ByteBuffer text = {NULL, 0, 0};
+static struct ByteBuffer data = {NULL, 0, 0};
+static size_t entryOffset = X86_OFFSET_NONE;
+
+//statics are indexed by UINT32_MAX - ID as their IDs grow down from the max
+static struct X86LabelOffsets staticOffsets = {NULL, 0};
+static struct X86LabelOffsets functionOffsets = {NULL, 0};
+static struct X86LabelOffsets blockOffsets = {NULL, 0}; //of the current function
+
+static struct X86FixupList staticFixups = {NULL, 0, 0};
+static struct X86FixupList functionFixups = {NULL, 0, 0};
+static struct X86FixupList blockFixups = {NULL, 0, 0}; //of the current function
+
+static const char* const registerNames[X86_REGISTER_COUNT] = {
+	"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+	"r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15",
+};
+
+//low 32, 16 and 8 bits of each register, for extending narrow values
+static const char* const registerNames32[X86_REGISTER_COUNT] = {
+	"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi",
+	"r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d", "r15d",
+};
+static const char* const registerNames16[X86_REGISTER_COUNT] = {
+	"ax", "cx", "dx", "bx", "sp", "bp", "si", "di",
+	"r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w",
+};
+static const char* const registerNames8[X86_REGISTER_COUNT] = {
+	"al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil",
+	"r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b", "r15b",
+};
+
+void* reallocX86Emitter(void* ptr, size_t size) {
+	void* resized = realloc(ptr, size);
+	if (resized == NULL) {
+		fprintf(stderr, "ERROR: Could not allocate memory for machine code!\n");
+		exit(1);
+	}
+	return resized;
+}
+
+void addFixup(struct X86FixupList* list, size_t offset, uint32_t target) {
+	if (list->count == list->capacity) {
+		list->capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+		list->fixups = reallocX86Emitter(list->fixups, list->capacity * sizeof(struct X86Fixup));
+	}
+	list->fixups[list->count].offset = offset;
+	list->fixups[list->count].target = target;
+	++list->count;
+}
+
+void placeLabel(struct X86LabelOffsets* labels, size_t index, size_t offset) {
+	if (index >= labels->capacity) {
+		size_t newCapacity = labels->capacity == 0 ? 64 : labels->capacity;
+		while (newCapacity <= index) {
+			newCapacity *= 2;
+		}
+		labels->offsets = reallocX86Emitter(labels->offsets, newCapacity * sizeof(size_t));
+		for (size_t i = labels->capacity; i < newCapacity; ++i) {
+			labels->offsets[i] = X86_OFFSET_NONE;
+		}
+		labels->capacity = newCapacity;
+	}
+	if (labels->offsets[index] != X86_OFFSET_NONE) {
+		fprintf(stderr, "ERROR: Label %zu placed twice in machine code!\n", index);
+		exit(1);
+	}
+	labels->offsets[index] = offset;
+}
+
+size_t labelOffset(const struct X86LabelOffsets* labels, size_t index) {
+	if (index >= labels->capacity) {
+		return X86_OFFSET_NONE;
+	}
+	return labels->offsets[index];
+}
+
+void clearLabels(struct X86LabelOffsets* labels) {
+	for (size_t i = 0; i < labels->capacity; ++i) {
+		labels->offsets[i] = X86_OFFSET_NONE;
+	}
+}
+
+//patches every rel32 fixup in the list now that its labels are placed
+void resolveRelativeFixups(struct X86FixupList* list, const struct X86LabelOffsets* labels, const char* labelKind) {
+	for (size_t i = 0; i < list->count; ++i) {
+		size_t target = labelOffset(labels, list->fixups[i].target);
+		if (target == X86_OFFSET_NONE) {
+			fprintf(stderr, "ERROR: Jump to undefined %s %u!\n", labelKind, list->fixups[i].target);
+			exit(1);
+		}
+		int64_t displacement = (int64_t)target - (int64_t)(list->fixups[i].offset + 4);
+		patchUInt(&text, list->fixups[i].offset, (uint64_t)displacement, 4);
+	}
+	list->count = 0;
+}
+
+void resetX86Emitter(enum X86OutputMode mode, FILE* asmFile) {
+	outputMode = mode;
+	if (mode == X86_OUTPUT_ASM) {
+		beginAsmOutput(asmFile);
+		return;
+	}
+
+	text = allocByteBuffer(4096);
+	data = allocByteBuffer(4096);
+	entryOffset = X86_OFFSET_NONE;
+	clearLabels(&staticOffsets);
+	clearLabels(&functionOffsets);
+	clearLabels(&blockOffsets);
+	staticFixups.count = 0;
+	functionFixups.count = 0;
+	blockFixups.count = 0;
+}
+
+struct X86Code finishX86Emitter() {
+	struct X86Code code = {{NULL, 0}, {NULL, 0}, 0, 0, NULL};
+	if (outputMode == X86_OUTPUT_ASM) {
+		finishAsmOutput();
+		return code;
+	}
+
+	if (entryOffset == X86_OFFSET_NONE) {
+		fprintf(stderr, "ERROR: No entry function in machine code!\n");
+		exit(1);
+	}
+	resolveRelativeFixups(&functionFixups, &functionOffsets, "function");
+
+	//static addresses are only known once the output is laid out, so the data offset is left in the field
+	code.relocationCount = staticFixups.count;
+	code.relocationOffsets = reallocX86Emitter(NULL, (staticFixups.count + 1) * sizeof(size_t));
+	for (size_t i = 0; i < staticFixups.count; ++i) {
+		size_t target = labelOffset(&staticOffsets, UINT32_MAX - staticFixups.fixups[i].target);
+		if (target == X86_OFFSET_NONE) {
+			fprintf(stderr, "ERROR: Reference to undefined static variable %u!\n", staticFixups.fixups[i].target);
+			exit(1);
+		}
+		patchUInt(&text, staticFixups.fixups[i].offset, target, 8);
+		code.relocationOffsets[i] = staticFixups.fixups[i].offset;
+	}
+	staticFixups.count = 0;
+
+	code.text = byteBufferToArray(&text);
+	code.data = byteBufferToArray(&data);
+	code.entryOffset = entryOffset;
+	return code;
+}
+
+void freeX86Code(struct X86Code* code) {
+	freeByteArray(&code->text);
+	freeByteArray(&code->data);
+	free(code->relocationOffsets);
+	code->relocationOffsets = NULL;
+	code->relocationCount = 0;
+}
+
+const char* x86RegisterName(enum X86Register reg) {
+	return registerNames[reg];
+}
+
+//encoding helpers
+
+//only emitted when needed unless forced, e.g. for 64 bit operands
+static inline void emitRex(bool wide, enum X86Register reg, enum X86Register rm) {
+	uint8_t rex = 0x40 | (wide ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((rm & 8) ? 0x01 : 0);
+	if (rex != 0x40) {
+		appendU8(&text, rex);
+	}
+}
+
+//for memory operands with a sib byte, no index is encoded as rsp
+static inline void emitRexSib(bool wide, enum X86Register reg, enum X86Register index, enum X86Register base) {
+	uint8_t rex = 0x40 | (wide ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | (index != X86_REGISTER_NONE && (index & 8) ? 0x02 : 0) | ((base & 8) ? 0x01 : 0);
+	if (rex != 0x40) {
+		appendU8(&text, rex);
+	}
+}
+
+static inline void emitModRM(uint8_t mod, uint8_t reg, enum X86Register rm) {
+	appendU8(&text, (mod << 6) | ((reg & 7) << 3) | (rm & 7));
+}
+
+//[rbp + displacement], rbp as the base never needs a sib byte
+static inline void emitFrameOperand(uint8_t reg, int32_t displacement) {
+	if (displacement >= INT8_MIN && displacement <= INT8_MAX) {
+		emitModRM(1, reg, X86_RBP);
+		appendU8(&text, (uint8_t)displacement);
+	} else {
+		emitModRM(2, reg, X86_RBP);
+		appendU32(&text, (uint32_t)displacement);
+	}
+}
+
+//text helpers
+
+void emitAsmInstruction(const char* mnemonic) {
+	emitAsmChar('\t');
+	emitAsm(mnemonic);
+}
+
+void emitAsmOperands(enum X86Register first, enum X86Register second) {
+	emitAsmChar(' ');
+	emitAsm(registerNames[first]);
+	emitAsm(", ");
+	emitAsm(registerNames[second]);
+	emitAsmChar('\n');
+}
+
+void emitAsmFrameOperand(int32_t displacement) {
+	emitAsm("[rbp");
+	if (displacement >= 0) {
+		emitAsmChar('+');
+	}
+	emitAsmInt(displacement);
+	emitAsmChar(']');
+}
+
+void emitAsmRegisterImm(enum X86Register reg, int64_t value) {
+	emitAsmChar(' ');
+	emitAsm(registerNames[reg]);
+	emitAsm(", ");
+	emitAsmInt(value);
+	emitAsmChar('\n');
+}
+
+void emitAsmBlockLabel(uint32_t blockIndex) {
+	emitAsm(".b");
+	emitAsmUInt(blockIndex);
+}
+
+//sections
+
+void x86BeginDataSection() {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsm("section .data\n");
+	}
+}
+
+void x86BeginTextSection() {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsm("\nsection .text\n	global _start\n\n");
+	}
+}
+
+void x86DefineStatic(uint32_t ID, size_t elementSize, const char* staticData, size_t elementCount) {
+	if (outputMode == X86_OUTPUT_MACHINE) {
+		//naturally aligned
+		appendZeroes(&data, (elementSize - data.length % elementSize) % elementSize);
+		placeLabel(&staticOffsets, UINT32_MAX - ID, data.length);
+		appendBytes(&data, staticData, elementSize * elementCount);
+		return;
+	}
+
+	emitAsm("	sv_");
+	emitAsmUInt(ID);
+
+	//a label on its own when theres no data, nasm warns about data directives without operands
+	if (elementCount == 0) {
+		emitAsm(":\n");
+		return;
+	}
+
+	switch (elementSize) {
+		case 1: emitAsm(" db "); break;
+		case 2: emitAsm(" dw "); break;
+		case 4: emitAsm(" dd "); break;
+		case 8: emitAsm(" dq "); break;
+
+		default:
+		fprintf(stderr, "ERROR: Unsupported static variable data size\n");
+		exit(1);
+	}
+
+	//bytes can be emitted as strings
+	if (elementSize == 1) {
+		emitAsmData((const uint8_t*)staticData, elementCount);
+	} else {
+		for (size_t i = 0; i < elementCount; ++i) {
+			if (i != 0) {
+				emitAsmChar(',');
+			}
+			uint64_t element = 0;
+			for (size_t j = 0; j < elementSize; ++j) {
+				element |= (uint64_t)(uint8_t)staticData[i * elementSize + j] << (j * 8);
+			}
+			emitAsmUInt(element);
+		}
+	}
+	emitAsmChar('\n');
+}
+
+//functions and blocks
+
+void x86BeginFunction(uint32_t ID, const char* identifier, bool entry) {
+	if (outputMode == X86_OUTPUT_MACHINE) {
+		placeLabel(&functionOffsets, ID, text.length);
+		if (entry) {
+			entryOffset = text.length;
+		}
+		return;
+	}
+
+	if (entry) {
+		emitAsm("_start:\n");
+	} else {
+		emitAsmChar('_');
+		emitAsm(identifier);
+		emitAsm(":\n");
+	}
+}
+
+void x86EndFunction() {
+	if (outputMode == X86_OUTPUT_MACHINE) {
+		resolveRelativeFixups(&blockFixups, &blockOffsets, "block");
+		clearLabels(&blockOffsets);
+	}
+}
+
+void x86DefineBlock(uint32_t blockIndex) {
+	if (outputMode == X86_OUTPUT_MACHINE) {
+		placeLabel(&blockOffsets, blockIndex, text.length);
+		return;
+	}
+
+	emitAsmBlockLabel(blockIndex);
+	emitAsm(":\n");
+}
+
+void x86Comment(const char* comment) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsm("	; ");
+		emitAsm(comment);
+		emitAsmChar('\n');
+	}
+}
+
+//instructions
+
+void x86MovImm(enum X86Register destination, uint64_t value) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("mov ");
+		emitAsm(registerNames[destination]);
+		emitAsm(", ");
+		emitAsmUInt(value);
+		emitAsmChar('\n');
+		return;
+	}
+
+	if (value <= UINT32_MAX) {
+		//32 bit moves zero the upper half
+		emitRex(false, 0, destination);
+		appendU8(&text, 0xB8 + (destination & 7));
+		appendU32(&text, value);
+	} else if ((int64_t)value >= INT32_MIN && (int64_t)value <= INT32_MAX) {
+		emitRex(true, 0, destination);
+		appendU8(&text, 0xC7);
+		emitModRM(3, 0, destination);
+		appendU32(&text, value);
+	} else {
+		emitRex(true, 0, destination);
+		appendU8(&text, 0xB8 + (destination & 7));
+		appendU64(&text, value);
+	}
+}
+
+void x86MovStaticAddress(enum X86Register destination, uint32_t staticID) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("mov ");
+		emitAsm(registerNames[destination]);
+		emitAsm(", sv_");
+		emitAsmUInt(staticID);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, 0, destination);
+	appendU8(&text, 0xB8 + (destination & 7));
+	addFixup(&staticFixups, text.length, staticID);
+	appendU64(&text, 0);
+}
+
+void x86Mov(enum X86Register destination, enum X86Register source) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("mov");
+		emitAsmOperands(destination, source);
+		return;
+	}
+
+	emitRex(true, source, destination);
+	appendU8(&text, 0x89);
+	emitModRM(3, source, destination);
+}
+
+void x86Xchg(enum X86Register first, enum X86Register second) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("xchg");
+		emitAsmOperands(first, second);
+		return;
+	}
+
+	emitRex(true, second, first);
+	appendU8(&text, 0x87);
+	emitModRM(3, second, first);
+}
+
+void x86Extend(bool isSigned, uint8_t bits, enum X86Register reg) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		const char* narrowName = bits == 8 ? registerNames8[reg] : bits == 16 ? registerNames16[reg] : registerNames32[reg];
+		if (!isSigned) {
+			//32 bit destinations zero the upper half
+			emitAsmInstruction(bits == 32 ? "mov " : "movzx ");
+			emitAsm(registerNames32[reg]);
+		} else {
+			emitAsmInstruction(bits == 32 ? "movsxd " : "movsx ");
+			emitAsm(registerNames[reg]);
+		}
+		emitAsm(", ");
+		emitAsm(narrowName);
+		emitAsmChar('\n');
+		return;
+	}
+
+	if (!isSigned && bits == 32) {
+		emitRex(false, reg, reg);
+		appendU8(&text, 0x89);
+	} else if (!isSigned) {
+		//without a rex prefix the low bytes of rsp, rbp, rsi and rdi would be ah, ch, dh and bh
+		if (bits == 8 && reg >= X86_RSP && reg <= X86_RDI) {
+			appendU8(&text, 0x40);
+		}
+		emitRex(false, reg, reg);
+		appendU8(&text, 0x0F);
+		appendU8(&text, bits == 8 ? 0xB6 : 0xB7);
+	} else if (bits == 32) {
+		emitRex(true, reg, reg);
+		appendU8(&text, 0x63);
+	} else {
+		emitRex(true, reg, reg);
+		appendU8(&text, 0x0F);
+		appendU8(&text, bits == 8 ? 0xBE : 0xBF);
+	}
+	emitModRM(3, reg, reg);
+}
+
+void x86LoadFrame(enum X86Register destination, int32_t displacement) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("mov ");
+		emitAsm(registerNames[destination]);
+		emitAsm(", ");
+		emitAsmFrameOperand(displacement);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, destination, X86_RBP);
+	appendU8(&text, 0x8B);
+	emitFrameOperand(destination, displacement);
+}
+
+void x86StoreFrame(int32_t displacement, enum X86Register source) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("mov ");
+		emitAsmFrameOperand(displacement);
+		emitAsm(", ");
+		emitAsm(registerNames[source]);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, source, X86_RBP);
+	appendU8(&text, 0x89);
+	emitFrameOperand(source, displacement);
+}
+
+void x86Arith(enum X86ArithOp op, enum X86Register destination, enum X86Register source) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		static const char* const mnemonics[] = {"add", "or", "", "", "and", "sub", "xor", "cmp"};
+		emitAsmInstruction(mnemonics[op]);
+		emitAsmOperands(destination, source);
+		return;
+	}
+
+	emitRex(true, source, destination);
+	appendU8(&text, op * 8 + 1);
+	emitModRM(3, source, destination);
+}
+
+void x86ArithImm(enum X86ArithOp op, enum X86Register destination, int32_t value) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		static const char* const mnemonics[] = {"add", "or", "", "", "and", "sub", "xor", "cmp"};
+		emitAsmInstruction(mnemonics[op]);
+		emitAsmRegisterImm(destination, value);
+		return;
+	}
+
+	emitRex(true, 0, destination);
+	if (value >= INT8_MIN && value <= INT8_MAX) {
+		appendU8(&text, 0x83);
+		emitModRM(3, op, destination);
+		appendU8(&text, (uint8_t)value);
+	} else {
+		appendU8(&text, 0x81);
+		emitModRM(3, op, destination);
+		appendU32(&text, (uint32_t)value);
+	}
+}
+
+void x86Lea(enum X86Register destination, enum X86Register base, enum X86Register index, uint8_t scale, int32_t displacement) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("lea ");
+		emitAsm(registerNames[destination]);
+		emitAsm(", [");
+		emitAsm(registerNames[base]);
+		if (index != X86_REGISTER_NONE) {
+			emitAsmChar('+');
+			emitAsm(registerNames[index]);
+			if (scale != 1) {
+				emitAsmChar('*');
+				emitAsmUInt(scale);
+			}
+		}
+		if (displacement != 0) {
+			if (displacement > 0) {
+				emitAsmChar('+');
+			}
+			emitAsmInt(displacement);
+		}
+		emitAsm("]\n");
+		return;
+	}
+
+	static const uint8_t scaleBits[] = {0, 0, 1, 0, 2, 0, 0, 0, 3};
+	emitRexSib(true, destination, index, base);
+	appendU8(&text, 0x8D);
+
+	//rbp and r13 as the base always need a displacement
+	uint8_t mod = 2;
+	if (displacement == 0 && (base & 7) != X86_RBP) {
+		mod = 0;
+	} else if (displacement >= INT8_MIN && displacement <= INT8_MAX) {
+		mod = 1;
+	}
+	//a sib byte is only needed for an index, or rsp and r12 as the base
+	if (index == X86_REGISTER_NONE && (base & 7) != X86_RSP) {
+		emitModRM(mod, destination, base);
+	} else {
+		emitModRM(mod, destination, X86_RSP);
+		appendU8(&text, (scaleBits[scale] << 6) | ((index == X86_REGISTER_NONE ? X86_RSP : index) & 7) << 3 | (base & 7));
+	}
+	if (mod == 1) {
+		appendU8(&text, (uint8_t)displacement);
+	} else if (mod == 2) {
+		appendU32(&text, (uint32_t)displacement);
+	}
+}
+
+void x86ShiftImm(enum X86ShiftOp op, enum X86Register destination, uint8_t count) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		static const char* const mnemonics[] = {"", "", "", "", "shl", "shr", "", "sar"};
+		emitAsmInstruction(mnemonics[op]);
+		emitAsmRegisterImm(destination, count);
+		return;
+	}
+
+	//shifts by 1 have their own shorter form
+	emitRex(true, 0, destination);
+	appendU8(&text, count == 1 ? 0xD1 : 0xC1);
+	emitModRM(3, op, destination);
+	if (count != 1) {
+		appendU8(&text, count);
+	}
+}
+
+void x86Imul(enum X86Register destination, enum X86Register source) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("imul");
+		emitAsmOperands(destination, source);
+		return;
+	}
+
+	emitRex(true, destination, source);
+	appendU8(&text, 0x0F);
+	appendU8(&text, 0xAF);
+	emitModRM(3, destination, source);
+}
+
+void x86ImulImm(enum X86Register destination, enum X86Register source, int32_t value) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("imul");
+		emitAsmChar(' ');
+		emitAsm(registerNames[destination]);
+		emitAsm(", ");
+		emitAsm(registerNames[source]);
+		emitAsm(", ");
+		emitAsmInt(value);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, destination, source);
+	if (value >= INT8_MIN && value <= INT8_MAX) {
+		appendU8(&text, 0x6B);
+		emitModRM(3, destination, source);
+		appendU8(&text, (uint8_t)value);
+	} else {
+		appendU8(&text, 0x69);
+		emitModRM(3, destination, source);
+		appendU32(&text, (uint32_t)value);
+	}
+}
+
+void x86WideMul(bool isSigned, enum X86Register source) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction(isSigned ? "imul " : "mul ");
+		emitAsm(registerNames[source]);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, 0, source);
+	appendU8(&text, 0xF7);
+	emitModRM(3, isSigned ? 5 : 4, source);
+}
+
+void x86Neg(enum X86Register reg) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("neg ");
+		emitAsm(registerNames[reg]);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, 0, reg);
+	appendU8(&text, 0xF7);
+	emitModRM(3, 3, reg);
+}
+
+void x86Cqo() {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsm("	cqo\n");
+		return;
+	}
+
+	appendU8(&text, 0x48);
+	appendU8(&text, 0x99);
+}
+
+void x86Div(bool isSigned, enum X86Register source) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction(isSigned ? "idiv " : "div ");
+		emitAsm(registerNames[source]);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(true, 0, source);
+	appendU8(&text, 0xF7);
+	emitModRM(3, isSigned ? 7 : 6, source);
+}
+
+void x86Push(enum X86Register reg) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("push ");
+		emitAsm(registerNames[reg]);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(false, 0, reg);
+	appendU8(&text, 0x50 + (reg & 7));
+}
+
+void x86Pop(enum X86Register reg) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("pop ");
+		emitAsm(registerNames[reg]);
+		emitAsmChar('\n');
+		return;
+	}
+
+	emitRex(false, 0, reg);
+	appendU8(&text, 0x58 + (reg & 7));
+}
+
+void x86Call(uint32_t functionID, const char* identifier) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("call _");
+		emitAsm(identifier);
+		emitAsmChar('\n');
+		return;
+	}
+
+	appendU8(&text, 0xE8);
+	addFixup(&functionFixups, text.length, functionID);
+	appendU32(&text, 0);
+}
+
+void x86JumpFunction(uint32_t functionID, const char* identifier) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("jmp _");
+		emitAsm(identifier);
+		emitAsmChar('\n');
+		return;
+	}
+
+	appendU8(&text, 0xE9);
+	addFixup(&functionFixups, text.length, functionID);
+	appendU32(&text, 0);
+}
+
+void x86Ret() {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsm("	ret\n");
+		return;
+	}
+
+	appendU8(&text, 0xC3);
+}
+
+void x86Jump(uint32_t blockIndex) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsmInstruction("jmp ");
+		emitAsmBlockLabel(blockIndex);
+		emitAsmChar('\n');
+		return;
+	}
+
+	appendU8(&text, 0xE9);
+	addFixup(&blockFixups, text.length, blockIndex);
+	appendU32(&text, 0);
+}
+
+void x86JumpIf(enum X86Condition condition, uint32_t blockIndex) {
+	if (outputMode == X86_OUTPUT_ASM) {
+		static const char* const mnemonics[] = {
+			"", "", "jb ", "jae ", "je ", "jne ", "jbe ", "ja ",
+			"", "", "", "", "jl ", "jge ", "jle ", "jg ",
+		};
+		emitAsmInstruction(mnemonics[condition]);
+		emitAsmBlockLabel(blockIndex);
+		emitAsmChar('\n');
+		return;
+	}
+
+	appendU8(&text, 0x0F);
+	appendU8(&text, 0x80 + condition);
+	addFixup(&blockFixups, text.length, blockIndex);
+	appendU32(&text, 0);
+}
+
+void x86Syscall() {
+	if (outputMode == X86_OUTPUT_ASM) {
+		emitAsm("	syscall\n");
+		return;
+	}
+
+	appendU8(&text, 0x0F);
+	appendU8(&text, 0x05);
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "byte_array.h"
+
+//instruction emitter shared by the text and machine code outputs
+//the backend describes instructions once, the mode decides whether they become nasm text or bytes
+enum X86OutputMode {
+	X86_OUTPUT_ASM, //nasm text through the asm writer
+	X86_OUTPUT_MACHINE, //machine code, written out as elf by the elf writer
+};
+
+//numbered as in the instruction encoding
+enum X86Register {
+	X86_RAX, X86_RCX, X86_RDX, X86_RBX, X86_RSP, X86_RBP, X86_RSI, X86_RDI,
+	X86_R8, X86_R9, X86_R10, X86_R11, X86_R12, X86_R13, X86_R14, X86_R15,
+
+	X86_REGISTER_COUNT,
+};
+
+//no register, e.g. an lea without an index
+#define X86_REGISTER_NONE X86_REGISTER_COUNT
+
+//numbered as the /digit of the 0x81 group
+enum X86ArithOp {
+	X86_ADD = 0,
+	X86_OR = 1,
+	X86_AND = 4,
+	X86_SUB = 5,
+	X86_XOR = 6,
+	X86_CMP = 7,
+};
+
+//numbered as the /digit of the 0xC1 group
+enum X86ShiftOp {
+	X86_SHL = 4,
+	X86_SHR = 5,
+	X86_SAR = 7,
+};
+
+//numbered as the low nibble of jcc
+enum X86Condition {
+	X86_CONDITION_B = 0x2,
+	X86_CONDITION_AE = 0x3,
+	X86_CONDITION_E = 0x4,
+	X86_CONDITION_NE = 0x5,
+	X86_CONDITION_BE = 0x6,
+	X86_CONDITION_A = 0x7,
+	X86_CONDITION_L = 0xC,
+	X86_CONDITION_GE = 0xD,
+	X86_CONDITION_LE = 0xE,
+	X86_CONDITION_G = 0xF,
+};
+
+//how a machine code location refers to a label, once all labels are placed
+enum X86FixupType {
+	X86_FIXUP_ABS64, //absolute address of a static variable, becomes a relocation in objects
+	X86_FIXUP_REL32, //pc relative displacement to the end of the 4 bytes
+};
+
+//finished machine code, owned by the emitter until resetX86Emitter() or freeX86Code()
+struct X86Code {
+	struct ByteArray text;
+	struct ByteArray data;
+	size_t entryOffset; //offset of the entry function in text
+
+	//absolute data addresses still to be filled in, offsets into text of the 8 byte fields
+	//the field already holds the offset into data
+	size_t relocationCount;
+	size_t* relocationOffsets;
+};
+
+//MUST be called before emitting, asmFile is only used for X86_OUTPUT_ASM
+void resetX86Emitter(enum X86OutputMode mode, FILE* asmFile);
+//finishes the text output, or resolves every label and returns the machine code
+struct X86Code finishX86Emitter();
+void freeX86Code(struct X86Code* code);
+
+const char* x86RegisterName(enum X86Register reg);
+
+//sections, data must come before text
+void x86BeginDataSection();
+void x86BeginTextSection();
+
+//static variable labelled sv_ID, data is elementCount elements of elementSize bytes stored little endian
+void x86DefineStatic(uint32_t ID, size_t elementSize, const char* data, size_t elementCount);
+
+//functions are labelled by the identifier, the entry function is _start
+void x86BeginFunction(uint32_t ID, const char* identifier, bool entry);
+//block labels are local to the function, jumps to them are resolved here
+void x86EndFunction();
+void x86DefineBlock(uint32_t blockIndex);
+
+//a comment on its own line, ignored for machine code
+void x86Comment(const char* text);
+
+void x86MovImm(enum X86Register destination, uint64_t value);
+void x86MovStaticAddress(enum X86Register destination, uint32_t staticID);
+void x86Mov(enum X86Register destination, enum X86Register source);
+void x86Xchg(enum X86Register first, enum X86Register second);
+//extends the low 8, 16 or 32 bits of the register over the whole register, with sign or zero extension
+void x86Extend(bool isSigned, uint8_t bits, enum X86Register reg);
+//stack frame accesses, relative to rbp
+void x86LoadFrame(enum X86Register destination, int32_t displacement);
+void x86StoreFrame(int32_t displacement, enum X86Register source);
+void x86Arith(enum X86ArithOp op, enum X86Register destination, enum X86Register source);
+void x86ArithImm(enum X86ArithOp op, enum X86Register destination, int32_t value);
+//destination = base + index * scale + displacement, scale is 1, 2, 4 or 8
+void x86Lea(enum X86Register destination, enum X86Register base, enum X86Register index, uint8_t scale, int32_t displacement);
+void x86ShiftImm(enum X86ShiftOp op, enum X86Register destination, uint8_t count);
+void x86Imul(enum X86Register destination, enum X86Register source);
+void x86ImulImm(enum X86Register destination, enum X86Register source, int32_t value);
+//multiplies rax by the source, the full product is in rdx:rax
+void x86WideMul(bool isSigned, enum X86Register source);
+void x86Neg(enum X86Register reg);
+//sign extends rax into rdx, for signed division
+void x86Cqo();
+//divides rdx:rax by the source, quotient in rax and remainder in rdx
+void x86Div(bool isSigned, enum X86Register source);
+void x86Push(enum X86Register reg);
+void x86Pop(enum X86Register reg);
+
+void x86Call(uint32_t functionID, const char* identifier);
+//jumps to the start of a function, for calls whose return can go straight back to the caller's caller
+void x86JumpFunction(uint32_t functionID, const char* identifier);
+void x86Ret();
+void x86Jump(uint32_t blockIndex);
+void x86JumpIf(enum X86Condition condition, uint32_t blockIndex);
+void x86Syscall();
\ No newline at end of file
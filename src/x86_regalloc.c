@@ -0,0 +1,598 @@
+#include "x86_regalloc.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "magic_division.h"
+
+#define POSITION_NONE SIZE_MAX
+
+const enum X86Register x86ArgumentRegisters[6] = {
+	X86_RDI, X86_RSI, X86_RDX, X86_RCX, X86_R8, X86_R9,
+};
+
+//in order of preference, caller saved first since they dont need saving in the prologue
+static const enum X86Register callerSavedRegisters[] = {
+	X86_RAX, X86_RCX, X86_RDX, X86_RSI, X86_RDI, X86_R8, X86_R9,
+};
+static const enum X86Register calleeSavedRegisters[] = {
+	X86_RBX, X86_R12, X86_R13, X86_R14, X86_R15,
+};
+
+#define REGISTER_BIT(reg) ((uint16_t)1 << (reg))
+
+//registers instructions overwrite, a variable live across one cant be kept in them
+#define CALL_CLOBBERS (REGISTER_BIT(X86_RAX) | REGISTER_BIT(X86_RCX) | REGISTER_BIT(X86_RDX) | REGISTER_BIT(X86_RSI) | REGISTER_BIT(X86_RDI) | REGISTER_BIT(X86_R8) | REGISTER_BIT(X86_R9) | REGISTER_BIT(X86_R10) | REGISTER_BIT(X86_R11))
+#define SYSCALL_CLOBBERS (REGISTER_BIT(X86_RAX) | REGISTER_BIT(X86_RCX) | REGISTER_BIT(X86_R11))
+#define PRINT_CLOBBERS (SYSCALL_CLOBBERS | REGISTER_BIT(X86_RDI) | REGISTER_BIT(X86_RSI) | REGISTER_BIT(X86_RDX))
+#define DIVIDE_CLOBBERS (REGISTER_BIT(X86_RAX) | REGISTER_BIT(X86_RDX))
+
+//positions count two per instruction, operands are used at the even one and results defined at the odd one
+//every block also has a header position before its instructions where its arguments are defined
+struct LiveInterval {
+	size_t start;
+	size_t end;
+	uint32_t variableID;
+};
+
+//instruction indices, in the same numbering as positions, where a register is clobbered
+struct ClobberList {
+	size_t* indices;
+	size_t count;
+};
+
+//spilled intervals still live, a min heap by end so their slots can be reused once they expire
+struct SlotHeap {
+	struct LiveInterval* intervals;
+	uint32_t* slots;
+	size_t count;
+};
+
+bool x86IsCalleeSaved(enum X86Register reg) {
+	return reg == X86_RBX || reg == X86_RBP || (reg >= X86_R12 && reg <= X86_R15);
+}
+
+uint16_t instructionClobbers(const struct IRFunction* function, const struct IRInstruction* instruction) {
+	switch (instruction->ID) {
+		case IR_DIVIDE:
+		case IR_REMAINDER: {
+			//divisions by powers of two are lowered to shifts
+			struct IROperand divisor = instruction->operands[1];
+			bool isSigned = irOperandType(function, instruction->operands[0]).type == IR_INTEGER;
+			if (divisor.variableID == 0 && isShiftDivisor(irConstantValue(divisor), isSigned)) {
+				return 0;
+			}
+			return DIVIDE_CLOBBERS;
+		}
+
+		case IR_PRINT:
+		return PRINT_CLOBBERS;
+
+		default:
+		if (irIsSpecID(instruction->ID)) {
+			return 0;
+		}
+		return CALL_CLOBBERS;
+	}
+}
+
+static inline void extendInterval(struct LiveInterval* intervals, uint32_t variableID, size_t position) {
+	if (variableID == 0 || irIsStaticVariable(variableID)) {
+		return;
+	}
+	struct LiveInterval* interval = &intervals[variableID];
+	if (interval->start == POSITION_NONE || position < interval->start) {
+		interval->start = position;
+	}
+	if (interval->end == POSITION_NONE || position > interval->end) {
+		interval->end = position;
+	}
+}
+
+static inline bool testBit(const uint64_t* bits, uint32_t index) {
+	return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+static inline void setBit(uint64_t* bits, uint32_t index) {
+	bits[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+//bit per variable for each block, whether the variable is live when control enters the block
+//liveOut is filled in the same way for the end of each block, both are words per block long
+void computeLiveness(const struct IRFunction* function, size_t words, uint64_t* liveIn, uint64_t* liveOut) {
+	size_t setsSize = function->blockCount * words * sizeof(uint64_t);
+	uint64_t* uses = arenaAlloc(ARENA_CODEGEN, setsSize);
+	uint64_t* definitions = arenaAlloc(ARENA_CODEGEN, setsSize);
+	memset(uses, 0, setsSize);
+	memset(definitions, 0, setsSize);
+	memset(liveIn, 0, setsSize);
+	memset(liveOut, 0, setsSize);
+
+	//uses before any definition in the block, and definitions
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		uint64_t* blockUses = uses + i * words;
+		uint64_t* blockDefinitions = definitions + i * words;
+		for (uint32_t j = 0; j < block->argumentCount; ++j) {
+			setBit(blockDefinitions, block->argumentIDs[j]);
+		}
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+			if (instruction->ID == IR_DECLARE) {
+				continue;
+			}
+			for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+				uint32_t variableID = instruction->operands[k].variableID;
+				if (variableID != 0 && !irIsStaticVariable(variableID) && !testBit(blockDefinitions, variableID)) {
+					setBit(blockUses, variableID);
+				}
+			}
+			for (uint32_t k = 0; k < instruction->resultCount; ++k) {
+				if (instruction->results[k] != 0 && !irIsStaticVariable(instruction->results[k])) {
+					setBit(blockDefinitions, instruction->results[k]);
+				}
+			}
+		}
+	}
+
+	//backwards until nothing changes, blocks mostly jump forwards so this takes few rounds
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (size_t i = function->blockCount; i > 0; --i) {
+			size_t blockIndex = i - 1;
+			uint64_t* in = liveIn + blockIndex * words;
+			uint64_t* out = liveOut + blockIndex * words;
+
+			size_t successors[2];
+			uint32_t successorCount = irBlockSuccessors(function, blockIndex, successors);
+			for (uint32_t j = 0; j < successorCount; ++j) {
+				const uint64_t* successorIn = liveIn + successors[j] * words;
+				for (size_t k = 0; k < words; ++k) {
+					out[k] |= successorIn[k];
+				}
+			}
+
+			for (size_t k = 0; k < words; ++k) {
+				uint64_t word = uses[blockIndex * words + k] | (out[k] & ~definitions[blockIndex * words + k]);
+				if (word != in[k]) {
+					in[k] = word;
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
+//widens intervals to cover every block a variable is live through, so values used around a loop stay put for all of it
+void extendIntervalsOverBlocks(const struct IRFunction* function, struct LiveInterval* intervals) {
+	size_t words = (function->variableCount + 63) / 64;
+	size_t setsSize = function->blockCount * words * sizeof(uint64_t);
+	uint64_t* liveIn = arenaAlloc(ARENA_CODEGEN, setsSize);
+	uint64_t* liveOut = arenaAlloc(ARENA_CODEGEN, setsSize);
+	computeLiveness(function, words, liveIn, liveOut);
+
+	size_t index = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		size_t header = index;
+		index += 1 + function->blocks[i].instructionCount;
+
+		for (size_t word = 0; word < words; ++word) {
+			uint64_t in = liveIn[i * words + word];
+			uint64_t out = liveOut[i * words + word];
+			for (uint32_t bit = 0; bit < 64 && (in | out) >> bit != 0; ++bit) {
+				uint32_t variableID = word * 64 + bit;
+				if ((in >> bit) & 1) {
+					extendInterval(intervals, variableID, 2 * header);
+				}
+				if ((out >> bit) & 1) {
+					extendInterval(intervals, variableID, 2 * (index - 1) + 1);
+				}
+			}
+		}
+	}
+}
+
+//variables are only ever defined once in ssa, in a single block function an interval from first to last reference covers it
+//with more blocks intervals are widened by liveness, as blocks can be jumped back to
+void buildIntervals(const struct IRFunction* function, struct LiveInterval* intervals, struct ClobberList* clobbers, enum X86Register* hints) {
+	for (uint32_t i = 0; i < function->variableCount; ++i) {
+		intervals[i].start = POSITION_NONE;
+		intervals[i].end = POSITION_NONE;
+		intervals[i].variableID = i;
+		hints[i] = X86_REGISTER_NONE;
+	}
+	for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+		clobbers[reg].count = 0;
+	}
+
+	//inputs arrive in the argument registers
+	for (uint32_t i = 0; i < function->inputCount && i < X86_ARGUMENT_REGISTER_COUNT; ++i) {
+		hints[i + 1] = x86ArgumentRegisters[i];
+	}
+
+	size_t index = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		for (uint32_t j = 0; j < block->argumentCount; ++j) {
+			extendInterval(intervals, block->argumentIDs[j], 2 * index + 1);
+		}
+		++index;
+
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			const struct IRInstruction* instruction = &block->instructions[j];
+
+			//declarations only give the type, the value is defined by the move into it
+			if (instruction->ID != IR_DECLARE) {
+				for (uint32_t k = 0; k < instruction->operandCount; ++k) {
+					extendInterval(intervals, instruction->operands[k].variableID, 2 * index);
+				}
+				for (uint32_t k = 0; k < instruction->resultCount; ++k) {
+					extendInterval(intervals, instruction->results[k], 2 * index + 1);
+				}
+			}
+
+			uint16_t clobbered = instructionClobbers(function, instruction);
+			for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+				if (clobbered & REGISTER_BIT(reg)) {
+					++clobbers[reg].count;
+				}
+			}
+
+			//call outputs arrive in rax
+			if (!irIsSpecID(instruction->ID) && instruction->resultCount != 0 && instruction->results[0] != 0) {
+				hints[instruction->results[0]] = X86_OUTPUT_REGISTER;
+			}
+			++index;
+		}
+	}
+
+	if (function->blockCount > 1) {
+		extendIntervalsOverBlocks(function, intervals);
+	}
+
+	//second pass fills in the clobber indices now that the counts are known
+	for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+		clobbers[reg].indices = arenaAlloc(ARENA_CODEGEN, clobbers[reg].count * sizeof(size_t));
+		clobbers[reg].count = 0;
+	}
+	index = 0;
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		++index;
+		for (size_t j = 0; j < block->instructionCount; ++j) {
+			uint16_t clobbered = instructionClobbers(function, &block->instructions[j]);
+			for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+				if (clobbered & REGISTER_BIT(reg)) {
+					clobbers[reg].indices[clobbers[reg].count] = index;
+					++clobbers[reg].count;
+				}
+			}
+			++index;
+		}
+	}
+}
+
+//whether two groups of coalesced variables are ever live at once, members are linked in order of start and dont overlap
+bool groupsOverlap(const struct LiveInterval* intervals, const uint32_t* nextMembers, uint32_t first, uint32_t second) {
+	size_t lastEnd = 0;
+	bool any = false;
+	while (first != 0 || second != 0) {
+		uint32_t member;
+		if (second == 0 || (first != 0 && intervals[first].start < intervals[second].start)) {
+			member = first;
+			first = nextMembers[first];
+		} else {
+			member = second;
+			second = nextMembers[second];
+		}
+		if (any && intervals[member].start <= lastEnd) {
+			return true;
+		}
+		lastEnd = any && lastEnd > intervals[member].end ? lastEnd : intervals[member].end;
+		any = true;
+	}
+	return false;
+}
+
+//links the members of both groups into one list in order of start, the earliest member leads the group
+void mergeGroups(const struct LiveInterval* intervals, uint32_t* leaders, uint32_t* nextMembers, uint32_t first, uint32_t second) {
+	uint32_t head = 0;
+	uint32_t tail = 0;
+	while (first != 0 || second != 0) {
+		uint32_t member;
+		if (second == 0 || (first != 0 && intervals[first].start < intervals[second].start)) {
+			member = first;
+			first = nextMembers[first];
+		} else {
+			member = second;
+			second = nextMembers[second];
+		}
+		if (head == 0) {
+			head = member;
+		} else {
+			nextMembers[tail] = member;
+		}
+		tail = member;
+	}
+	nextMembers[tail] = 0;
+	for (uint32_t member = head; member != 0; member = nextMembers[member]) {
+		leaders[member] = head;
+	}
+}
+
+//out of ssa, block arguments share a location with the values jumped to them when they are never live at once
+//then the jump has nothing to copy for them, each group is allocated as one interval covering all its members
+//leaders is filled with the variable each variable takes its location from
+void coalesceBlockArguments(const struct IRFunction* function, struct LiveInterval* intervals, enum X86Register* hints, uint32_t* leaders) {
+	uint32_t* nextMembers = arenaAlloc(ARENA_CODEGEN, function->variableCount * sizeof(uint32_t));
+	for (uint32_t i = 0; i < function->variableCount; ++i) {
+		leaders[i] = i;
+		nextMembers[i] = 0;
+	}
+
+	for (size_t i = 0; i < function->blockCount; ++i) {
+		const struct IRBlock* block = &function->blocks[i];
+		if (block->instructionCount == 0) {
+			continue;
+		}
+		const struct IRInstruction* jump = &block->instructions[block->instructionCount - 1];
+		for (uint32_t j = 0; j < jump->targetCount; ++j) {
+			const struct IRTarget* target = &jump->targets[j];
+			const struct IRBlock* targetBlock = &function->blocks[target->block];
+			for (uint32_t k = 0; k < target->argumentCount; ++k) {
+				uint32_t valueID = jump->operands[target->firstArgument + k].variableID;
+				uint32_t argumentID = targetBlock->argumentIDs[k];
+				if (valueID == 0 || irIsStaticVariable(valueID) || intervals[valueID].start == POSITION_NONE || intervals[argumentID].start == POSITION_NONE) {
+					continue;
+				}
+				uint32_t first = leaders[valueID];
+				uint32_t second = leaders[argumentID];
+				if (first != second && !groupsOverlap(intervals, nextMembers, first, second)) {
+					mergeGroups(intervals, leaders, nextMembers, first, second);
+				}
+			}
+		}
+	}
+
+	//the leader's interval becomes the whole group's, taking the first hint among the members
+	for (uint32_t i = 1; i < function->variableCount; ++i) {
+		if (leaders[i] != i || nextMembers[i] == 0) {
+			continue;
+		}
+		for (uint32_t member = nextMembers[i]; member != 0; member = nextMembers[member]) {
+			if (intervals[member].end > intervals[i].end) {
+				intervals[i].end = intervals[member].end;
+			}
+			if (hints[i] == X86_REGISTER_NONE) {
+				hints[i] = hints[member];
+			}
+			intervals[member].start = POSITION_NONE;
+		}
+	}
+}
+
+//whether the register is overwritten while the interval is live
+//operands are read before and results written after the instruction, so only instructions strictly inside count
+bool crossesClobber(const struct ClobberList* clobbers, enum X86Register reg, const struct LiveInterval* interval) {
+	const struct ClobberList* list = &clobbers[reg];
+
+	//first clobbering instruction after the start
+	size_t low = 0;
+	size_t high = list->count;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (2 * list->indices[middle] > interval->start) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+	return low < list->count && 2 * list->indices[low] + 1 < interval->end;
+}
+
+int compareIntervals(const void* a, const void* b) {
+	const struct LiveInterval* first = a;
+	const struct LiveInterval* second = b;
+	if (first->start != second->start) {
+		return first->start < second->start ? -1 : 1;
+	}
+	if (first->variableID != second->variableID) {
+		return first->variableID < second->variableID ? -1 : 1;
+	}
+	return 0;
+}
+
+void pushSlot(struct SlotHeap* heap, struct LiveInterval interval, uint32_t slot) {
+	size_t i = heap->count;
+	++heap->count;
+	while (i > 0 && heap->intervals[(i - 1) / 2].end > interval.end) {
+		heap->intervals[i] = heap->intervals[(i - 1) / 2];
+		heap->slots[i] = heap->slots[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap->intervals[i] = interval;
+	heap->slots[i] = slot;
+}
+
+uint32_t popSlot(struct SlotHeap* heap) {
+	uint32_t slot = heap->slots[0];
+	--heap->count;
+	struct LiveInterval last = heap->intervals[heap->count];
+	uint32_t lastSlot = heap->slots[heap->count];
+
+	size_t i = 0;
+	while (2 * i + 1 < heap->count) {
+		size_t child = 2 * i + 1;
+		if (child + 1 < heap->count && heap->intervals[child + 1].end < heap->intervals[child].end) {
+			++child;
+		}
+		if (heap->intervals[child].end >= last.end) {
+			break;
+		}
+		heap->intervals[i] = heap->intervals[child];
+		heap->slots[i] = heap->slots[child];
+		i = child;
+	}
+	heap->intervals[i] = last;
+	heap->slots[i] = lastSlot;
+	return slot;
+}
+
+struct X86Allocation allocateX86Registers(const struct IRFunction* function) {
+	uint32_t variableCount = function->variableCount;
+
+	struct X86Allocation allocation;
+	allocation.registers = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(enum X86Register));
+	allocation.stackSlots = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(uint32_t));
+	allocation.stackSlotCount = 0;
+	allocation.calleeSavedUsed = 0;
+
+	struct LiveInterval* intervals = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(struct LiveInterval));
+	enum X86Register* hints = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(enum X86Register));
+	struct ClobberList clobbers[X86_REGISTER_COUNT];
+	buildIntervals(function, intervals, clobbers, hints);
+	uint32_t* leaders = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(uint32_t));
+	coalesceBlockArguments(function, intervals, hints, leaders);
+
+	for (uint32_t i = 0; i < variableCount; ++i) {
+		allocation.registers[i] = X86_REGISTER_NONE;
+		allocation.stackSlots[i] = 0;
+	}
+
+	//unreferenced variables need no location, the rest are scanned in order of start
+	size_t intervalCount = 0;
+	for (uint32_t i = 0; i < variableCount; ++i) {
+		if (intervals[i].start != POSITION_NONE) {
+			intervals[intervalCount] = intervals[i];
+			++intervalCount;
+		}
+	}
+	qsort(intervals, intervalCount, sizeof(struct LiveInterval), compareIntervals);
+
+	//live intervals in registers, sorted by end, theres at most one per register
+	struct LiveInterval active[X86_REGISTER_COUNT];
+	size_t activeCount = 0;
+	bool registerFree[X86_REGISTER_COUNT];
+	for (size_t reg = 0; reg < X86_REGISTER_COUNT; ++reg) {
+		registerFree[reg] = false;
+	}
+	for (size_t i = 0; i < sizeof(callerSavedRegisters) / sizeof(callerSavedRegisters[0]); ++i) {
+		registerFree[callerSavedRegisters[i]] = true;
+	}
+	for (size_t i = 0; i < sizeof(calleeSavedRegisters) / sizeof(calleeSavedRegisters[0]); ++i) {
+		registerFree[calleeSavedRegisters[i]] = true;
+	}
+
+	struct SlotHeap spilled;
+	spilled.intervals = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(struct LiveInterval));
+	spilled.slots = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(uint32_t));
+	spilled.count = 0;
+	uint32_t* freeSlots = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(uint32_t));
+	size_t* freeSlotEnds = arenaAlloc(ARENA_CODEGEN, variableCount * sizeof(size_t)); //end of the interval last in the slot
+	uint32_t freeSlotCount = 0;
+
+	for (size_t i = 0; i < intervalCount; ++i) {
+		struct LiveInterval current = intervals[i];
+
+		//expire intervals that ended before this one starts
+		size_t expired = 0;
+		while (expired < activeCount && active[expired].end < current.start) {
+			registerFree[allocation.registers[active[expired].variableID]] = true;
+			++expired;
+		}
+		memmove(active, active + expired, (activeCount - expired) * sizeof(struct LiveInterval));
+		activeCount -= expired;
+		while (spilled.count > 0 && spilled.intervals[0].end < current.start) {
+			freeSlotEnds[freeSlotCount] = spilled.intervals[0].end;
+			freeSlots[freeSlotCount] = popSlot(&spilled);
+			++freeSlotCount;
+		}
+
+		//hinted register, then caller saved, then callee saved
+		enum X86Register chosen = X86_REGISTER_NONE;
+		enum X86Register hint = hints[current.variableID];
+		if (hint != X86_REGISTER_NONE && registerFree[hint] && !crossesClobber(clobbers, hint, &current)) {
+			chosen = hint;
+		}
+		for (size_t j = 0; chosen == X86_REGISTER_NONE && j < sizeof(callerSavedRegisters) / sizeof(callerSavedRegisters[0]); ++j) {
+			enum X86Register reg = callerSavedRegisters[j];
+			if (registerFree[reg] && !crossesClobber(clobbers, reg, &current)) {
+				chosen = reg;
+			}
+		}
+		for (size_t j = 0; chosen == X86_REGISTER_NONE && j < sizeof(calleeSavedRegisters) / sizeof(calleeSavedRegisters[0]); ++j) {
+			enum X86Register reg = calleeSavedRegisters[j];
+			if (registerFree[reg] && !crossesClobber(clobbers, reg, &current)) {
+				chosen = reg;
+			}
+		}
+
+		//no free register, spill whichever usable interval ends last
+		struct LiveInterval toSpill = current;
+		if (chosen == X86_REGISTER_NONE) {
+			size_t victim = activeCount;
+			for (size_t j = 0; j < activeCount; ++j) {
+				enum X86Register reg = allocation.registers[active[j].variableID];
+				if (active[j].end > current.end && !crossesClobber(clobbers, reg, &current) && (victim == activeCount || active[j].end > active[victim].end)) {
+					victim = j;
+				}
+			}
+
+			if (victim != activeCount) {
+				toSpill = active[victim];
+				chosen = allocation.registers[toSpill.variableID];
+				allocation.registers[toSpill.variableID] = X86_REGISTER_NONE;
+				memmove(active + victim, active + victim + 1, (activeCount - victim - 1) * sizeof(struct LiveInterval));
+				--activeCount;
+				registerFree[chosen] = true;
+			}
+
+			//a spilled active interval started earlier, so it can only take a slot freed before its start
+			uint32_t slot = allocation.stackSlotCount;
+			size_t freeIndex = freeSlotCount;
+			while (freeIndex > 0 && freeSlotEnds[freeIndex - 1] >= toSpill.start) {
+				--freeIndex;
+			}
+			if (freeIndex > 0) {
+				slot = freeSlots[freeIndex - 1];
+				--freeSlotCount;
+				freeSlots[freeIndex - 1] = freeSlots[freeSlotCount];
+				freeSlotEnds[freeIndex - 1] = freeSlotEnds[freeSlotCount];
+			} else {
+				++allocation.stackSlotCount;
+			}
+			allocation.stackSlots[toSpill.variableID] = slot;
+			pushSlot(&spilled, toSpill, slot);
+		}
+
+		if (chosen == X86_REGISTER_NONE) {
+			continue;
+		}
+
+		//insert into active, keeping it sorted by end
+		allocation.registers[current.variableID] = chosen;
+		registerFree[chosen] = false;
+		if (x86IsCalleeSaved(chosen)) {
+			allocation.calleeSavedUsed |= REGISTER_BIT(chosen);
+		}
+		size_t position = activeCount;
+		while (position > 0 && active[position - 1].end > current.end) {
+			active[position] = active[position - 1];
+			--position;
+		}
+		active[position] = current;
+		++activeCount;
+	}
+
+	for (uint32_t i = 0; i < variableCount; ++i) {
+		allocation.registers[i] = allocation.registers[leaders[i]];
+		allocation.stackSlots[i] = allocation.stackSlots[leaders[i]];
+	}
+	return allocation;
+}
\ No newline at end of file
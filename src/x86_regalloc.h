@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ir.h"
+#include "x86_emit.h"
+
+//never allocated, instruction lowering is free to use them between instructions
+#define X86_SCRATCH_A X86_R10
+#define X86_SCRATCH_B X86_R11
+
+//where every variable of a function lives, allocated in the codegen arena
+struct X86Allocation {
+	enum X86Register* registers; //by variable ID, X86_REGISTER_NONE when spilled to a stack slot
+	uint32_t* stackSlots; //by variable ID, only for spilled variables
+	uint32_t stackSlotCount;
+	uint16_t calleeSavedUsed; //bit per register number
+};
+
+//registers for the first arguments and the output of calls, system v
+extern const enum X86Register x86ArgumentRegisters[6];
+#define X86_ARGUMENT_REGISTER_COUNT 6
+#define X86_OUTPUT_REGISTER X86_RAX
+
+bool x86IsCalleeSaved(enum X86Register reg);
+
+//linear scan over the live intervals of every variable, variables live for a single interval across the function
+//intervals that cross an instruction clobbering a register cant be given that register, spills go to reusable slots
+//block arguments are coalesced with the values jumped to them when never live at once, so they share a location
+struct X86Allocation allocateX86Registers(const struct IRFunction* function);
\ No newline at end of file
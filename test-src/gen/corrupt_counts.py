@@ -0,0 +1,31 @@
+#bytecode with a count or function ID far larger than the bytecode or function table, which the backend has to reject
+#rather than allocating for it
+#usage: python3 test-src/gen/corrupt_counts.py call|function|table|spec|definition|index > corrupt.xpb
+import sys
+from xpb import *
+
+f = function(0, [I64], [I64], [block([ret(1)], first=True)])
+main = function(1, [I64], [], [block([call(0, [1], [const(1)]), ret(1)], first=True)])
+functions = [f, main]
+names = {0: "f", 1: "main"}
+
+if sys.argv[1] == "call":
+	#main calls f with 2^32 - 16 inputs but passes one
+	corruptCall = u32(0) + u32(1) + u32(-16) + u32(1) + source(const(1))
+	main = function(1, [I64], [], [block([corruptCall, ret(1)], first=True)])
+	functions = [f, main]
+elif sys.argv[1] == "function":
+	#f states 2^32 - 16 inputs but has the types of one
+	f = (0, u32(0) + u64(1) + u32(1) + u32(-16) + valueType(I64) + valueType(I64) + block([ret(1)], first=True))
+	functions = [f, main]
+elif sys.argv[1] == "table":
+	#a table of three functions naming one 2^31 - 16
+	names[0x7FFFFFF0] = "g"
+elif sys.argv[1] == "spec":
+	#a spec ID half the ID space from the max, far past any the spec defines
+	names[0x80000000] = "g"
+else:
+	#a definition, or an index entry, of a function 2^31 - 16 which the table doesnt name
+	functions.append(function(0x7FFFFFF0, [I64], [], [block([ret(const(1))], first=True)]))
+
+write(functions, names, index=sys.argv[1] == "index")
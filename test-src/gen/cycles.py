@@ -0,0 +1,54 @@
+#loops whose back edge passes the block arguments on rotated, so the parallel copy at the jump is one cycle
+#two values are swapped, three rotated, and twenty are more than the registers so the cycle goes through frame slots
+#usage: python3 test-src/gen/cycles.py > cycles.xpb, the program exits with 249
+from xpb import *
+
+SIZES = [2, 3, 20]
+TRIPS = 7
+
+#rotate(n) starts from 1 ... size and rotates them by one on each of n - 1 trips, then returns acc * 3 + value over them
+def rotate(ID, size):
+	values = list(range(2, 2 + size))
+	counter = 2 + size
+	decremented = counter + 1
+	first = block([jump(1, [const(v + 1) for v in range(size)] + [1])], [1], first=True)
+	loop = block([arithmetic("-", decremented, counter, const(1)), branch(decremented, (1, values[1:] + values[:1] + [decremented]), (2, values))], values + [counter])
+
+	results = list(range(decremented + 1, decremented + 1 + size))
+	instructions = []
+	acc = results[0]
+	variable = results[-1] + 1
+	for result in results[1:]:
+		instructions.append(arithmetic("*", variable, acc, const(3)))
+		instructions.append(arithmetic("+", variable + 1, variable, result))
+		acc = variable + 1
+		variable += 2
+	instructions.append(ret(acc))
+	return function(ID, [I64], [I64], [first, loop, block(instructions, results)])
+
+def expected():
+	total = 0
+	for size in SIZES:
+		values = list(range(1, size + 1))
+		for _ in range(TRIPS - 1):
+			values = values[1:] + values[:1]
+		acc = values[0]
+		for value in values[1:]:
+			acc = acc * 3 + value
+		total += acc
+	return total % 256
+
+functions = [rotate(ID, size) for ID, size in enumerate(SIZES)]
+mainID = len(SIZES)
+instructions = [call(ID, [ID + 1], [const(TRIPS)]) for ID in range(len(SIZES))]
+total = 1
+for ID in range(1, len(SIZES)):
+	instructions.append(arithmetic("+", mainID + ID + 1, total, ID + 1))
+	total = mainID + ID + 1
+instructions.append(arithmetic("%", total + 1, total, const(256)))
+instructions.append(ret(total + 1))
+functions.append(function(mainID, [I64], [], [block(instructions, first=True)]))
+
+names = {ID: "rotate%d" % size for ID, size in enumerate(SIZES)}
+names[mainID] = "main"
+write(functions, names)
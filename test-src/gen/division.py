@@ -0,0 +1,74 @@
+#division and remainder by constants of one integer type, checked against a model of truncating division
+#constant divisors are lowered to shifts or multiplications by a magic number, so each divisor gets its own functions
+#the remainder is written as n - n / d * d, as the parser has no remainder operator
+#usage: python3 test-src/gen/division.py <type> > division.txt, e.g. i64 or u8
+#the program exits with how many results were wrong, up to 255
+import sys
+
+TYPES = {"i8": (True, 8), "i16": (True, 16), "i32": (True, 32), "i64": (True, 64),
+	"u8": (False, 8), "u16": (False, 16), "u32": (False, 32), "u64": (False, 64)}
+name = sys.argv[1]
+signed, bits = TYPES[name]
+low = -(1 << (bits - 1)) if signed else 0
+high = (1 << (bits - 1)) - 1 if signed else (1 << bits) - 1
+
+def wrap(value):
+	value &= (1 << bits) - 1
+	if signed and value >= 1 << (bits - 1):
+		value -= 1 << bits
+	return value
+
+def divide(a, b):
+	quotient = abs(a) // abs(b)
+	return quotient if (a < 0) == (b < 0) else -quotient
+
+def literal(value):
+	return str(value) if value >= 0 else "(0 - %d)" % -value
+
+#the 64 bit divisors and dividends include the ones the magic numbers are hardest on
+if bits == 64 and signed:
+	divisors = [3, 5, 7, 10, -3, -7, 2, -2, 4, -8, 1, -1, 641, 1 << 40, -(1 << 40), 0x7FFFFFFF, 1000000007,
+		(1 << 62) + 12345, -(1 << 62) - 7, 6, -6, 25, 1 << 31, -(1 << 31), 1 << 32]
+elif bits == 64:
+	divisors = [3, 7, 10, 641, (1 << 32) + 1, 0x8000000000000001, 1 << 63, 1, 2, 16, high, high - 1,
+		1 << 33, 0xFFFFFFFF, 1000000007, (1 << 31) - 1]
+else:
+	divisors = [1, 2, 3, 5, 6, 7, 10, 25, 100, 641, high, high - 1, 1 << (bits - 2), (1 << (bits - 1)) - 3]
+	if signed:
+		divisors += [-1, -2, -3, -7, -8, -100, low, low + 1]
+	else:
+		divisors += [1 << (bits - 1), (1 << (bits - 1)) + 1]
+divisors = sorted(set(wrap(d) for d in divisors if d <= high and wrap(d) != 0), key=abs)
+
+dividends = [0, 1, 7, 100, 641, high, high - 1, high // 3, wrap(12345678901)]
+if signed:
+	dividends += [-1, -7, -100, -641, low, low + 1, low // 3]
+dividends = sorted(set(wrap(n) for n in dividends))
+
+functions = []
+calls = []
+for index, d in enumerate(divisors):
+	functions.append("quotient%d(n : %s) : %s {\n\treturn n / %s;\n}\n" % (index, name, name, literal(d)))
+	functions.append("remainder%d(n : %s) : %s {\n\tq : %s = n / %s;\n\treturn n - q * %s;\n}\n"
+		% (index, name, name, name, literal(d), literal(d)))
+	for n in dividends:
+		#the minimum divided by -1 overflows, which traps at 64 bits
+		if bits == 64 and signed and n == low and d == -1:
+			continue
+		q = wrap(divide(n, d))
+		r = wrap(n - q * d)
+		for function, expected in (("quotient", q), ("remainder", r)):
+			calls.append("\tv = %s%d(%s);\n\twrong = wrong + isNotZero(v - %d);\n" % (function, index, literal(n), expected % (1 << 64)))
+
+sys.stdout.write("".join(functions))
+sys.stdout.write("""isNotZero(x : u64) : u64 {
+	half : u64 = x / 2;
+	return (half + (x - half * 2) + 0x7FFFFFFFFFFFFFFF) / 0x8000000000000000;
+}
+
+main() : i64 {
+	wrong : u64 = 0;
+	v : u64 = 0;
+""")
+sys.stdout.write("".join(calls))
+sys.stdout.write("\treturn wrong - (wrong - 255) * isNotZero(wrong / 255);\n}\n")
@@ -0,0 +1,51 @@
+#one expression with a million terms, for the parser's explicit stacks
+#"long" is a flat chain of + - * over the parameters, "deep" nests the parameter in a million parentheses
+#usage: python3 test-src/gen/expression.py long|deep [terms] > expression.txt
+#then: time bin/release/build expression.txt
+#the program exits with 0 when the expression has the value of a Python model
+import random
+import sys
+
+shape = sys.argv[1]
+terms = int(sys.argv[2]) if len(sys.argv) > 2 else 1000000
+random.seed(terms)
+
+MASK = (1 << 64) - 1
+values = {"a": 7, "b": -3, "c": 11}
+
+if shape == "deep":
+	expression = "(" * terms + "a" + " + 1)" * terms
+	expected = values["a"] + terms
+else:
+	#a sum of products, as precedence climbing would see it
+	parts = []
+	expected = 0
+	sign = 1
+	remaining = terms
+	while remaining > 0:
+		factors = [random.choice(["a", "b", "c", str(random.randint(1, 9))]) for _ in range(min(remaining, random.randint(1, 3)))]
+		remaining -= len(factors)
+		product = 1
+		for factor in factors:
+			product = (product * (values[factor] if factor in values else int(factor))) & MASK
+		expected = (expected + sign * product) & MASK
+		parts.append(" * ".join(factors))
+		if remaining > 0:
+			sign = random.choice([1, -1])
+			parts.append("+" if sign == 1 else "-")
+	expression = " ".join(parts)
+
+sys.stdout.write("""f(a : i64, b : i64, c : i64) : i64 {
+	return %s;
+}
+
+isNotZero(x : u64) : u64 {
+	half : u64 = x / 2;
+	return (half + (x - half * 2) + 0x7FFFFFFFFFFFFFFF) / 0x8000000000000000;
+}
+
+main() : i64 {
+	v : u64 = f(7, 0 - 3, 11);
+	return isNotZero(v - %d);
+}
+""" % (expression, expected & MASK))
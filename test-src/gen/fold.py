@@ -0,0 +1,14 @@
+#main() accumulating n statements of constant arithmetic into one variable
+#the parser folds each statement to one add, the ir passes then fold the whole function to its return
+#usage: python3 test-src/gen/fold.py [n] > fold.txt, then bin/debug/build --pass-report fold.txt
+#with the default n of 20000 the program exits with 14
+import sys
+
+count = int(sys.argv[1]) if len(sys.argv) > 1 else 20000
+
+lines = ["main() : i64 {", "\ts : i64 = 0;"]
+for i in range(count):
+	lines.append("\ts = s + (%d * 4 + 3) / 2 - 7 * 3 + %d * (2 + 8);" % (i, i % 13))
+lines.append("\treturn s - s / 256 * 256;")
+lines.append("}")
+sys.stdout.write("\n".join(lines))
@@ -0,0 +1,29 @@
+#redundant arithmetic across blocks, which value numbering over the dominator tree removes
+#usage: python3 test-src/gen/gvn.py > gvn.xpb, the program exits with 129
+from xpb import *
+
+#f(n), both branches pass n on as the block argument, so n * 8 + 4 is the same value in each of them
+f = function(0, [I64], [I64], [
+	block([arithmetic("*", 2, 1, const(8)), arithmetic("+", 3, 2, const(4)), branch(1, (1, [1]), (2, [1]))], [1], first=True),
+	block([arithmetic("*", 5, 4, const(8)), arithmetic("+", 6, 5, const(4)), jump(3, [4, 6])], [4]),
+	block([arithmetic("*", 8, const(8), 7), arithmetic("+", 9, 8, const(4)), arithmetic("+", 10, 9, 9), jump(3, [7, 10])], [7]),
+	block([arithmetic("+", 13, 11, 12), arithmetic("*", 14, 11, const(8)), arithmetic("+", 15, 13, 14), arithmetic("-", 16, 15, 3), ret(16)], [11, 12]),
+])
+
+#g(n), a loop carrying n unchanged which recomputes n * 3 and calls h on every trip
+g = function(1, [I64], [I64], [
+	block([arithmetic("*", 2, 1, const(3)), jump(1, [1, const(0), const(5)])], [1], first=True),
+	block([arithmetic("*", 6, 3, const(3)), arithmetic("+", 7, 4, 6), call(2, [8], [7]), arithmetic("-", 9, 5, const(1)),
+		branch(9, (1, [3, 8, 9]), (2, [8, 2]))], [3, 4, 5]),
+	block([arithmetic("+", 12, 10, 11), ret(12)], [10, 11]),
+])
+
+h = function(2, [I64], [I64], [block([arithmetic("+", 2, 1, const(1)), ret(2)], [1], first=True)])
+
+#f(5) * 1000 + f(0) * 100 + g(2), modulo 256
+main = function(3, [I64], [], [block([
+	call(0, [1], [const(5)]), call(0, [2], [const(0)]), call(1, [3], [const(2)]),
+	arithmetic("*", 4, 1, const(1000)), arithmetic("*", 5, 2, const(100)), arithmetic("+", 6, 4, 5),
+	arithmetic("+", 7, 6, 3), arithmetic("%", 8, 7, const(256)), ret(8)], first=True)])
+
+write([f, g, h, main], {0: "f", 1: "g", 2: "h", 3: "main"})
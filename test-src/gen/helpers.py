@@ -0,0 +1,17 @@
+#a module of n helpers where main only calls three of them, the rest are dropped without being compiled
+#usage: python3 test-src/gen/helpers.py [n] > helpers.txt, the program exits with 94 for the default 3000
+import sys
+
+count = int(sys.argv[1]) if len(sys.argv) > 1 else 3000
+
+lines = []
+for i in range(count):
+	lines.append("h%d(a : i64, b : i64) : i64 {" % i)
+	for j in range(20):
+		lines.append("\tv%d : i64 = a * %d + b - %d;" % (j, j + 2, j))
+	lines.append("\treturn v19 + v3;")
+	lines.append("}")
+lines.append("main() : i64 {")
+lines.append("\treturn h7(1, 2) + h1234(3, 4) - h%d(0, 0);" % (count - 1))
+lines.append("}")
+sys.stdout.write("\n".join(lines))
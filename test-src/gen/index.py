@@ -0,0 +1,32 @@
+#one program written with and without the function index, and with the index or header broken in the ways the backend has to reject
+#usage: python3 test-src/gen/index.py index|no_index|unused|version_0_1|long_entry|short_entry|bad_offset > index.xpb
+#the first three exit with 42
+import struct
+import sys
+from xpb import *
+
+mode = sys.argv[1]
+
+f = function(0, [I64], [I64], [block([arithmetic("+", 2, 1, const(1)), ret(2)], [1], first=True)])
+g = function(1, [I64], [I64], [block([call(0, [2], [1]), arithmetic("*", 3, 2, const(2)), ret(3)], [1], first=True)])
+main = function(2, [I64], [], [block([call(1, [1], [const(20)]), ret(1)], first=True)])
+functions = [f, g, main]
+names = {0: "f", 1: "g", 2: "main"}
+
+if mode == "unused":
+	#nothing calls 3, so with the index it is never decoded and its definition can be anything
+	functions.insert(2, (3, u32(3) + b"\xFF" * 40))
+	names[3] = "unused"
+
+bytecode = bytearray(program(functions, names, mode != "no_index", (0, 1, 0) if mode == "version_0_1" else VERSION))
+
+#entries after the count are ID u32, offset u64 and length u64, g's is the second
+indexOffset = struct.unpack_from("<Q", bytecode, 40)[0]
+entry = indexOffset + 4 + 20
+if mode in ("long_entry", "short_entry"):
+	length = struct.unpack_from("<Q", bytecode, entry + 12)[0]
+	struct.pack_into("<Q", bytecode, entry + 12, length + 1 if mode == "long_entry" else length - 1)
+elif mode == "bad_offset":
+	struct.pack_into("<Q", bytecode, entry + 4, 1 << 40)
+
+sys.stdout.buffer.write(bytes(bytecode))
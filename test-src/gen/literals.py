@@ -0,0 +1,31 @@
+#main() printing text literals until the source is at least n MiB, for lexing it sequentially and in chunks
+#the literals have escaped quotes and backslashes, and most of the source is in literals going over several lines
+#so chunks cant just start at the first newline after where they are meant to
+#usage: python3 test-src/gen/literals.py [n] > literals.txt
+#then: time bin/release/build --threads 1 literals.txt, against more threads
+import random
+import sys
+
+random.seed(0)
+size = (int(sys.argv[1]) if len(sys.argv) > 1 else 9) * 1024 * 1024
+
+def words(i):
+	return " ".join(random.choice(["text", "\\\"quoted\\\"", "it's", "// not a comment", "\\\\", str(i)]) for _ in range(random.randint(1, 8)))
+
+lines = ["main() : {"]
+length = 0
+i = 0
+while length < size:
+	kind = random.randrange(3)
+	if kind == 0:
+		line = "\tprint(\"%s\\n\");" % words(i)
+	elif kind == 1:
+		#ends with an escaped backslash right before the closing quote
+		line = "\tprint(\"%s \\\\\");" % words(i)
+	else:
+		line = "\tprint(\"%s\");" % "\n".join(words(i) for _ in range(random.randint(2, 30)))
+	lines.append(line)
+	length += len(line) + 1
+	i += 1
+lines.append("}")
+sys.stdout.write("\n".join(lines) + "\n")
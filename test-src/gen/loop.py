@@ -0,0 +1,14 @@
+#a counted loop, block arguments carry the sum and the counter around the back edge
+#usage: python3 test-src/gen/loop.py > loop.xpb, the program exits with 55
+from xpb import *
+
+#f(n) adds n, n - 1 ... 1 until the counter reaches zero
+f = function(0, [I64], [I64], [
+	block([jump(1, [const(0), 1])], [1], first=True),
+	block([arithmetic("+", 4, 2, 3), arithmetic("-", 5, 3, const(1)), branch(5, (1, [4, 5]), (2, [4]))], [2, 3]),
+	block([ret(6)], [6]),
+])
+
+main = function(1, [I64], [], [block([call(0, [1], [const(10)]), ret(1)], first=True)])
+
+write([f, main], {0: "f", 1: "main"})
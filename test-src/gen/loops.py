@@ -0,0 +1,106 @@
+#random counted loops that recompute values of their first block, checked against a model of the loop
+#value numbering replaces the recomputed values with the ones from the first block, and the accumulator sometimes passes through a call
+#usage: python3 test-src/gen/loops.py <seed> <count> > loops.xpb
+#the program exits with how many results were wrong, up to 255
+import random
+import sys
+from xpb import *
+
+random.seed(int(sys.argv[1]))
+count = int(sys.argv[2])
+HELPER = count
+MAIN = count + 1
+
+def wrap(value):
+	value &= (1 << 64) - 1
+	return value - (1 << 64) if value >= 1 << 63 else value
+
+def apply(op, a, b):
+	return wrap(a + b if op == "+" else a - b if op == "-" else a * b)
+
+#h(x) = x * 3 + 1, called from inside some of the loops
+def helper(value):
+	return wrap(value * 3 + 1)
+
+#returns the function and what it gives for the input
+def loop(ID, n):
+	nextID = [2]
+	def newID():
+		nextID[0] += 1
+		return nextID[0] - 1
+
+	#the first block computes some values from n, then enters the loop with the counter and a zero accumulator
+	values = {1: n}
+	expressions = {}
+	first = []
+	for _ in range(random.randint(3, 30)):
+		lhs = random.choice(list(values))
+		rhs = random.choice(list(values) + [const(random.randint(1, 9))])
+		op = random.choice("+-*")
+		result = newID()
+		first.append(arithmetic(op, result, lhs, rhs))
+		expressions[result] = (op, lhs, rhs)
+		values[result] = apply(op, values[lhs], rhs[1] if isinstance(rhs, tuple) else values[rhs])
+	trips = random.randint(1, 6)
+	counter, accumulator = newID(), newID()
+	first.append(jump(1, [const(trips), const(0)]))
+
+	#the body recomputes some of them, adding each times the counter to the accumulator
+	body = []
+	steps = []
+	current = accumulator
+	for _ in range(random.randint(1, 8)):
+		recomputed = random.choice(list(expressions))
+		op, lhs, rhs = expressions[recomputed]
+		result, product, sum = newID(), newID(), newID()
+		body += [arithmetic(op, result, lhs, rhs), arithmetic("*", product, result, counter), arithmetic("+", sum, current, product)]
+		current = sum
+		steps.append(recomputed)
+		if random.random() < 0.3:
+			called = newID()
+			body.append(call(HELPER, [called], [current]))
+			current = called
+			steps.append(None)
+	decremented, exitValue = newID(), newID()
+	body += [arithmetic("-", decremented, counter, const(1)), branch(decremented, (1, [decremented, current]), (2, [current]))]
+
+	#the last block subtracts a few of the first values, so they stay live across the loop
+	last = []
+	output = exitValue
+	subtracted = random.sample(list(values), min(len(values), 5))
+	for value in subtracted:
+		result = newID()
+		last.append(arithmetic("-", result, output, value))
+		output = result
+	last.append(ret(output))
+
+	expected = 0
+	for i in range(trips, 0, -1):
+		for step in steps:
+			expected = helper(expected) if step is None else wrap(expected + values[step] * i)
+	for value in subtracted:
+		expected = wrap(expected - values[value])
+	return function(ID, [I64], [I64], [block(first, [1], first=True), block(body, [counter, accumulator]), block(last, [exitValue])]), expected
+
+functions = []
+checks = []
+for ID in range(count):
+	n = random.randint(-20, 20)
+	definition, expected = loop(ID, n)
+	functions.append(definition)
+	checks.append((ID, n, expected))
+functions.append(function(HELPER, [I64], [I64], [block([arithmetic("*", 2, 1, const(3)), arithmetic("+", 3, 2, const(1)), ret(3)], [1], first=True)]))
+
+#main calls each loop in its own block, a wrong result passes the block after an incremented count
+blocks = [block([jump(1, [const(0)])], first=True)]
+for index, (ID, n, expected) in enumerate(checks):
+	wrong, result, difference, incremented = [4 * index + i + 1 for i in range(4)]
+	blocks.append(block([call(ID, [result], [const(n)]), arithmetic("-", difference, result, const(expected)),
+		arithmetic("+", incremented, wrong, const(1)), branch(difference, (index + 2, [incremented]), (index + 2, [wrong]))], [wrong]))
+blocks.append(block([ret(4 * count + 1)], [4 * count + 1]))
+functions.append(function(MAIN, [I64], [], blocks))
+
+names = {ID: "loop%d" % ID for ID in range(count)}
+names[HELPER] = "h"
+names[MAIN] = "main"
+write(functions, names)
@@ -0,0 +1,102 @@
+#arithmetic and division on every integer width, checked against a model of the wrapping semantics
+#narrow values are computed in 64 bit registers, so every result has to be wrapped back to its type
+#usage: python3 test-src/gen/narrow.py [part] > narrow.txt, the program exits with how many results were wrong
+import random
+import sys
+
+part = int(sys.argv[1]) if len(sys.argv) > 1 else 0
+random.seed(part)
+
+TYPES = [("i8", True, 8), ("i16", True, 16), ("i32", True, 32), ("i64", True, 64),
+	("u8", False, 8), ("u16", False, 16), ("u32", False, 32), ("u64", False, 64)]
+
+def wrap(value, signed, bits):
+	value &= (1 << bits) - 1
+	if signed and value >= 1 << (bits - 1):
+		value -= 1 << bits
+	return value
+
+def divide(a, b):
+	quotient = abs(a) // abs(b)
+	return quotient if (a < 0) == (b < 0) else -quotient
+
+#literals are written as 0 - n for negative values, the parser folds them back into a constant
+def literal(value):
+	return str(value) if value >= 0 else "(0 - %d)" % -value
+
+def operand(signed, bits):
+	low = -(1 << (bits - 1)) if signed else 0
+	high = (1 << (bits - 1)) - 1 if signed else (1 << bits) - 1
+	choice = random.random()
+	if choice < 0.3:
+		return random.choice([low, high, low + 1, high - 1, 0, 1, -1 if signed else 2])
+	if choice < 0.6:
+		return random.randint(max(low, -300), min(high, 300))
+	return random.randint(low, high)
+
+def divisor(signed, bits):
+	while True:
+		choice = random.random()
+		if choice < 0.4:
+			value = 1 << random.randint(0, bits - 2)
+		elif choice < 0.8:
+			value = random.randint(1, 1000)
+		else:
+			value = random.randint(1, (1 << (bits - 1)) - 1)
+		if signed and random.random() < 0.4:
+			value = -value
+		value = wrap(value, signed, bits)
+		if value != 0:
+			return value
+
+functions = []
+calls = []
+for index in range(240):
+	name, signed, bits = random.choice(TYPES)
+	a = operand(signed, bits)
+	b = operand(signed, bits)
+	op = random.choice("+-*/")
+	constantDivisor = divisor(signed, bits)
+
+	#the minimum divided by -1 overflows in 64 bits, which traps
+	if op == "/" and (b == 0 or (bits == 64 and signed and b == -1 and a == -(1 << 63))):
+		op = "+"
+	if op == "+":
+		combined = wrap(a + b, signed, bits)
+	elif op == "-":
+		combined = wrap(a - b, signed, bits)
+	elif op == "*":
+		combined = wrap(a * b, signed, bits)
+	else:
+		combined = wrap(divide(a, b), signed, bits)
+	if bits == 64 and signed and constantDivisor == -1 and combined == -(1 << 63):
+		constantDivisor = 3
+
+	#both the combined value and its division by a constant are returned through the sum
+	expected = wrap(combined + wrap(divide(combined, constantDivisor), signed, bits), signed, bits)
+	functions.append("test%d(a : %s, b : %s) : %s {\n\tc : %s = a %s b;\n\treturn c + c / %s;\n}\n"
+		% (index, name, name, name, name, op, literal(constantDivisor)))
+	calls.append("\tv = test%d(%s, %s);\n\twrong = wrong + isNotZero(v - %d);\n" % (index, literal(a), literal(b), expected % (1 << 64)))
+
+#subtracting a constant becomes adding its negation when that fits in 32 bits, the minimum is its own negation so never fits
+for name, signed, bits in TYPES:
+	low = -(1 << (bits - 1)) if signed else 0
+	high = (1 << (bits - 1)) - 1 if signed else (1 << bits) - 1
+	for index, constant in enumerate(sorted({wrap(c, signed, bits) for c in [low, low + 1, high, -(1 << 31), 1 << 31, -(1 << 31) + 1, 1]})):
+		a = operand(signed, bits)
+		expected = wrap(a - constant, signed, bits)
+		functions.append("subtract_%s_%d(a : %s) : %s {\n\treturn a - %s;\n}\n" % (name, index, name, name, literal(constant)))
+		calls.append("\tv = subtract_%s_%d(%s);\n\twrong = wrong + isNotZero(v - %d);\n" % (name, index, literal(a), expected % (1 << 64)))
+
+sys.stdout.write("".join(functions))
+sys.stdout.write("""isNotZero(x : u64) : u64 {
+	half : u64 = x / 2;
+	return (half + (x - half * 2) + 0x7FFFFFFFFFFFFFFF) / 0x8000000000000000;
+}
+
+main() : i64 {
+	wrong : u64 = 0;
+	v : u64 = 0;
+""")
+sys.stdout.write("".join(calls))
+sys.stdout.write("\treturn wrong;\n}\n")
@@ -0,0 +1,90 @@
+#random loops passing up to 18 block arguments back permuted, some replaced by constants or incremented, checked against a model of the loop
+#the permutations make cycles in the copies at the back edge, through registers and once there are enough arguments through frame slots
+#usage: python3 test-src/gen/permutations.py <seed> <count> > permutations.xpb
+#the program exits with how many results were wrong, up to 255
+import random
+import sys
+from xpb import *
+
+random.seed(int(sys.argv[1]))
+count = int(sys.argv[2])
+MAIN = count
+
+def wrap(value):
+	value &= (1 << 64) - 1
+	return value - (1 << 64) if value >= 1 << 63 else value
+
+#returns the function and what it gives
+def permutation(ID):
+	size = random.randint(2, 18)
+	trips = random.randint(1, 5)
+	initial = [random.randint(-50, 50) for _ in range(size)]
+	nextID = [1]
+	def newID():
+		nextID[0] += 1
+		return nextID[0] - 1
+	arguments = [newID() for _ in range(size)]
+	counter = newID()
+
+	#each argument is passed on as another one, or replaced by a constant or the other one plus a constant
+	body = []
+	passed = []
+	steps = []
+	order = list(range(size))
+	random.shuffle(order)
+	for source in order:
+		kind = random.random()
+		if kind < 0.6:
+			passed.append(arguments[source])
+			steps.append(lambda values, source=source: values[source])
+		elif kind < 0.75:
+			constant = random.randint(-9, 9)
+			passed.append(const(constant))
+			steps.append(lambda values, constant=constant: constant)
+		else:
+			constant = random.randint(1, 9)
+			result = newID()
+			body.append(arithmetic("+", result, arguments[source], const(constant)))
+			passed.append(result)
+			steps.append(lambda values, source=source, constant=constant: wrap(values[source] + constant))
+	decremented = newID()
+	body += [arithmetic("-", decremented, counter, const(1)), branch(decremented, (1, passed + [decremented]), (2, passed))]
+
+	#the last block combines every argument, so none of them can be left out
+	results = [newID() for _ in range(size)]
+	last = []
+	combined = results[0]
+	for value in results[1:]:
+		product, sum = newID(), newID()
+		last += [arithmetic("*", product, combined, const(3)), arithmetic("+", sum, product, value)]
+		combined = sum
+	last.append(ret(combined))
+
+	values = initial
+	for _ in range(trips):
+		values = [step(values) for step in steps]
+	expected = values[0]
+	for value in values[1:]:
+		expected = wrap(expected * 3 + value)
+	return function(ID, [I64], [], [block([jump(1, [const(value) for value in initial] + [const(trips)])], first=True),
+		block(body, arguments + [counter]), block(last, results)]), expected
+
+functions = []
+checks = []
+for ID in range(count):
+	definition, expected = permutation(ID)
+	functions.append(definition)
+	checks.append((ID, expected))
+
+#main calls each loop in its own block, a wrong result passes the block after an incremented count
+blocks = [block([jump(1, [const(0)])], first=True)]
+for index, (ID, expected) in enumerate(checks):
+	wrong, result, difference, incremented = [4 * index + i + 1 for i in range(4)]
+	blocks.append(block([call(ID, [result], []), arithmetic("-", difference, result, const(expected)),
+		arithmetic("+", incremented, wrong, const(1)), branch(difference, (index + 2, [incremented]), (index + 2, [wrong]))], [wrong]))
+blocks.append(block([ret(4 * count + 1)], [4 * count + 1]))
+functions.append(function(MAIN, [I64], [], blocks))
+
+names = {ID: "permutation%d" % ID for ID in range(count)}
+names[MAIN] = "main"
+write(functions, names)
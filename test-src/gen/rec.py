@@ -0,0 +1,32 @@
+#recursion that isnt in tail position, a function calling itself twice and two functions calling each other
+#usage: python3 test-src/gen/rec.py > rec.xpb, the program exits with 90
+from xpb import *
+
+#fib(n), 0 for n = 0, 1 for n = 1, otherwise fib(n - 1) + fib(n - 2)
+fib = function(0, [I64], [I64], [
+	block([branch(1, (1, []), (3, []))], first=True),
+	block([arithmetic("-", 2, 1, const(1)), branch(2, (2, []), (4, []))]),
+	block([arithmetic("-", 3, 1, const(2)), call(0, [4], [2]), call(0, [5], [3]), arithmetic("+", 6, 4, 5), ret(6)]),
+	block([ret(const(0))]),
+	block([ret(const(1))]),
+])
+
+#even(n) and odd(n), each counting n down through the other
+even = function(1, [I64], [I64], [
+	block([branch(1, (1, []), (2, []))], first=True),
+	block([arithmetic("-", 2, 1, const(1)), call(2, [3], [2]), ret(3)]),
+	block([ret(const(1))]),
+])
+odd = function(2, [I64], [I64], [
+	block([branch(1, (1, []), (2, []))], first=True),
+	block([arithmetic("-", 2, 1, const(1)), call(1, [3], [2]), ret(3)]),
+	block([ret(const(0))]),
+])
+
+#((even(7) * 10 + odd(7)) * 100000 + fib(20)) modulo 251
+main = function(3, [I64], [], [block([
+	call(0, [1], [const(20)]), call(1, [2], [const(7)]), call(2, [3], [const(7)]),
+	arithmetic("*", 4, 2, const(10)), arithmetic("+", 5, 4, 3), arithmetic("*", 6, 5, const(100000)),
+	arithmetic("+", 7, 6, 1), arithmetic("%", 8, 7, const(251)), ret(8)], first=True)])
+
+write([fib, even, odd, main], {0: "fib", 1: "even", 2: "odd", 3: "main"})
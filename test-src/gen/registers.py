@@ -0,0 +1,45 @@
+#main() keeps n values from calls live across every later call so most are spilled, then returns value k through a chain of calls
+#rotate() has shuffled inputs with one of them unused, so the prologue has to move them to their own locations
+#usage: python3 test-src/gen/registers.py n k > registers.txt
+#value i is 256 * i + i + 1 and the result is moved into a u8, so the program exits with k + 1
+import sys
+
+count = int(sys.argv[1])
+chosen = int(sys.argv[2])
+
+lines = [
+	"id(x : i64) : i64 {",
+	"\treturn x;",
+	"}",
+	"",
+	"second(a : i64, b : i64) : i64 {",
+	"\treturn b;",
+	"}",
+	"",
+	"rotate(a : i64, b : i64, c : i64) : i64 {",
+	"\tx : i64 = id(b);",
+	"\treturn second(x, a);",
+	"}",
+	"",
+	"main() : u8 {",
+]
+for i in range(count):
+	lines.append("\tv%d : i64 = id(%d);" % (i, 256 * i + i + 1))
+lines.append("\tr : i64 = 0;")
+
+#values are used from both ends inwards, so their intervals end in a different order than they start
+order = []
+for i in range(count // 2):
+	order += [i, count - 1 - i]
+if count % 2 == 1:
+	order.append(count // 2)
+for i in order:
+	other = "v%d" % order[-1]
+	if i == chosen:
+		lines.append("\tr = rotate(v%d, r, %s);" % (i, other))
+	else:
+		lines.append("\tr = rotate(r, v%d, %s);" % (i, other))
+lines.append("\tresult : u8 = r;")
+lines.append("\treturn result;")
+lines.append("}")
+sys.stdout.write("\n".join(lines) + "\n")
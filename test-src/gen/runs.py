@@ -0,0 +1,24 @@
+#identifier, digit and whitespace runs of every length up to n, for checking the vector character scanners against the scalar one
+#a run can start anywhere in a vector and end in the next one, so each length is tried at every alignment the previous runs leave
+#usage: python3 test-src/gen/runs.py [n] > runs.txt, the program exits with the sum of the values modulo 256, 112 for the default 80
+import sys
+
+count = int(sys.argv[1]) if len(sys.argv) > 1 else 80
+IDENTIFIER = "abcXYZ_0123456789"
+WHITESPACE = " \t\n"
+
+def whitespace(length):
+	return "".join(WHITESPACE[i % len(WHITESPACE)] for i in range(length))
+
+parts = ["main() : i64 {"]
+names = []
+for length in range(1, count + 1):
+	name = "v" + "".join(IDENTIFIER[(length + i) % len(IDENTIFIER)] for i in range(length - 1))
+	value = length * 7919 % 1000
+	#leading zeros pad the literal to the run length
+	digits = str(value).rjust(length, "0")
+	parts.append(whitespace(length) + name + whitespace(length) + ":" + whitespace(length) + "i64" + whitespace(length)
+		+ "=" + whitespace(length) + digits + whitespace(length) + ";")
+	names.append(name)
+parts.append("\treturn " + " + ".join(names) + ";\n}")
+sys.stdout.write("".join(parts) + "\n")
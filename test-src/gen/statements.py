@@ -0,0 +1,14 @@
+#main() with n alternating print and declare statements, for timing bytecode emission on large programs
+#usage: python3 test-src/gen/statements.py [n] > statements.txt
+#then: time bin/release/build statements.txt
+#the program prints n / 2 lines
+import sys
+
+count = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+
+lines = ["main() : {"]
+for i in range(count // 2):
+	lines.append("\tprint(\"statement\\n\");")
+	lines.append("\tx%d : i64;" % i)
+lines.append("}")
+sys.stdout.write("\n".join(lines) + "\n")
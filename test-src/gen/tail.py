@@ -0,0 +1,46 @@
+#calls in tail position, to the function itself and between two functions
+#usage: python3 test-src/gen/tail.py [narrow] > tail.xpb, the program exits with 86, or 13 for narrow
+#ten million calls deep, so it only runs once the self call is a loop and the others are tail calls
+import sys
+from xpb import *
+
+#f(n, acc), acc for n = 0, otherwise f(n - 1, acc + n)
+f = function(0, [I64], [I64, I64], [
+	block([branch(1, (1, []), (2, []))], first=True),
+	block([arithmetic("-", 3, 1, const(1)), arithmetic("+", 4, 2, 1), call(0, [5], [3, 4]), ret(5)]),
+	block([ret(2)]),
+])
+
+#even(n, acc) and odd(acc, n), passing the arguments over in the other order
+even = function(1, [I64], [I64, I64], [
+	block([branch(1, (1, []), (2, []))], first=True),
+	block([arithmetic("-", 3, 1, const(1)), arithmetic("+", 4, 2, const(3)), call(2, [5], [4, 3]), ret(5)]),
+	block([arithmetic("%", 6, 2, const(1000)), ret(6)]),
+])
+odd = function(2, [I64], [I64, I64], [
+	block([branch(2, (1, []), (2, []))], first=True),
+	block([arithmetic("-", 3, 2, const(1)), call(1, [4], [3, 1]), ret(4)]),
+	block([ret(const(7))]),
+])
+
+#f(10000000, 0) modulo 251 + even(5000001, 0)
+main = function(3, [I64], [], [block([
+	call(0, [1], [const(10000000), const(0)]), call(1, [2], [const(5000001), const(0)]),
+	arithmetic("%", 3, 1, const(251)), arithmetic("+", 4, 3, 2), ret(4)], first=True)])
+functions = [f, even, odd, main]
+names = ["f", "even", "odd", "main"]
+
+#g(n, acc : u8) passes acc + 200 on as an i64, so the loop has to wrap it to u8 on every trip
+#g(10, 0) is 2000 modulo 256 = 208 divided by 16, 125 if acc isnt wrapped
+if len(sys.argv) > 1 and sys.argv[1] == "narrow":
+	g = function(0, [I64], [I64, U8], [
+		block([branch(1, (1, []), (2, []))], first=True),
+		block([arithmetic("-", 3, 1, const(1)), declare(4), move(4, 2), arithmetic("+", 5, 4, const(200)), call(0, [6], [3, 5]), ret(6)]),
+		block([declare(7), move(7, 2), arithmetic("/", 8, 7, const(16)), ret(8)]),
+	])
+	main = function(1, [I64], [], [block([call(0, [1], [const(10), const(0, U8)]), ret(1)], first=True)])
+	functions = [g, main]
+	names = ["g", "main"]
+
+#function IDs have no gaps, so each is its position in the list
+write(functions, dict(enumerate(names)))
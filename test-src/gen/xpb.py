@@ -0,0 +1,87 @@
+#writes bytecode by hand, for test programs the front end cant produce yet (loops, branches, tail calls)
+#the layout follows IR_spec.md, every value is little endian
+#fixture scripts build functions from the helpers below and hand them to write()
+import struct
+import sys
+
+I8 = (1, 3)
+I16 = (1, 4)
+I32 = (1, 5)
+I64 = (1, 6)
+U8 = (2, 3)
+U16 = (2, 4)
+U32 = (2, 5)
+U64 = (2, 6)
+
+VERSION = (0, 2, 0)
+FLAG_FUNCTION_INDEX = 1
+
+def u8(value): return struct.pack("<B", value & 0xFF)
+def u32(value): return struct.pack("<I", value & 0xFFFFFFFF)
+def u64(value): return struct.pack("<Q", value & 0xFFFFFFFFFFFFFFFF)
+def valueType(t): return struct.pack("<bB", t[0], t[1])
+
+#a source is a variable ID, or const(value, type) for a constant
+def const(value, t=I64): return ("const", value, t)
+
+def source(s):
+	if isinstance(s, tuple):
+		_, value, t = s
+		return u32(0) + valueType(t) + struct.pack("<Q", value & 0xFFFFFFFFFFFFFFFF)[:1 << (t[1] - 3)]
+	return u32(s)
+
+def declare(variable, t=I64): return u32(-1) + valueType(t) + u32(variable)
+def move(destination, s): return u32(-2) + u32(destination) + source(s)
+
+ARITHMETIC = {"+": -128, "-": -129, "*": -130, "/": -131, "%": -132}
+def arithmetic(op, result, lhs, rhs): return u32(ARITHMETIC[op]) + u32(result) + source(lhs) + source(rhs)
+
+def ret(*sources): return u32(-64) + b"".join(source(s) for s in sources)
+
+#a target is (block, [arguments])
+def target(block, arguments): return u64(block) + u32(len(arguments)) + b"".join(source(s) for s in arguments)
+def jump(block, arguments=()): return u32(-65) + target(block, arguments)
+def branch(condition, taken, otherwise): return u32(-66) + source(condition) + target(*taken) + target(*otherwise)
+
+def call(ID, outputs, inputs):
+	return u32(ID) + u32(len(outputs)) + u32(len(inputs)) + b"".join(u32(o) for o in outputs) + b"".join(source(s) for s in inputs)
+
+#the first block takes the function inputs, so only later blocks give argument IDs
+#arguments are (ID, type) pairs, or bare IDs for i64
+def block(instructions, arguments=(), first=False):
+	arguments = [a if isinstance(a, tuple) else (a, I64) for a in arguments]
+	header = u64(len(instructions)) + u32(len(arguments)) + b"".join(valueType(t) for _, t in arguments)
+	if not first:
+		header += b"".join(u32(ID) for ID, _ in arguments)
+	return header + b"".join(instructions)
+
+#outputs and inputs are lists of types
+def function(ID, outputs, inputs, blocks):
+	return (ID, u32(ID) + u64(len(blocks)) + u32(len(outputs)) + u32(len(inputs))
+		+ b"".join(valueType(t) for t in outputs + inputs) + b"".join(blocks))
+
+#names maps function IDs to their identifiers, main must be one of them
+def program(functions, names, index=False, version=VERSION):
+	functionTable = u32(len(names)) + b"".join(u32(ID) + u64(len(name)) + name.encode() for ID, name in names.items())
+	staticVariables = u32(0)
+
+	logic = b""
+	entries = b""
+	for ID, definition in functions:
+		entries += struct.pack("<IQQ", ID, len(logic), len(definition))
+		logic += definition
+	functionIndex = u32(len(functions)) + entries if index else b""
+
+	headerLength = 56
+	functionTableOffset = headerLength
+	staticOffset = functionTableOffset + len(functionTable)
+	indexOffset = staticOffset + len(staticVariables)
+	logicOffset = indexOffset + len(functionIndex)
+	header = bytes([0x78, 0x70, 0x62, 0xC0]) + b"".join(u32(v) for v in version)
+	header += u64(FLAG_FUNCTION_INDEX if index else 0)
+	header += u64(functionTableOffset) + u64(staticOffset) + u64(indexOffset if index else 0) + u64(logicOffset)
+	return header + functionTable + staticVariables + functionIndex + logic
+
+#fixture scripts write their bytecode to stdout
+def write(functions, names, index=False, version=VERSION):
+	sys.stdout.buffer.write(program(functions, names, index, version))
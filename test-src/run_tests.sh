@@ -0,0 +1,303 @@
+#!/bin/bash
+#compiles each test program and checks the exit code of running it, or what it compiles to
+#usage: test-src/run_tests.sh [compiler], the debug build by default
+#generated programs are written to a temporary directory along with every output
+
+TEST_DIRECTORY=$(cd "$(dirname "$0")" && pwd)
+COMPILER=$(realpath "${1:-$TEST_DIRECTORY/../bin/debug/build}")
+WORK_DIRECTORY=$(mktemp -d)
+trap 'rm -rf "$WORK_DIRECTORY"' EXIT
+
+passed=0
+failed=0
+
+fail() {
+	printf "FAIL %s: %s\n" "$1" "$2"
+	failed=$((failed + 1))
+}
+
+#compile <name> <source> [compiler options...], outputs are named after the test and the compiler output kept in <name>.log
+compile() {
+	local name=$1 source=$2
+	shift 2
+	if ! "$COMPILER" "$@" -o "$WORK_DIRECTORY/$name" "$source" > /dev/null 2> "$WORK_DIRECTORY/$name.log"; then
+		fail "$name" "did not compile"
+		sed 's/^/    /' "$WORK_DIRECTORY/$name.log" | grep -v "Parser exited via EOF"
+		return 1
+	fi
+}
+
+#check <name> <source> <expected exit code> [compiler options...]
+#what the program prints is kept in <name>.stdout
+check() {
+	local name=$1 source=$2 expected=$3
+	shift 3
+	compile "$name" "$source" "$@" || return 1
+	"$WORK_DIRECTORY/$name.out" > "$WORK_DIRECTORY/$name.stdout"
+	local status=$?
+	if [ "$status" != "$expected" ]; then
+		fail "$name" "exited with $status, expected $expected"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_error <name> <source> <expected message> [compiler options...]
+#the program must fail to compile, with the message somewhere in its output
+check_error() {
+	local name=$1 source=$2 message=$3
+	shift 3
+	if "$COMPILER" "$@" -o "$WORK_DIRECTORY/$name" "$source" > /dev/null 2> "$WORK_DIRECTORY/$name.log"; then
+		fail "$name" "compiled, expected \"$message\""
+		return 1
+	fi
+	if ! grep -qF "$message" "$WORK_DIRECTORY/$name.log"; then
+		fail "$name" "failed without \"$message\""
+		sed 's/^/    /' "$WORK_DIRECTORY/$name.log"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_lines <name> <expected line count>, after check <name>
+check_lines() {
+	local name=$1 expected=$2
+	local count
+	count=$(wc -l < "$WORK_DIRECTORY/$name.stdout")
+	if [ "$count" != "$expected" ]; then
+		fail "$name" "printed $count lines, expected $expected"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_object <name> <source> <expected exit code> [compiler options...]
+#the program is compiled to an object, linked with ld and run
+check_object() {
+	local name=$1 source=$2 expected=$3
+	shift 3
+	compile "$name" "$source" --emit-object "$@" || return 1
+	if ! ld -o "$WORK_DIRECTORY/$name.linked" "$WORK_DIRECTORY/$name.o" > "$WORK_DIRECTORY/$name.ld.log" 2>&1; then
+		fail "$name" "object did not link"
+		sed 's/^/    /' "$WORK_DIRECTORY/$name.ld.log"
+		return 1
+	fi
+	"$WORK_DIRECTORY/$name.linked" > /dev/null
+	local status=$?
+	if [ "$status" != "$expected" ]; then
+		fail "$name" "linked object exited with $status, expected $expected"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_asm <name> <source> <pattern> <expected count> [compiler options...]
+#the assembly must have as many lines matching the pattern as expected
+check_asm() {
+	local name=$1 source=$2 pattern=$3 expected=$4
+	shift 4
+	compile "$name" "$source" "$@" || return 1
+	local count
+	count=$(grep -c "$pattern" "$WORK_DIRECTORY/$name.xpb.asm")
+	if [ "$count" != "$expected" ]; then
+		fail "$name" "$count lines match \"$pattern\", expected $expected"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_nasm <name> <expected exit code>, after check_asm <name> with --emit-asm
+#assembles and links its assembly when nasm is installed, and checks the exit code of running that
+check_nasm() {
+	local name=$1 expected=$2
+	if ! command -v nasm > /dev/null; then
+		printf "SKIP %s: nasm is not installed\n" "$name"
+		return 0
+	fi
+	if ! nasm -f elf64 -o "$WORK_DIRECTORY/$name.nasm.o" "$WORK_DIRECTORY/$name.xpb.asm" > /dev/null 2>&1 \
+		|| ! ld -o "$WORK_DIRECTORY/$name.nasm.out" "$WORK_DIRECTORY/$name.nasm.o" > /dev/null 2>&1; then
+		fail "$name" "assembly did not assemble and link"
+		return 1
+	fi
+	"$WORK_DIRECTORY/$name.nasm.out" > /dev/null
+	local status=$?
+	if [ "$status" != "$expected" ]; then
+		fail "$name" "assembled program exited with $status, expected $expected"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_same <first> <second>, after check of both, the two executables must be byte for byte the same
+check_same() {
+	if ! cmp -s "$WORK_DIRECTORY/$1.out" "$WORK_DIRECTORY/$2.out"; then
+		fail "$2" "compiled differently to $1"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#check_report <name> <line>, after check <name>, looks for a line of its compiler output
+check_report() {
+	local name=$1 line=$2
+	if ! grep -qF "$line" "$WORK_DIRECTORY/$name.log"; then
+		fail "$name" "report is missing \"$line\""
+		sed 's/^/    /' "$WORK_DIRECTORY/$name.log"
+		return 1
+	fi
+	passed=$((passed + 1))
+}
+
+#generate <file> <script> [arguments...], writes a generated program into the work directory
+generate() {
+	local file=$1 script=$2
+	shift 2
+	python3 "$TEST_DIRECTORY/gen/$script" "$@" > "$WORK_DIRECTORY/$file"
+}
+
+check hello_world "$TEST_DIRECTORY/hello_world.txt" 0
+check_lines hello_world 1
+check_object hello_world_object "$TEST_DIRECTORY/hello_world.txt" 0
+check_asm hello_world_asm "$TEST_DIRECTORY/hello_world.txt" "; print" 1 --emit-asm
+check_nasm hello_world_asm 0
+
+#"-" streams the source from stdin through a sliding window, which has to compile the same as the mapped file
+check hello_world_stdin - 0 < "$TEST_DIRECTORY/hello_world.txt"
+check_same hello_world hello_world_stdin
+
+#the vector character scanners have to find the same runs as the scalar one, at every length and alignment
+generate runs.txt runs.py 80
+check runs_scalar "$WORK_DIRECTORY/runs.txt" 112 --char-scanner scalar
+for scanner in sse2 avx2; do
+	if ! "$COMPILER" --char-scanner $scanner -o "$WORK_DIRECTORY/scanner_$scanner" "$TEST_DIRECTORY/hello_world.txt" > /dev/null 2>&1; then
+		printf "SKIP runs_%s: the cpu doesnt support %s\n" $scanner $scanner
+		continue
+	fi
+	check runs_$scanner "$WORK_DIRECTORY/runs.txt" 112 --char-scanner $scanner && check_same runs_scalar runs_$scanner
+done
+
+#the bytecode emission benchmark
+generate statements.txt statements.py 100000
+check statements "$WORK_DIRECTORY/statements.txt" 0
+check_lines statements 50000
+check statements_stdin - 0 < "$WORK_DIRECTORY/statements.txt"
+check_same statements statements_stdin
+
+#output, input and type counts are bounded by the bytes left, so corrupt ones fail instead of allocating
+generate corrupt_call.xpb corrupt_counts.py call
+check_error corrupt_call "$WORK_DIRECTORY/corrupt_call.xpb" "Unexpected end of bytecode"
+generate corrupt_function.xpb corrupt_counts.py function
+check_error corrupt_function "$WORK_DIRECTORY/corrupt_function.xpb" "Unexpected end of bytecode"
+#function IDs are bounded by the function table, so tables indexed by ID stay as long as it
+generate corrupt_table.xpb corrupt_counts.py table
+check_error corrupt_table "$WORK_DIRECTORY/corrupt_table.xpb" "Function ID 2147483632 out of range"
+generate corrupt_spec.xpb corrupt_counts.py spec
+check_error corrupt_spec "$WORK_DIRECTORY/corrupt_spec.xpb" "Function ID 2147483648 out of range"
+generate corrupt_definition.xpb corrupt_counts.py definition
+check_error corrupt_definition "$WORK_DIRECTORY/corrupt_definition.xpb" "Definition of function 2147483632, which isnt in the function table"
+generate corrupt_index.xpb corrupt_counts.py index
+check_error corrupt_index "$WORK_DIRECTORY/corrupt_index.xpb" "Function index entry for function 2147483632, which isnt in the function table"
+
+#sources of 8 MiB or more are lexed in chunks when there is more than one thread, which has to give the same program as one thread
+generate literals.txt literals.py 9
+check literals_sequential "$WORK_DIRECTORY/literals.txt" 0 --threads 1
+check literals_chunked "$WORK_DIRECTORY/literals.txt" 0 --threads 4
+check_same literals_sequential literals_chunked
+
+#register allocation with most values spilled, each check returns a different one of them
+for chosen in 0 14 29; do
+	generate "registers_$chosen.txt" registers.py 30 "$chosen"
+	check "registers_$chosen" "$WORK_DIRECTORY/registers_$chosen.txt" $((chosen + 1))
+done
+check_object registers_object "$WORK_DIRECTORY/registers_14.txt" 15
+
+#narrow integers wrap to their type, the sweep exits with how many results were wrong
+check wrap_u8 "$TEST_DIRECTORY/wrap_u8.txt" 14
+check wrap_i32 "$TEST_DIRECTORY/wrap_i32.txt" 130
+for part in 0 1 2 3; do
+	generate narrow_$part.txt narrow.py $part
+	check narrow_$part "$WORK_DIRECTORY/narrow_$part.txt" 0
+done
+
+#arguments take the parameter types, calls before a definition have to match it
+check argument_conversion "$TEST_DIRECTORY/argument_conversion.txt" 116
+check forward_call "$TEST_DIRECTORY/forward_call.txt" 126
+check_error forward_call_mismatch "$TEST_DIRECTORY/forward_call_mismatch.txt" "define the function before calling it"
+
+#division by constants on every integer width, each exits with how many results were wrong
+for type in i8 i16 i32 i64 u8 u16 u32 u64; do
+	generate division_$type.txt division.py $type
+	check division_$type "$WORK_DIRECTORY/division_$type.txt" 0
+done
+
+#a million terms, flat and nested, without recursing in the parser
+for shape in long deep; do
+	generate expression_$shape.txt expression.py $shape
+	check expression_$shape "$WORK_DIRECTORY/expression_$shape.txt" 0
+done
+
+#inlined calls keep more values live than there are registers, the passes fold a constant function to its return
+check spill "$TEST_DIRECTORY/spill.txt" 16 --pass-report
+check_report spill "main: 333 -> 151 instructions, 60 calls inlined"
+check spill2 "$TEST_DIRECTORY/spill2.txt" 224
+check spill2_stdin - 224 < "$TEST_DIRECTORY/spill2.txt"
+check_same spill2 spill2_stdin
+generate fold.txt fold.py 20000
+check fold "$WORK_DIRECTORY/fold.txt" 14 --pass-report
+check_report fold "main: 40003 -> 1 instructions"
+
+#branches and loops are hand-written bytecode until the parser has if and while
+generate gvn.xpb gvn.py
+check gvn "$WORK_DIRECTORY/gvn.xpb" 129
+check gvn_not_inlined "$WORK_DIRECTORY/gvn.xpb" 129 --pass-report --inline-threshold 0
+check_report gvn_not_inlined "f: 15 -> 10 instructions"
+generate loop.xpb loop.py
+check loop "$WORK_DIRECTORY/loop.xpb" 55
+check loop_not_inlined "$WORK_DIRECTORY/loop.xpb" 55 --inline-threshold 0
+generate loops.xpb loops.py 1 350
+check loops "$WORK_DIRECTORY/loops.xpb" 0
+check loops_not_inlined "$WORK_DIRECTORY/loops.xpb" 0 --inline-threshold 0
+generate rec.xpb rec.py
+check rec "$WORK_DIRECTORY/rec.xpb" 90
+check rec_not_inlined "$WORK_DIRECTORY/rec.xpb" 90 --inline-threshold 0
+
+#tail calls, without inlining the self call is only kept from overflowing the stack by becoming a loop
+generate tail.xpb tail.py
+check tail "$WORK_DIRECTORY/tail.xpb" 86
+check tail_not_inlined "$WORK_DIRECTORY/tail.xpb" 86 --pass-report --inline-threshold 0
+check_report tail_not_inlined "f: 6 -> 5 instructions, 1 tail calls looped"
+check_object tail_object "$WORK_DIRECTORY/tail.xpb" 86 --inline-threshold 0
+generate tail_narrow.xpb tail.py narrow
+check tail_narrow "$WORK_DIRECTORY/tail_narrow.xpb" 13 --inline-threshold 0
+
+#block arguments rotated on every trip, the copies at the back edge are cycles through registers and frame slots
+generate cycles.xpb cycles.py
+check cycles "$WORK_DIRECTORY/cycles.xpb" 249
+check cycles_not_inlined "$WORK_DIRECTORY/cycles.xpb" 249 --inline-threshold 0
+generate permutations.xpb permutations.py 1 1100
+check permutations "$WORK_DIRECTORY/permutations.xpb" 0
+check permutations_not_inlined "$WORK_DIRECTORY/permutations.xpb" 0 --inline-threshold 0
+
+#only what main reaches is compiled, helpers inlined into it are removed afterwards
+generate helpers.txt helpers.py 3000
+check helpers "$WORK_DIRECTORY/helpers.txt" 94 --pass-report
+check_report helpers "h1234: removed, unreachable from main"
+check_report helpers "main: 6 -> 24 instructions, 3 calls inlined"
+check_object helpers_object "$WORK_DIRECTORY/helpers.txt" 94 --inline-threshold 0
+
+#the function index only changes how functions are found, a definition nothing calls isnt even decoded with it
+for mode in index no_index unused; do
+	generate $mode.xpb index.py $mode
+	check $mode "$WORK_DIRECTORY/$mode.xpb" 42
+done
+generate version_0_1.xpb index.py version_0_1
+check_error version_0_1 "$WORK_DIRECTORY/version_0_1.xpb" "Bytecode version 0.1 not supported"
+generate long_entry.xpb index.py long_entry
+check_error long_entry "$WORK_DIRECTORY/long_entry.xpb" "Function index entry for function 1 does not match its definition"
+generate short_entry.xpb index.py short_entry
+check_error short_entry "$WORK_DIRECTORY/short_entry.xpb" "Unexpected end of bytecode"
+generate bad_offset.xpb index.py bad_offset
+check_error bad_offset "$WORK_DIRECTORY/bad_offset.xpb" "Function index entry for function 1 out of bounds"
+
+printf "%d passed, %d failed\n" "$passed" "$failed"
+[ "$failed" = 0 ]